@@ -135,8 +135,13 @@ vk::Result CDLODRenderer::Render(const CDLODRendererBatchInfo& batchInfo, CDLODR
         perDrawData.data2 = {boundingBox.Min.x, boundingBox.Min.y, (boundingBox.Max.x - boundingBox.Min.x),
                              (boundingBox.Max.y - boundingBox.Min.y)};
 
-        batchInfo.renderData.cmd.pushConstants(batchInfo.renderData.pipelineLayout, batchInfo.renderData.pushConstantStages,
-                                               0, sizeof(CDLODRendererBatchInfo::PerDrawData), &perDrawData);
+        if (batchInfo.renderData.setPerDrawData) {  // CH
+            batchInfo.renderData.setPerDrawData(perDrawData);
+        } else {
+            batchInfo.renderData.cmd.pushConstants(batchInfo.renderData.pipelineLayout,
+                                                   batchInfo.renderData.pushConstantStages, 0,
+                                                   sizeof(CDLODRendererBatchInfo::PerDrawData), &perDrawData);
+        }
 
         int gridDim = gridMesh->GetDimensions();
 
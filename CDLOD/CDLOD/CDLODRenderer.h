@@ -8,6 +8,7 @@
 #ifndef _CDLOD_RENDERER_H_
 #define _CDLOD_RENDERER_H_
 
+#include <functional>
 #include <glm/glm.hpp>
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -45,11 +46,14 @@ struct CDLODRendererBatchInfo {
 
     // DxVertexShader* VertexShader;
     // DxPixelShader* PixelShader;
+    struct PerDrawData;
     struct RenderData {
         vk::CommandBuffer cmd;
         vk::PipelineLayout pipelineLayout;
         vk::ShaderStageFlags pushConstantStages;
         glm::vec4 dbgCamData;  // .x,.y,.z world position, .w use camera
+        // CH: Called with each draw's data instead of pushing it as constants if set.
+        std::function<void(const PerDrawData&)> setPerDrawData;
     } renderData;
 
     // D3DXHANDLE VSGridDimHandle;
@@ -77,11 +77,9 @@ vk::Result VkGridMesh::OnCreateDevice(LoadingResource& ldgRes) {
         for (int y = 0; y < vertDim; y++)
             for (int x = 0; x < vertDim; x++) vertices[x + vertDim * y] = {x / (float)(gridDim), y / (float)(gridDim)};
 
-        BufferResource stgRes = {};
         m_pContext->createBuffer(
-            ldgRes.transferCmd, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-            sizeof(VertexBufferType) * vertices.size(), name.c_str(), stgRes, m_vertexBuffer, vertices.data());
-        ldgRes.stgResources.push_back(std::move(stgRes));
+            ldgRes, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+            sizeof(VertexBufferType) * vertices.size(), name.c_str(), m_vertexBuffer, vertices.data());
     }
 
     {
@@ -145,11 +143,9 @@ vk::Result VkGridMesh::OnCreateDevice(LoadingResource& ldgRes) {
         }
         m_indexEndBR = index;
 
-        BufferResource stgRes = {};
         m_pContext->createBuffer(
-            ldgRes.transferCmd, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-            sizeof(IndexBufferType) * indices.size(), name.c_str(), stgRes, m_indexBuffer, indices.data());
-        ldgRes.stgResources.push_back(std::move(stgRes));
+            ldgRes, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+            sizeof(IndexBufferType) * indices.size(), name.c_str(), m_indexBuffer, indices.data());
     }
 
     return vk::Result::eSuccess;
@@ -27,6 +27,8 @@ Context::Context()
       debugMarkersEnabled(false),
       independentBlendEnabled(false),
       imageCubeArrayEnabled(false),
+      textureCompressionBCEnabled(false),
+      bindlessEnabled(false),
       instance{},
       physicalDev{},
       physicalDevIndex(0),
@@ -37,6 +39,7 @@ Context::Context()
       computeIndex(0),
       dev{},
       pAllocator(nullptr),
+      pMemAllocator(nullptr),
       surfaceProps{},
       surfaceFormat{},
       surface{},
@@ -114,6 +117,10 @@ void Context::initDevice() {
     deviceFeatures.fillModeNonSolid = wireframeShadingEnabled;
     deviceFeatures.independentBlend = independentBlendEnabled;
     deviceFeatures.imageCubeArray = imageCubeArrayEnabled;
+    deviceFeatures.textureCompressionBC = textureCompressionBCEnabled;
+    // Bindless shaders index the descriptor arrays with push constants.
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = bindlessEnabled;
+    deviceFeatures.shaderStorageBufferArrayDynamicIndexing = bindlessEnabled;
 
     // Phyiscal device extensions names
     auto &phyDevProps = physicalDevProps[physicalDevIndex];
@@ -128,8 +135,9 @@ void Context::initDevice() {
     devInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensionNames.size());
     devInfo.ppEnabledExtensionNames = enabledExtensionNames.data();
 
-    // Physical device extension featrues (For some reason using the name above doesn't always work)
-    // void **pNext = &(const_cast<void *>(devInfo.pNext));
+    // Physical device extension featrues (For some reason using the name above doesn't always work). Each one is linked
+    //  onto the end of the chain.
+    void **pNext = const_cast<void **>(&devInfo.pNext);
     if (vertexAttributeDivisorEnabled) {
         assert(false);  // Never tested. Was using the name above sufficient?
         // *pNext = &phyDevProps.featVertAttrDiv;
@@ -140,12 +148,27 @@ void Context::initDevice() {
         // *pNext = &phyDevProps.featTransFback;
         // pNext = &phyDevProps.featTransFback.pNext;
     }
+    // Only the descriptor indexing features the bindless descriptor set needs (see Shell::enumeratePhysicalDevices).
+    vk::PhysicalDeviceDescriptorIndexingFeaturesEXT descIndexingFeatures = {};
+    if (bindlessEnabled) {
+        descIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        descIndexingFeatures.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        descIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        descIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        descIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        descIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        descIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+        *pNext = &descIndexingFeatures;
+        pNext = &descIndexingFeatures.pNext;
+    }
 
     dev = physicalDev.createDevice(devInfo, pAllocator);
     assert(dev);
 
     VULKAN_HPP_DEFAULT_DISPATCHER.init(dev);
 
+    pMemAllocator = std::make_unique<Memory::Allocator>(dev, memProps, phyDevProps.properties.limits, pAllocator);
+
     // Moved asserts below from old Extensions.h. Not sure yet if there is a better place.
 
     if (debugMarkersEnabled) {
@@ -176,6 +199,8 @@ void Context::initDevice() {
 
 void Context::destroyDevice() {
     dev.waitIdle();
+    pMemAllocator->destroy();
+    pMemAllocator.reset();
     dev.destroy(pAllocator);
 }
 
@@ -209,21 +234,19 @@ void Context::createBuffer(const vk::CommandBuffer &cmd, const vk::BufferUsageFl
                            const std::string &&name, BufferResource &stgRes, BufferResource &buffRes, const void *data,
                            const bool mappable) const {
     assert(!stgRes.buffer);
-    assert(!stgRes.memory);
+    assert(!stgRes.allocation.memory);
     assert(!buffRes.buffer);
-    assert(!buffRes.memory);
+    assert(!buffRes.allocation.memory);
 
     // STAGING RESOURCE
     buffRes.memoryRequirements.size =
-        helpers::createBuffer(dev, size, vk::BufferUsageFlagBits::eTransferSrc,
-                              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, memProps,
-                              stgRes.buffer, stgRes.memory, pAllocator);
+        helpers::createBuffer(dev, *pMemAllocator, size, vk::BufferUsageFlagBits::eTransferSrc,
+                              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                              stgRes.buffer, stgRes.allocation, pAllocator, true);
 
     // FILL STAGING BUFFER ON DEVICE
-    void *pData;
-    pData = dev.mapMemory(stgRes.memory, 0, buffRes.memoryRequirements.size);
     /*
-        You can now simply memcpy the vertex data to the mapped memory and unmap it again using unmapMemory.
+        Staging memory is persistently mapped by the allocator, so you can simply memcpy the vertex data to it.
         Unfortunately the driver may not immediately copy the data into the buffer memory, for example because
         of caching. It is also possible that writes to the buffer are not visible in the mapped memory yet. There
         are two ways to deal with that problem:
@@ -234,22 +257,36 @@ void Context::createBuffer(const vk::CommandBuffer &cmd, const vk::BufferUsageFl
         allocated memory. Do keep in mind that this may lead to slightly worse performance than explicit flushing,
         but we'll see why that doesn't matter in the next chapter.
     */
-    memcpy(pData, data, static_cast<size_t>(size));
-    dev.unmapMemory(stgRes.memory);
+    assert(stgRes.allocation.pMappedData);
+    memcpy(stgRes.allocation.pMappedData, data, static_cast<size_t>(size));
 
     // FAST VERTEX BUFFER
     vk::MemoryPropertyFlags memPropFlags = vk::MemoryPropertyFlagBits::eDeviceLocal;
     if (mappable) memPropFlags |= vk::MemoryPropertyFlagBits::eHostVisible;
-    helpers::createBuffer(dev, size,
+    helpers::createBuffer(dev, *pMemAllocator, size,
                           // TODO: probably don't need to check memory requirements again
-                          usage, memPropFlags, memProps, buffRes.buffer, buffRes.memory, pAllocator);
+                          usage, memPropFlags, buffRes.buffer, buffRes.allocation, pAllocator);
 
     // COPY FROM STAGING TO FAST
     helpers::copyBuffer(cmd, stgRes.buffer, buffRes.buffer, buffRes.memoryRequirements.size);
     dbg_.setMarkerName(buffRes.buffer, name.c_str());
 }
 
+void Context::createBuffer(LoadingResource &ldgRes, const vk::BufferUsageFlags usage, const vk::DeviceSize size,
+                           const std::string &&name, BufferResource &buffRes, const void *data,
+                           const bool mappable) const {
+    BufferResource stgRes = {};
+    createBuffer(ldgRes.transferCmd, usage, size, std::forward<const std::string>(name), stgRes, buffRes, data,
+                 mappable);
+    if (ldgRes.shouldWait) {
+        assert(transferIndex != graphicsIndex);
+        helpers::transferBufferOwnership(ldgRes.transferCmd, ldgRes.graphicsCmd, buffRes.buffer, transferIndex,
+                                         graphicsIndex);
+    }
+    ldgRes.stgResources.push_back(std::move(stgRes));
+}
+
 void Context::destroyBuffer(BufferResource &res) const {
     if (res.buffer) dev.destroyBuffer(res.buffer, pAllocator);
-    if (res.memory) dev.freeMemory(res.memory, pAllocator);
+    pMemAllocator->free(res.allocation);
 }
@@ -7,11 +7,13 @@
 #define CONTEXT_H
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "Debug.h"
+#include "Memory.h"
 #include "Types.h"
 
 class Context {
@@ -55,6 +57,8 @@ class Context {
         // vk::PhysicalDeviceVertexAttributeDivisorPropertiesEXT propsVertAttrDiv;
         vk::PhysicalDeviceTransformFeedbackFeaturesEXT featTransFback;
         // vk::PhysicalDeviceTransformFeedbackPropertiesEXT propsTransFback;
+        vk::PhysicalDeviceDescriptorIndexingFeaturesEXT featDescIndexing;
+        vk::PhysicalDeviceDescriptorIndexingPropertiesEXT propsDescIndexing;
     };
 
     bool samplerAnisotropyEnabled;
@@ -69,6 +73,8 @@ class Context {
     bool debugMarkersEnabled;
     bool independentBlendEnabled;
     bool imageCubeArrayEnabled;
+    bool textureCompressionBCEnabled;
+    bool bindlessEnabled;
 
     std::vector<const char *> instanceEnabledLayerNames;
     std::vector<const char *> instanceEnabledExtensionNames;
@@ -86,6 +92,8 @@ class Context {
 
     vk::Device dev;
     vk::AllocationCallbacks *pAllocator;
+    // All device memory should come from here. Created in initDevice, and destroyed in destroyDevice.
+    std::unique_ptr<Memory::Allocator> pMemAllocator;
 
     // SURFACE (TODO: figure out what is what)
     SurfaceProperties surfaceProps;
@@ -119,6 +127,11 @@ class Context {
     void createBuffer(const vk::CommandBuffer &cmd, const vk::BufferUsageFlags usage, const vk::DeviceSize size,
                       const std::string &&name, BufferResource &stgRes, BufferResource &buffRes, const void *data,
                       const bool mappable = false) const;
+    // Same as above, but the copy is recorded on the loading resource's transfer command buffer, and ownership is
+    // transferred to the graphics queue family when they differ. The staging resource is added to "ldgRes".
+    void createBuffer(LoadingResource &ldgRes, const vk::BufferUsageFlags usage, const vk::DeviceSize size,
+                      const std::string &&name, BufferResource &buffRes, const void *data,
+                      const bool mappable = false) const;
     void destroyBuffer(BufferResource &res) const;
 
    private:
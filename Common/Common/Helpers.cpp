@@ -8,8 +8,17 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <cstdio>
 #include <regex>
+#include <sys/stat.h>
 #include <unordered_map>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace {
 const std::string MACRO_REPLACE_PREFIX = "MACRO_REPLACE_PREFIX";
@@ -53,6 +62,109 @@ void textReplaceFromMap(const std::map<std::string, std::string> &map, std::stri
     }
 }
 
+void hash(uint64_t &h, const void *pData, const size_t size) {
+    const auto *p = static_cast<const uint8_t *>(pData);
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+}
+
+std::string normalizePath(std::string path) {
+    std::replace(path.begin(), path.end(), '\\', '/');  // Convert windows path delimiters.
+    return path;
+}
+
+void hashFile(uint64_t &h, const std::string &path, const FILE_HASH what) {
+    auto normalized = normalizePath(path);
+    hash(h, normalized.data(), normalized.size());
+    switch (what) {
+        case FILE_HASH::PATH:
+            break;
+        case FILE_HASH::STAMP: {
+            struct stat st = {};
+            if (stat(normalized.c_str(), &st) == 0) {
+                int64_t size = static_cast<int64_t>(st.st_size), time = static_cast<int64_t>(st.st_mtime);
+                hash(h, &size, sizeof(size));
+                hash(h, &time, sizeof(time));
+            }
+        } break;
+        case FILE_HASH::CONTENTS: {
+            std::ifstream file(normalized, std::ios::binary);
+            char buffer[64 * 1024];
+            while (file) {
+                file.read(buffer, sizeof(buffer));
+                hash(h, buffer, static_cast<size_t>(file.gcount()));
+            }
+        } break;
+    }
+}
+
+bool writeFileAtomic(const std::string &path, const std::function<bool(std::ofstream &)> &write) {
+    std::stringstream ss;
+    ss << path << '.' << std::hex << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+    const auto tmpPath = ss.str();
+
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    bool written = write(file);
+    file.close();
+    if (!written || !file.good()) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // Windows won't rename over an existing file.
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string &path)
+    : pData_(nullptr), size_(0), hFile_(INVALID_HANDLE_VALUE), hMapping_(nullptr) {
+    hFile_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                         nullptr);
+    if (hFile_ == INVALID_HANDLE_VALUE) return;
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(hFile_, &size) || size.QuadPart == 0) return;
+    hMapping_ = CreateFileMappingA(hFile_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (hMapping_ == nullptr) return;
+    pData_ = static_cast<const uint8_t *>(MapViewOfFile(hMapping_, FILE_MAP_READ, 0, 0, 0));
+    if (pData_ != nullptr) size_ = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+    if (pData_ != nullptr) UnmapViewOfFile(pData_);
+    if (hMapping_ != nullptr) CloseHandle(hMapping_);
+    if (hFile_ != INVALID_HANDLE_VALUE) CloseHandle(hFile_);
+}
+#else
+MappedFile::MappedFile(const std::string &path) : pData_(nullptr), size_(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st = {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *pMap = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMap != MAP_FAILED) {
+            pData_ = static_cast<const uint8_t *>(pMap);
+            size_ = static_cast<size_t>(st.st_size);
+        }
+    }
+    // The mapping keeps the file open.
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (pData_ != nullptr) munmap(const_cast<uint8_t *>(pData_), size_);
+}
+#endif
+
 glm::mat4 moveAndRotateTo(const glm::vec3 eye, const glm::vec3 center, const glm::vec3 up) {
     auto const z(glm::normalize(center - eye));
     auto const x(glm::normalize(cross(z, up)));
@@ -136,9 +248,10 @@ bool getMemoryType(const vk::PhysicalDeviceMemoryProperties &memProps, uint32_t
     return false;
 }
 
-vk::DeviceSize createBuffer(const vk::Device &dev, const vk::DeviceSize &size, const vk::BufferUsageFlags &usage,
-                            const vk::MemoryPropertyFlags &props, const vk::PhysicalDeviceMemoryProperties &memProps,
-                            vk::Buffer &buff, vk::DeviceMemory &mem, const vk::AllocationCallbacks *pAllocator) {
+vk::DeviceSize createBuffer(const vk::Device &dev, Memory::Allocator &allocator, const vk::DeviceSize &size,
+                            const vk::BufferUsageFlags &usage, const vk::MemoryPropertyFlags &props, vk::Buffer &buff,
+                            Memory::Allocation &allocation, const vk::AllocationCallbacks *pAllocator,
+                            const bool transient) {
     vk::BufferCreateInfo buffInfo = {};
     buffInfo.size = size;
     buffInfo.usage = usage;
@@ -154,39 +267,20 @@ vk::DeviceSize createBuffer(const vk::Device &dev, const vk::DeviceSize &size, c
 
     vk::MemoryRequirements memReqs = dev.getBufferMemoryRequirements(buff);
 
-    vk::MemoryAllocateInfo allocInfo = {};
-    allocInfo.allocationSize = memReqs.size;
-    auto pass = getMemoryType(memProps, memReqs.memoryTypeBits, props, &allocInfo.memoryTypeIndex);
-    assert(pass && "No mappable, coherent memory");
-
     /*
-        It should be noted that in a real world application, you're not supposed to actually
-        call allocateMemory for every individual buffer. The maximum number of simultaneous
-        memory allocations is limited by the maxMemoryAllocationCount physical device limit,
-        which may be as low as 4096 even on high end hardware like an NVIDIA GTX 1080. The
-        right way to allocate memory for a large number of objects at the same time is to create
-        a custom allocator that splits up a single allocation among many different objects by
-        using the offset parameters that we've seen in many functions.
-
-        You can either implement such an allocator yourself, or use the VulkanMemoryAllocator
-        library provided by the GPUOpen initiative. However, for this tutorial it's okay to
-        use a separate allocation for every resource, because we won't come close to hitting
-        any of these limits for now.
-
-        The previous chapter already mentioned that you should allocate multiple resources like
-        buffers from a single memory allocation, but in fact you should go a step further.
-        Driver developers recommend that you also store multiple buffers, like the vertex and
-        index buffer, into a single vk::Buffer and use offsets in commands like
-        bindVertexBuffers. The advantage is that your data is more cache friendly in that
-        case, because it's closer together. It is even possible to reuse the same chunk of
-        memory for multiple resources if they are not used during the same render operations,
-        provided that their data is refreshed, of course. This is known as aliasing and some
-        Vulkan functions have explicit flags to specify that you want to do this.
+        The memory is sub-allocated from a block owned by the allocator instead of calling allocateMemory for every
+        individual buffer. The maximum number of simultaneous memory allocations is limited by the
+        maxMemoryAllocationCount physical device limit, which may be as low as 4096 even on high end hardware.
     */
-    mem = dev.allocateMemory(allocInfo, pAllocator);
+    Memory::CreateInfo allocInfo = {};
+    allocInfo.requirements = memReqs;
+    allocInfo.properties = props;
+    allocInfo.resourceType = Memory::RESOURCE::BUFFER;
+    allocInfo.transient = transient;
+    allocation = allocator.allocate(allocInfo);
 
     // BIND MEMORY
-    dev.bindBufferMemory(buff, mem, 0);
+    dev.bindBufferMemory(buff, allocation.memory, allocation.offset);
 
     return memReqs.size;
 }
@@ -200,29 +294,16 @@ void copyBuffer(const vk::CommandBuffer &cmd, const vk::Buffer &srcBuff, const v
     cmd.copyBuffer(srcBuff, dstBuff, {copyRegion});
 }
 
-void createImageMemory(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties &memProps,
-                       const vk::MemoryPropertyFlags &memPropFlags, vk::Image &image, vk::DeviceMemory &memory,
-                       const vk::AllocationCallbacks *pAllocator) {
-    vk::MemoryRequirements memReqs = dev.getImageMemoryRequirements(image);
-
-    vk::MemoryAllocateInfo allocInfo = {};
-    allocInfo.allocationSize = memReqs.size;
-
-    // Use the memory properties to determine the type of memory required
-    auto pass = getMemoryType(memProps, memReqs.memoryTypeBits, memPropFlags, &allocInfo.memoryTypeIndex);
-    assert(pass);
-
-    // Allocate memory
-    memory = dev.allocateMemory(allocInfo, pAllocator);
-    // Bind memory
-    dev.bindImageMemory(image, memory, 0);
+void createImageMemory(Memory::Allocator &allocator, const vk::MemoryPropertyFlags &memPropFlags, const vk::Image &image,
+                       Memory::Allocation &allocation, const vk::ImageTiling tiling) {
+    // Allocate, and bind memory
+    allocation = allocator.allocateImage(image, memPropFlags, tiling);
 }
 
-void createImage(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties &memProps,
-                 const std::vector<uint32_t> &queueFamilyIndices, const vk::SampleCountFlagBits &numSamples,
-                 const vk::Format &format, const vk::ImageTiling &tiling, const vk::ImageUsageFlags &usage,
-                 const vk::MemoryPropertyFlags &reqMask, uint32_t width, uint32_t height, uint32_t mipLevels,
-                 uint32_t arrayLayers, vk::Image &image, vk::DeviceMemory &memory,
+void createImage(const vk::Device &dev, Memory::Allocator &allocator, const std::vector<uint32_t> &queueFamilyIndices,
+                 const vk::SampleCountFlagBits &numSamples, const vk::Format &format, const vk::ImageTiling &tiling,
+                 const vk::ImageUsageFlags &usage, const vk::MemoryPropertyFlags &reqMask, uint32_t width, uint32_t height,
+                 uint32_t mipLevels, uint32_t arrayLayers, vk::Image &image, Memory::Allocation &allocation,
                  const vk::AllocationCallbacks *pAllocator) {
     vk::ImageCreateInfo imageInfo = {};
     imageInfo.imageType = vk::ImageType::e2D;  // param?
@@ -241,7 +322,7 @@ void createImage(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties
     imageInfo.pQueueFamilyIndices = queueFamilyIndices.data();
 
     image = dev.createImage(imageInfo, pAllocator);
-    createImageMemory(dev, memProps, reqMask, image, memory, pAllocator);
+    createImageMemory(allocator, reqMask, image, allocation, tiling);
 }
 
 void copyBufferToImage(const vk::CommandBuffer &cmd, uint32_t width, uint32_t height, uint32_t layerCount,
@@ -397,6 +478,57 @@ void transitionImageLayout(const vk::CommandBuffer &cmd, const vk::Image &image,
     //}
 }
 
+void transferBufferOwnership(const vk::CommandBuffer &releaseCmd, const vk::CommandBuffer &acquireCmd,
+                             const vk::Buffer &buffer, const uint32_t srcQueueFamilyIndex,
+                             const uint32_t dstQueueFamilyIndex) {
+    assert(srcQueueFamilyIndex != dstQueueFamilyIndex);
+    vk::BufferMemoryBarrier barrier = {};
+    barrier.srcQueueFamilyIndex = srcQueueFamilyIndex;
+    barrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+    barrier.buffer = buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    // RELEASE (dstAccessMask is ignored)
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = {};
+    releaseCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {},
+                               {barrier}, {});
+
+    // ACQUIRE (srcAccessMask is ignored)
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead;
+    acquireCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {},
+                               {barrier}, {});
+}
+
+void transferImageOwnership(const vk::CommandBuffer &releaseCmd, const vk::CommandBuffer &acquireCmd,
+                            const vk::Image &image, const vk::ImageLayout &layout, const uint32_t srcQueueFamilyIndex,
+                            const uint32_t dstQueueFamilyIndex, const uint32_t mipLevels, const uint32_t arrayLayers,
+                            const vk::ImageAspectFlags aspect) {
+    assert(srcQueueFamilyIndex != dstQueueFamilyIndex);
+    vk::ImageMemoryBarrier barrier = {};
+    // The layout is left alone. Any transition after this happens on the destination queue.
+    barrier.oldLayout = layout;
+    barrier.newLayout = layout;
+    barrier.srcQueueFamilyIndex = srcQueueFamilyIndex;
+    barrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+    barrier.image = image;
+    barrier.subresourceRange = {aspect, 0, mipLevels, 0, arrayLayers};
+
+    // RELEASE (dstAccessMask is ignored)
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = {};
+    releaseCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {},
+                               {}, {barrier});
+
+    // ACQUIRE (srcAccessMask is ignored)
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite;
+    acquireCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                               {barrier});
+}
+
 void cramers3(glm::vec3 c1, glm::vec3 c2, glm::vec3 c3, glm::vec3 c4) {
     /*  Setup example (comes from barycentric intersection):
 
@@ -463,9 +595,95 @@ constexpr bool sharesTwoIndices(const IndexBufferType i00, const IndexBufferType
         if (any1(r0, r1, i01, r)) return true;
     return false;
 }
+constexpr uint32_t NO_EDGE = UINT32_MAX;
+// Undirected, so both windings of an edge land in the same group.
+constexpr uint64_t edgeKey(const IndexBufferType i0, const IndexBufferType i1) {
+    return i0 < i1 ? (static_cast<uint64_t>(i0) << 32) | i1 : (static_cast<uint64_t>(i1) << 32) | i0;
+}
+struct EdgeUse {
+    uint32_t triangle;
+    IndexBufferType opposite;  // The vertex of "triangle" that is not on the edge.
+};
 }  // namespace
 
+/* Every edge of every triangle is put in a group with the other triangles that use it (found through a hash of the edge),
+ *  with the groups laid out back to back in triangle order, so the neighbors of a triangle on an edge are right next to
+ *  it in its group. This used to be a scan outward from each triangle for the nearest one sharing the edge, and for edges
+ *  shared by more than two triangles the nearest one is still the one picked (the previous one when both are as near).
+ */
 void makeTriangleAdjacenyList(const std::vector<IndexBufferType> &indices, std::vector<IndexBufferType> &indicesAdjaceny) {
+    const auto triangleCount = indices.size() / 3;
+    assert(triangleCount * 3 == indices.size() && triangleCount < NO_EDGE);
+    // Edges without a neighbor are left 0. Only the first 6 indices per triangle are filled, but the size is kept the
+    //  same as "makeTriangleAdjacenyListScan" (3 times the index count).
+    indicesAdjaceny.assign(indices.size() * 3, 0);
+
+    // Group the edges. "edgeGroups" is the group of each triangle edge, and "groupOffsets" is the number of triangles
+    //  in each group, then the offset of each group once summed.
+    std::unordered_map<uint64_t, uint32_t> groups;
+    groups.reserve(triangleCount * 2);
+    std::vector<uint32_t> edgeGroups(triangleCount * 3);
+    std::vector<uint32_t> groupOffsets;
+    groupOffsets.reserve(triangleCount * 2);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (size_t e = 0; e < 3; e++) {
+            auto key = edgeKey(indices[i + e], indices[i + ((e + 1) % 3)]);
+            auto it = groups.try_emplace(key, static_cast<uint32_t>(groupOffsets.size())).first;
+            if (it->second == groupOffsets.size()) groupOffsets.push_back(0);
+            edgeGroups[i + e] = it->second;
+            // A degenerate triangle can use the same edge twice, but it is only in the group once.
+            if ((e > 0 && edgeGroups[i] == it->second) || (e > 1 && edgeGroups[i + 1] == it->second)) continue;
+            groupOffsets[it->second]++;
+        }
+    }
+    uint32_t offset = 0;
+    for (auto &groupOffset : groupOffsets) {
+        auto count = groupOffset;
+        groupOffset = offset;
+        offset += count;
+    }
+    groupOffsets.push_back(offset);
+
+    // Fill the groups in triangle order, and keep where each triangle edge went.
+    std::vector<EdgeUse> uses(offset);
+    std::vector<uint32_t> usePositions(indices.size());
+    std::vector<uint32_t> cursors(groupOffsets.begin(), groupOffsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (size_t e = 0; e < 3; e++) {
+            const auto group = edgeGroups[i + e];
+            if (e > 0 && edgeGroups[i] == group) {
+                usePositions[i + e] = usePositions[i];
+            } else if (e > 1 && edgeGroups[i + 1] == group) {
+                usePositions[i + e] = usePositions[i + 1];
+            } else {
+                usePositions[i + e] = cursors[group];
+                uses[cursors[group]++] = {static_cast<uint32_t>(i / 3), indices[i + ((e + 2) % 3)]};
+            }
+        }
+    }
+
+    // Layout per triangle: { t0, adjacent to t0/t1, t1, adjacent to t1/t2, t2, adjacent to t2/t0 }
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const auto triangle = static_cast<uint32_t>(i / 3);
+        for (size_t e = 0; e < 3; e++) {
+            indicesAdjaceny[(i * 2) + (e * 2)] = indices[i + e];
+
+            const auto group = edgeGroups[i + e];
+            const auto position = usePositions[i + e];
+            auto adjacent = position > groupOffsets[group] ? position - 1 : NO_EDGE;
+            if (position + 1 < groupOffsets[group + 1] &&
+                (adjacent == NO_EDGE || uses[position + 1].triangle - triangle < triangle - uses[adjacent].triangle))
+                adjacent = position + 1;
+            if (adjacent != NO_EDGE) indicesAdjaceny[(i * 2) + (e * 2) + 1] = uses[adjacent].opposite;
+        }
+    }
+}
+
+/* The scan "makeTriangleAdjacenyList" replaced. It is quadratic in the triangle count, and is only kept as a reference
+ *  for the tests.
+ */
+void makeTriangleAdjacenyListScan(const std::vector<IndexBufferType> &indices,
+                                  std::vector<IndexBufferType> &indicesAdjaceny) {
     indicesAdjaceny.resize(indices.size() * 3);
     // I used int64_t in the second loops below.
     assert(indicesAdjaceny.size() <= INT64_MAX);
@@ -654,4 +872,87 @@ void recordBarriers(const BarrierResource &resource, const vk::CommandBuffer &cm
                         resource.imgBarriers);
 }
 
+// THREAD POOL
+
+ThreadPool &ThreadPool::get() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool() : stopping_(false) {
+    const auto threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t i = 1; i < threadCount; i++) threads_.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+    for (auto &thread : threads_) thread.join();
+}
+
+void ThreadPool::run(const size_t count, const std::function<void(const size_t)> &func) {
+    if (threads_.empty() || count < 2) {
+        for (size_t i = 0; i < count; i++) func(i);
+        return;
+    }
+
+    auto pLoop = std::make_shared<Loop>();
+    pLoop->pFunc = &func;
+    pLoop->count = count;
+    pLoop->next = 0;
+    pLoop->done = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loops_.push_back(pLoop);
+    }
+    workCv_.notify_all();
+
+    work(*pLoop);
+
+    // Every index has been taken, so wait for the ones still running on workers.
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find(loops_.begin(), loops_.end(), pLoop);
+    if (it != loops_.end()) loops_.erase(it);
+    doneCv_.wait(lock, [&pLoop, count]() { return pLoop->done == count; });
+    if (pLoop->pException) std::rethrow_exception(pLoop->pException);
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::shared_ptr<Loop> pLoop;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workCv_.wait(lock, [this]() { return stopping_ || !loops_.empty(); });
+            if (stopping_) return;
+            pLoop = loops_.front();
+        }
+
+        work(*pLoop);
+
+        // Nothing left to take, so stop handing it out.
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find(loops_.begin(), loops_.end(), pLoop);
+        if (it != loops_.end()) loops_.erase(it);
+    }
+}
+
+void ThreadPool::work(Loop &loop) {
+    for (size_t i = loop.next++; i < loop.count; i = loop.next++) {
+        try {
+            (*loop.pFunc)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!loop.pException) loop.pException = std::current_exception();
+        }
+        if (++loop.done == loop.count) {
+            // Under the lock, so the wait in "run" can't miss it.
+            std::lock_guard<std::mutex> lock(mutex_);
+            doneCv_.notify_all();
+        }
+    }
+}
+
 }  // namespace helpers
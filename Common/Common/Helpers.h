@@ -27,19 +27,30 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <stdio.h>
+#include <thread>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 #include <utility>
 
+#include "Memory.h"
 #include "Types.h"
 
 namespace helpers {
@@ -138,6 +149,61 @@ static MODEL_FILE_TYPE getModelFileType(std::string s) {
     return MODEL_FILE_TYPE::UNKNOWN;
 }
 
+// CACHE FILES
+
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+// FNV-1a. Start "h" at FNV_OFFSET_BASIS.
+void hash(uint64_t &h, const void *pData, const size_t size);
+
+// Windows path delimiters are converted, so a file always has the same name in a cache.
+std::string normalizePath(std::string path);
+
+enum class FILE_HASH {
+    PATH,      // Just the normalized path.
+    STAMP,     // The path, and the file's size and modified time.
+    CONTENTS,  // The path, and every byte of the file.
+};
+void hashFile(uint64_t &h, const std::string &path, const FILE_HASH what);
+
+/* Calls "write" with a file of its own, and renames it over "path" if "write" returns true and the file is good. A
+ *  reader never sees a partial file, and threads writing the same path never write over each other. Returns false if
+ *  anything failed, and "path" is left alone.
+ */
+bool writeFileAtomic(const std::string &path, const std::function<bool(std::ofstream &)> &write);
+
+/* Read-only view of a whole file. The pages are only read when they are touched, so copying out of "data()" is the
+ *  only copy the bytes ever take. "data()" is nullptr if the file couldn't be opened or is empty.
+ */
+class MappedFile {
+   public:
+    MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    inline const uint8_t *data() const { return pData_; }
+    inline size_t size() const { return size_; }
+
+   private:
+    const uint8_t *pData_;
+    size_t size_;
+#ifdef _WIN32
+    void *hFile_;
+    void *hMapping_;
+#endif
+};
+
+template <typename T>
+bool readValue(std::istream &stream, T &value) {
+    return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T>
+void writeValue(std::ostream &stream, const T &value) {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
 // This obviously doesn't work right
 template <typename T>
 constexpr int nearestOdd(T value, bool roundDown = true) {
@@ -235,22 +301,22 @@ vk::Format findDepthFormat(const vk::PhysicalDevice &phyDev);
 bool getMemoryType(const vk::PhysicalDeviceMemoryProperties &memProps, uint32_t typeBits, vk::MemoryPropertyFlags reqMask,
                    uint32_t *typeIndex);
 
-vk::DeviceSize createBuffer(const vk::Device &dev, const vk::DeviceSize &size, const vk::BufferUsageFlags &usage,
-                            const vk::MemoryPropertyFlags &props, const vk::PhysicalDeviceMemoryProperties &memProps,
-                            vk::Buffer &buff, vk::DeviceMemory &mem, const vk::AllocationCallbacks *pAllocator);
+// "transient" should be set for short lived buffers (staging) so they are bump allocated.
+vk::DeviceSize createBuffer(const vk::Device &dev, Memory::Allocator &allocator, const vk::DeviceSize &size,
+                            const vk::BufferUsageFlags &usage, const vk::MemoryPropertyFlags &props, vk::Buffer &buff,
+                            Memory::Allocation &allocation, const vk::AllocationCallbacks *pAllocator,
+                            const bool transient = false);
 
 void copyBuffer(const vk::CommandBuffer &cmd, const vk::Buffer &srcBuff, const vk::Buffer &dstBuff,
                 const vk::DeviceSize &size);
 
-void createImageMemory(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties &memProps,
-                       const vk::MemoryPropertyFlags &memPropFlags, vk::Image &image, vk::DeviceMemory &memory,
-                       const vk::AllocationCallbacks *pAllocator);
+void createImageMemory(Memory::Allocator &allocator, const vk::MemoryPropertyFlags &memPropFlags, const vk::Image &image,
+                       Memory::Allocation &allocation, const vk::ImageTiling tiling = vk::ImageTiling::eOptimal);
 
-void createImage(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties &memProps,
-                 const std::vector<uint32_t> &queueFamilyIndices, const vk::SampleCountFlagBits &numSamples,
-                 const vk::Format &format, const vk::ImageTiling &tiling, const vk::ImageUsageFlags &usage,
-                 const vk::MemoryPropertyFlags &reqMask, uint32_t width, uint32_t height, uint32_t mipLevels,
-                 uint32_t arrayLayers, vk::Image &image, vk::DeviceMemory &memory,
+void createImage(const vk::Device &dev, Memory::Allocator &allocator, const std::vector<uint32_t> &queueFamilyIndices,
+                 const vk::SampleCountFlagBits &numSamples, const vk::Format &format, const vk::ImageTiling &tiling,
+                 const vk::ImageUsageFlags &usage, const vk::MemoryPropertyFlags &reqMask, uint32_t width, uint32_t height,
+                 uint32_t mipLevels, uint32_t arrayLayers, vk::Image &image, Memory::Allocation &allocation,
                  const vk::AllocationCallbacks *pAllocator);
 
 void copyBufferToImage(const vk::CommandBuffer &cmd, uint32_t width, uint32_t height, uint32_t layerCount,
@@ -265,6 +331,19 @@ void transitionImageLayout(const vk::CommandBuffer &cmd, const vk::Image &image,
                            vk::PipelineStageFlags srcStages, vk::PipelineStageFlags dstStages, uint32_t mipLevels,
                            uint32_t arrayLayers);
 
+/* Queue family ownership transfer of a resource written by transfer commands. The release is recorded into
+ *  "releaseCmd" (source family), and the matching acquire into "acquireCmd" (destination family). The acquire has to
+ *  be submitted after the release, and wait on it with a semaphore. Only needed for exclusive resources when the
+ *  families differ.
+ */
+void transferBufferOwnership(const vk::CommandBuffer &releaseCmd, const vk::CommandBuffer &acquireCmd,
+                             const vk::Buffer &buffer, const uint32_t srcQueueFamilyIndex,
+                             const uint32_t dstQueueFamilyIndex);
+void transferImageOwnership(const vk::CommandBuffer &releaseCmd, const vk::CommandBuffer &acquireCmd,
+                            const vk::Image &image, const vk::ImageLayout &layout, const uint32_t srcQueueFamilyIndex,
+                            const uint32_t dstQueueFamilyIndex, const uint32_t mipLevels, const uint32_t arrayLayers,
+                            const vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor);
+
 void cramers3(glm::vec3 c1, glm::vec3 c2, glm::vec3 c3, glm::vec3 c4);
 
 static glm::vec3 triangleNormal(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
@@ -279,6 +358,9 @@ static glm::vec2 pointOnCircle(const glm::vec2 origin, float radius, float angle
 }
 
 void makeTriangleAdjacenyList(const std::vector<IndexBufferType> &indices, std::vector<IndexBufferType> &indiciesAdjacency);
+// Reference for "makeTriangleAdjacenyList". Do not use it for real meshes.
+void makeTriangleAdjacenyListScan(const std::vector<IndexBufferType> &indices,
+                                  std::vector<IndexBufferType> &indiciesAdjacency);
 
 static void destroyCommandBuffers(const vk::Device &dev, const vk::CommandPool &pool, std::vector<vk::CommandBuffer> &cmds) {
     if (cmds.size()) {
@@ -299,10 +381,11 @@ static FlagBits incrementByteFlag(FlagBits flags, T1 firstBit, T2 allBits) {
     return flags;
 }
 
-static void destroyImageResource(const vk::Device &dev, ImageResource &res, vk::AllocationCallbacks *pAllocator) {
+static void destroyImageResource(const vk::Device &dev, Memory::Allocator &allocator, ImageResource &res,
+                                 vk::AllocationCallbacks *pAllocator) {
     if (res.view) dev.destroyImageView(res.view, pAllocator);
     if (res.image) dev.destroyImage(res.image, pAllocator);
-    if (res.memory) dev.freeMemory(res.memory, pAllocator);
+    allocator.free(res.allocation);
 }
 
 constexpr bool compExtent2D(const vk::Extent2D &a, const vk::Extent2D &b) {
@@ -364,6 +447,46 @@ void recordBarriers(const BarrierResource &resource, const vk::CommandBuffer &cm
 
 inline void normalizePlane(plane &plane) { plane /= glm::length(glm::vec3(plane.x, plane.y, plane.z)); }
 
+/* Threads shared by every "parallelFor" for the life of the process, so a loop doesn't start threads of its own.
+ *  Loops that run at the same time, or inside each other (models loading on their own threads that each weld in
+ *  parallel), share the same hardware_concurrency - 1 workers. The calling thread always works on its own loop too, so
+ *  a loop still finishes when every worker is busy with something else.
+ */
+class ThreadPool {
+   public:
+    static ThreadPool &get();
+    ~ThreadPool();
+
+    // Calls "func(i)" for every i in [0, count). The first exception thrown by "func" is rethrown here.
+    void run(const size_t count, const std::function<void(const size_t)> &func);
+
+   private:
+    struct Loop {
+        const std::function<void(const size_t)> *pFunc;
+        size_t count;
+        std::atomic<size_t> next, done;
+        std::exception_ptr pException;
+    };
+
+    ThreadPool();
+    void workerLoop();
+    void work(Loop &loop);
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+    std::deque<std::shared_ptr<Loop>> loops_;
+    std::vector<std::thread> threads_;
+    bool stopping_;
+};
+
+// Calls "func(i)" for every i in [0, count) on the thread pool, the calling thread included. Threads pull the next
+//  index when they finish one, so uneven work balances out. Returns once every call has returned.
+template <typename TFunc>
+void parallelFor(const size_t count, TFunc &&func) {
+    ThreadPool::get().run(count, [&func](const size_t i) { func(i); });
+}
+
 }  // namespace helpers
 
 #endif  // !HELPERS_H
@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "Memory.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+constexpr vk::DeviceSize alignUp(const vk::DeviceSize value, const vk::DeviceSize alignment) {
+    return alignment ? ((value + alignment - 1) / alignment) * alignment : value;
+}
+
+constexpr vk::DeviceSize alignDown(const vk::DeviceSize value, const vk::DeviceSize alignment) {
+    return alignment ? (value / alignment) * alignment : value;
+}
+
+inline uint32_t log2Ceil(vk::DeviceSize value) {
+    uint32_t order = 0;
+    while ((static_cast<vk::DeviceSize>(1) << order) < value) order++;
+    return order;
+}
+
+inline uint32_t log2Floor(vk::DeviceSize value) {
+    uint32_t order = 0;
+    while (value >>= 1) order++;
+    return order;
+}
+
+}  // namespace
+
+namespace Memory {
+
+// STATS
+
+float Stats::fragmentation() const {
+    if (freeBytes == 0) return 0.0f;
+    return 1.0f - (static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes));
+}
+
+float Stats::internalWaste() const {
+    if (usedBytes == 0) return 0.0f;
+    return 1.0f - (static_cast<float>(requestedBytes) / static_cast<float>(usedBytes));
+}
+
+// BLOCK
+
+bool Allocator::Block::allocate(const STRATEGY strategy, const vk::DeviceSize size, const vk::DeviceSize alignment,
+                                vk::DeviceSize &offset, vk::DeviceSize &allocatedSize) {
+    switch (strategy) {
+        case STRATEGY::BUDDY: {
+            // Buddy ranges are aligned to their size so rounding up to the alignment is all that is needed.
+            auto reqOrder = std::max(log2Ceil(std::max(size, alignment)), MIN_BUDDY_ORDER);
+            if (reqOrder > order) return false;
+
+            // Find the smallest free range that fits.
+            auto freeOrder = reqOrder;
+            while (freeOrder <= order && freeLists[freeOrder - MIN_BUDDY_ORDER].empty()) freeOrder++;
+            if (freeOrder > order) return false;
+
+            // Always take the lowest offset so the results are deterministic, and the top of the block stays free.
+            auto &freeList = freeLists[freeOrder - MIN_BUDDY_ORDER];
+            offset = *freeList.begin();
+            freeList.erase(freeList.begin());
+
+            // Split down to the requested order.
+            while (freeOrder > reqOrder) {
+                freeOrder--;
+                freeLists[freeOrder - MIN_BUDDY_ORDER].insert(offset + (static_cast<vk::DeviceSize>(1) << freeOrder));
+            }
+
+            allocatedOrders[offset] = {reqOrder, size};
+            allocatedSize = static_cast<vk::DeviceSize>(1) << reqOrder;
+        } break;
+        case STRATEGY::LINEAR: {
+            auto alignedHead = alignUp(head, alignment);
+            if (alignedHead + size > this->size) return false;
+            offset = alignedHead;
+            allocatedSize = size;
+            head = alignedHead + size;
+        } break;
+        default:
+            assert(false && "Unhandled strategy");
+            return false;
+    }
+    allocationCount++;
+    usedBytes += allocatedSize;
+    requestedBytes += size;
+    return true;
+}
+
+void Allocator::Block::free(const STRATEGY strategy, const vk::DeviceSize offset, const vk::DeviceSize size) {
+    assert(allocationCount > 0);
+    switch (strategy) {
+        case STRATEGY::BUDDY: {
+            auto it = allocatedOrders.find(offset);
+            assert(it != allocatedOrders.end() && "Allocation does not belong to this block");
+            auto freeOrder = it->second.first;
+            usedBytes -= static_cast<vk::DeviceSize>(1) << freeOrder;
+            requestedBytes -= it->second.second;
+            allocatedOrders.erase(it);
+
+            // Merge with the buddy as long as it is free.
+            auto freeOffset = offset;
+            while (freeOrder < order) {
+                auto buddy = freeOffset ^ (static_cast<vk::DeviceSize>(1) << freeOrder);
+                auto &freeList = freeLists[freeOrder - MIN_BUDDY_ORDER];
+                auto itBuddy = freeList.find(buddy);
+                if (itBuddy == freeList.end()) break;
+                freeList.erase(itBuddy);
+                freeOffset = std::min(freeOffset, buddy);
+                freeOrder++;
+            }
+            freeLists[freeOrder - MIN_BUDDY_ORDER].insert(freeOffset);
+        } break;
+        case STRATEGY::LINEAR: {
+            usedBytes -= size;
+            requestedBytes -= size;
+        } break;
+        default:
+            assert(false && "Unhandled strategy");
+            break;
+    }
+    allocationCount--;
+    // Linear blocks rewind once everything in them has been released.
+    if (allocationCount == 0) head = 0;
+}
+
+vk::DeviceSize Allocator::Block::largestFreeRange(const STRATEGY strategy) const {
+    switch (strategy) {
+        case STRATEGY::BUDDY:
+            for (auto i = static_cast<int32_t>(freeLists.size()) - 1; i >= 0; i--)
+                if (!freeLists[i].empty()) return static_cast<vk::DeviceSize>(1) << (i + MIN_BUDDY_ORDER);
+            return 0;
+        case STRATEGY::LINEAR:
+            return size - head;
+        default:
+            assert(false && "Unhandled strategy");
+            return 0;
+    }
+}
+
+// ALLOCATOR
+
+Allocator::Allocator(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties &memProps,
+                     const vk::PhysicalDeviceLimits &limits, const vk::AllocationCallbacks *pAllocator)
+    : dev_(dev),
+      memProps_(memProps),
+      pAllocator_(pAllocator),
+      maxMemoryAllocationCount_(limits.maxMemoryAllocationCount),
+      nonCoherentAtomSize_(std::max(limits.nonCoherentAtomSize, static_cast<vk::DeviceSize>(1))),
+      nextBlockId_(0),
+      peakDeviceMemoryCount_(0) {
+    assert(dev_);
+}
+
+Allocator::~Allocator() { assert(pools_.empty() && dedicated_.empty() && "Did you call destroy?"); }
+
+Allocation Allocator::allocate(const CreateInfo &createInfo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto &reqs = createInfo.requirements;
+    auto memoryTypeIndex = getMemoryTypeIndex(reqs.memoryTypeBits, createInfo.properties);
+
+    // Non-coherent ranges have to be flushed in multiples of nonCoherentAtomSize, so never let two allocations share
+    // an atom.
+    auto alignment = std::max(reqs.alignment, static_cast<vk::DeviceSize>(1));
+    auto size = reqs.size;
+    if (isHostVisible(memoryTypeIndex) && !(memProps_.memoryTypes[memoryTypeIndex].propertyFlags &
+                                            vk::MemoryPropertyFlagBits::eHostCoherent)) {
+        alignment = std::max(alignment, nonCoherentAtomSize_);
+        size = alignUp(size, nonCoherentAtomSize_);
+    }
+
+    // Pick the size class.
+    STRATEGY strategy;
+    vk::DeviceSize blockSize;
+    if (createInfo.transient) {
+        strategy = STRATEGY::LINEAR;
+        blockSize = clampBlockSize(memoryTypeIndex, LINEAR_BLOCK_SIZE);
+    } else if (size <= SMALL_ALLOCATION_MAX) {
+        strategy = STRATEGY::BUDDY;
+        blockSize = clampBlockSize(memoryTypeIndex, SMALL_BLOCK_SIZE);
+    } else {
+        strategy = STRATEGY::BUDDY;
+        blockSize = clampBlockSize(memoryTypeIndex, LARGE_BLOCK_SIZE);
+    }
+
+    if (createInfo.dedicated || (size + alignment) > (blockSize / 2)) {
+        return allocateDedicated(memoryTypeIndex, size);
+    }
+
+    auto poolIndex = getPoolIndex(memoryTypeIndex, createInfo.resourceType, strategy, blockSize);
+    auto &pool = pools_[poolIndex];
+
+    Allocation allocation = {};
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.poolIndex = poolIndex;
+
+    auto tryBlock = [&](Block &block) {
+        if (!block.allocate(strategy, size, alignment, allocation.offset, allocation.size)) return false;
+        allocation.memory = block.memory;
+        allocation.blockId = block.id;
+        if (block.pMappedData) allocation.pMappedData = block.pMappedData + allocation.offset;
+        return true;
+    };
+
+    for (auto &pBlock : pool.blocks)
+        if (tryBlock(*pBlock)) return allocation;
+
+    auto pBlock = createBlock(pool);
+    auto pass = tryBlock(*pBlock);
+    assert(pass && "A new block should always fit the request");
+    return allocation;
+}
+
+void Allocator::free(Allocation &allocation) {
+    if (!allocation.memory) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (allocation.poolIndex == UINT32_MAX) {
+        // DEDICATED
+        auto it = dedicated_.find(static_cast<VkDeviceMemory>(allocation.memory));
+        assert(it != dedicated_.end());
+        if (it->second.mapped) dev_.unmapMemory(allocation.memory);
+        dev_.freeMemory(allocation.memory, pAllocator_);
+        dedicated_.erase(it);
+    } else {
+        auto &pool = pools_.at(allocation.poolIndex);
+        auto itBlock = std::find_if(pool.blocks.begin(), pool.blocks.end(),
+                                    [&allocation](const auto &pBlock) { return pBlock->id == allocation.blockId; });
+        assert(itBlock != pool.blocks.end());
+        auto &block = **itBlock;
+        block.free(pool.strategy, allocation.offset, allocation.size);
+
+        // Keep one empty block around per pool so that load/unload cycles don't thrash allocateMemory.
+        if (block.allocationCount == 0) {
+            auto emptyCount = std::count_if(pool.blocks.begin(), pool.blocks.end(),
+                                            [](const auto &pBlock) { return pBlock->allocationCount == 0; });
+            if (emptyCount > 1) {
+                destroyBlock(block);
+                pool.blocks.erase(itBlock);
+            }
+        }
+    }
+
+    allocation = {};
+}
+
+Allocation Allocator::allocateBuffer(const vk::Buffer &buffer, const vk::MemoryPropertyFlags &properties,
+                                     const bool transient) {
+    CreateInfo createInfo = {};
+    createInfo.requirements = dev_.getBufferMemoryRequirements(buffer);
+    createInfo.properties = properties;
+    createInfo.resourceType = RESOURCE::BUFFER;
+    createInfo.transient = transient;
+    auto allocation = allocate(createInfo);
+    dev_.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+    return allocation;
+}
+
+Allocation Allocator::allocateImage(const vk::Image &image, const vk::MemoryPropertyFlags &properties,
+                                    const vk::ImageTiling tiling) {
+    CreateInfo createInfo = {};
+    createInfo.requirements = dev_.getImageMemoryRequirements(image);
+    createInfo.properties = properties;
+    createInfo.resourceType = tiling == vk::ImageTiling::eOptimal ? RESOURCE::IMAGE : RESOURCE::BUFFER;
+    auto allocation = allocate(createInfo);
+    dev_.bindImageMemory(image, allocation.memory, allocation.offset);
+    return allocation;
+}
+
+bool Allocator::isCoherent(const Allocation &allocation) const {
+    assert(allocation.memoryTypeIndex < memProps_.memoryTypeCount);
+    return static_cast<bool>(memProps_.memoryTypes[allocation.memoryTypeIndex].propertyFlags &
+                             vk::MemoryPropertyFlagBits::eHostCoherent);
+}
+
+vk::MappedMemoryRange Allocator::getFlushRange(const Allocation &allocation, const vk::DeviceSize offset,
+                                               const vk::DeviceSize size) const {
+    assert(offset <= allocation.size);
+    auto end = (size == VK_WHOLE_SIZE) ? allocation.size
+                                       : std::min(alignUp(offset + size, nonCoherentAtomSize_), allocation.size);
+    auto begin = alignDown(offset, nonCoherentAtomSize_);
+    // Allocations in non-coherent memory are atom aligned (see "allocate"), so the range stays inside the allocation.
+    return {allocation.memory, allocation.offset + begin, end - begin};
+}
+
+void Allocator::flush(const Allocation &allocation, const vk::DeviceSize offset, const vk::DeviceSize size) const {
+    if (isCoherent(allocation)) return;
+    dev_.flushMappedMemoryRanges({getFlushRange(allocation, offset, size)});
+}
+
+void Allocator::flush(const std::vector<vk::MappedMemoryRange> &ranges) const {
+    if (ranges.size()) dev_.flushMappedMemoryRanges(ranges);
+}
+
+Stats Allocator::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats = {};
+    for (const auto &pool : pools_) {
+        for (const auto &pBlock : pool.blocks) {
+            stats.blockCount++;
+            stats.allocationCount += pBlock->allocationCount;
+            stats.blockBytes += pBlock->size;
+            stats.usedBytes += pBlock->usedBytes;
+            stats.requestedBytes += pBlock->requestedBytes;
+            stats.freeBytes += pBlock->size - pBlock->usedBytes;
+            stats.largestFreeRange = std::max(stats.largestFreeRange, pBlock->largestFreeRange(pool.strategy));
+        }
+    }
+    for (const auto &[memory, dedicated] : dedicated_) {
+        stats.dedicatedCount++;
+        stats.allocationCount++;
+        stats.dedicatedBytes += dedicated.size;
+    }
+    stats.deviceMemoryCount = stats.blockCount + stats.dedicatedCount;
+    stats.peakDeviceMemoryCount = peakDeviceMemoryCount_;
+    return stats;
+}
+
+std::string Allocator::getStatsString() const {
+    auto stats = getStats();
+    std::stringstream ss;
+    ss << "Device memory: " << stats.deviceMemoryCount << " allocation(s) (peak " << stats.peakDeviceMemoryCount
+       << ", limit " << maxMemoryAllocationCount_ << ")" << std::endl;
+    ss << "    blocks: " << stats.blockCount << " (" << stats.blockBytes << " bytes), dedicated: " << stats.dedicatedCount
+       << " (" << stats.dedicatedBytes << " bytes)" << std::endl;
+    ss << "    sub-allocations: " << stats.allocationCount << ", used: " << stats.usedBytes
+       << " bytes, free: " << stats.freeBytes << " bytes, largest free range: " << stats.largestFreeRange << " bytes"
+       << std::endl;
+    ss << "    fragmentation: " << stats.fragmentation() << ", internal waste: " << stats.internalWaste() << std::endl;
+    return ss.str();
+}
+
+void Allocator::destroy() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Anything that was not freed by its owner is released along with the blocks.
+    for (auto &pool : pools_)
+        for (auto &pBlock : pool.blocks) destroyBlock(*pBlock);
+    pools_.clear();
+    for (auto &[memory, dedicated] : dedicated_) {
+        if (dedicated.mapped) dev_.unmapMemory(memory);
+        dev_.freeMemory(memory, pAllocator_);
+    }
+    dedicated_.clear();
+}
+
+uint32_t Allocator::getMemoryTypeIndex(const uint32_t typeBits, const vk::MemoryPropertyFlags &properties) const {
+    // Search memtypes to find first index with those properties
+    for (uint32_t i = 0; i < memProps_.memoryTypeCount; i++) {
+        if ((typeBits & (1 << i)) && (memProps_.memoryTypes[i].propertyFlags & properties) == properties) return i;
+    }
+    assert(false && "No memory type matches the properties");
+    exit(EXIT_FAILURE);
+}
+
+uint32_t Allocator::getPoolIndex(const uint32_t memoryTypeIndex, const RESOURCE resourceType, const STRATEGY strategy,
+                                 const vk::DeviceSize blockSize) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(pools_.size()); i++) {
+        const auto &pool = pools_[i];
+        if (pool.memoryTypeIndex == memoryTypeIndex && pool.resourceType == resourceType && pool.strategy == strategy &&
+            pool.blockSize == blockSize)
+            return i;
+    }
+    pools_.push_back({memoryTypeIndex, resourceType, strategy, blockSize, {}});
+    return static_cast<uint32_t>(pools_.size() - 1);
+}
+
+Allocator::Block *Allocator::createBlock(Pool &pool) {
+    assert(deviceMemoryCount() < maxMemoryAllocationCount_);
+
+    auto pBlock = std::make_unique<Block>();
+    pBlock->id = nextBlockId_++;
+    pBlock->size = pool.blockSize;
+    pBlock->pMappedData = nullptr;
+    pBlock->allocationCount = 0;
+    pBlock->usedBytes = 0;
+    pBlock->requestedBytes = 0;
+    pBlock->head = 0;
+    pBlock->order = log2Floor(pool.blockSize);
+    if (pool.strategy == STRATEGY::BUDDY) {
+        assert(pBlock->order >= MIN_BUDDY_ORDER);
+        pBlock->freeLists.resize(pBlock->order - MIN_BUDDY_ORDER + 1);
+        pBlock->freeLists.back().insert(0);
+    }
+
+    vk::MemoryAllocateInfo allocInfo = {};
+    allocInfo.allocationSize = pBlock->size;
+    allocInfo.memoryTypeIndex = pool.memoryTypeIndex;
+    pBlock->memory = dev_.allocateMemory(allocInfo, pAllocator_);
+
+    if (isHostVisible(pool.memoryTypeIndex))
+        pBlock->pMappedData = static_cast<uint8_t *>(dev_.mapMemory(pBlock->memory, 0, VK_WHOLE_SIZE));
+
+    pool.blocks.push_back(std::move(pBlock));
+    peakDeviceMemoryCount_ = std::max(peakDeviceMemoryCount_, deviceMemoryCount());
+    return pool.blocks.back().get();
+}
+
+void Allocator::destroyBlock(Block &block) {
+    if (block.pMappedData) dev_.unmapMemory(block.memory);
+    dev_.freeMemory(block.memory, pAllocator_);
+    block.memory = vk::DeviceMemory{};
+    block.pMappedData = nullptr;
+}
+
+Allocation Allocator::allocateDedicated(const uint32_t memoryTypeIndex, const vk::DeviceSize size) {
+    assert(deviceMemoryCount() < maxMemoryAllocationCount_);
+
+    vk::MemoryAllocateInfo allocInfo = {};
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    Allocation allocation = {};
+    allocation.memory = dev_.allocateMemory(allocInfo, pAllocator_);
+    allocation.offset = 0;
+    allocation.size = size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+
+    bool mapped = isHostVisible(memoryTypeIndex);
+    if (mapped) allocation.pMappedData = dev_.mapMemory(allocation.memory, 0, VK_WHOLE_SIZE);
+
+    dedicated_[static_cast<VkDeviceMemory>(allocation.memory)] = {size, mapped};
+    peakDeviceMemoryCount_ = std::max(peakDeviceMemoryCount_, deviceMemoryCount());
+    return allocation;
+}
+
+vk::DeviceSize Allocator::clampBlockSize(const uint32_t memoryTypeIndex, const vk::DeviceSize size) const {
+    // Small heaps (BAR memory for example) should not have most of their memory tied up in a single block.
+    const auto &heap = memProps_.memoryHeaps[memProps_.memoryTypes[memoryTypeIndex].heapIndex];
+    auto blockSize = std::min(size, heap.size / 8);
+    // Buddy blocks need to be a power of two.
+    return std::max(static_cast<vk::DeviceSize>(1) << log2Floor(blockSize),
+                    static_cast<vk::DeviceSize>(1) << (MIN_BUDDY_ORDER + 4));
+}
+
+}  // namespace Memory
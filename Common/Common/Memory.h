@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "Types.h"
+
+/*
+ * Sub-allocating device memory allocator. Every buffer and image used to get its own vk::DeviceMemory which runs into
+ *  maxMemoryAllocationCount on large scenes, and makes loading slow. Now memory is allocated in blocks and handed out in
+ *  ranges:
+ *
+ *  - Small and large requests are taken from separate size class blocks using a buddy allocator. Buddy ranges are
+ *     always a power of two in size and aligned to their size, so any power of two alignment is satisfied for free.
+ *  - Transient requests (staging) are bump allocated from linear blocks. A linear block rewinds once everything in it
+ *     has been freed, which matches how the loading handler releases staging resources.
+ *  - Anything bigger than half a large block gets a dedicated vk::DeviceMemory.
+ *
+ *  Buffers and optimally tiled images never share a block so bufferImageGranularity never has to be considered.
+ *  Host visible blocks are mapped once when they are created, and stay mapped until they are freed.
+ */
+namespace Memory {
+
+constexpr uint32_t MIN_BUDDY_ORDER = 8;  // 256 bytes
+constexpr vk::DeviceSize SMALL_ALLOCATION_MAX = 256 * 1024;
+constexpr vk::DeviceSize SMALL_BLOCK_SIZE = 4 * 1024 * 1024;
+constexpr vk::DeviceSize LARGE_BLOCK_SIZE = 64 * 1024 * 1024;
+constexpr vk::DeviceSize LINEAR_BLOCK_SIZE = 32 * 1024 * 1024;
+
+enum class STRATEGY {
+    //
+    BUDDY = 0,
+    LINEAR,
+};
+
+enum class RESOURCE {
+    // Buffers and linearly tiled images
+    BUFFER = 0,
+    // Optimally tiled images
+    IMAGE,
+};
+
+struct CreateInfo {
+    vk::MemoryRequirements requirements;
+    vk::MemoryPropertyFlags properties;
+    RESOURCE resourceType = RESOURCE::BUFFER;
+    // Short lived allocations that are all released around the same time (staging).
+    bool transient = false;
+    bool dedicated = false;
+};
+
+struct Stats {
+    uint32_t deviceMemoryCount = 0;
+    uint32_t peakDeviceMemoryCount = 0;
+    uint32_t blockCount = 0;
+    uint32_t dedicatedCount = 0;
+    uint32_t allocationCount = 0;
+    vk::DeviceSize blockBytes = 0;
+    vk::DeviceSize dedicatedBytes = 0;
+    vk::DeviceSize requestedBytes = 0;  // Sum of the sizes asked for (block allocations only)
+    vk::DeviceSize usedBytes = 0;       // Sum of the ranges handed out (block allocations only)
+    vk::DeviceSize freeBytes = 0;
+    vk::DeviceSize largestFreeRange = 0;
+    // Portion of the free block memory that can not be handed out as a single range. Zero means all of the free memory
+    // in the blocks is contiguous.
+    float fragmentation() const;
+    // Portion of the used block memory lost to buddy rounding and alignment.
+    float internalWaste() const;
+};
+
+class Allocator : NonCopyable {
+   public:
+    Allocator(const vk::Device &dev, const vk::PhysicalDeviceMemoryProperties &memProps,
+              const vk::PhysicalDeviceLimits &limits, const vk::AllocationCallbacks *pAllocator);
+    ~Allocator();
+
+    Allocation allocate(const CreateInfo &createInfo);
+    void free(Allocation &allocation);
+
+    // Allocate and bind in one step.
+    Allocation allocateBuffer(const vk::Buffer &buffer, const vk::MemoryPropertyFlags &properties,
+                              const bool transient = false);
+    Allocation allocateImage(const vk::Image &image, const vk::MemoryPropertyFlags &properties,
+                             const vk::ImageTiling tiling = vk::ImageTiling::eOptimal);
+
+    bool isCoherent(const Allocation &allocation) const;
+    // Make host writes visible to the device. Does nothing for coherent memory. "offset" is relative to the allocation.
+    void flush(const Allocation &allocation, const vk::DeviceSize offset = 0,
+               const vk::DeviceSize size = VK_WHOLE_SIZE) const;
+    void flush(const std::vector<vk::MappedMemoryRange> &ranges) const;
+    vk::MappedMemoryRange getFlushRange(const Allocation &allocation, const vk::DeviceSize offset = 0,
+                                        const vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+    inline const vk::PhysicalDeviceMemoryProperties &getMemoryProperties() const { return memProps_; }
+    inline vk::DeviceSize getNonCoherentAtomSize() const { return nonCoherentAtomSize_; }
+
+    Stats getStats() const;
+    std::string getStatsString() const;
+
+    void destroy();
+
+   private:
+    struct Block {
+        uint32_t id;
+        vk::DeviceMemory memory;
+        vk::DeviceSize size;
+        uint8_t *pMappedData;
+        uint32_t allocationCount;
+        vk::DeviceSize usedBytes;
+        vk::DeviceSize requestedBytes;
+        // BUDDY
+        uint32_t order;
+        std::vector<std::set<vk::DeviceSize>> freeLists;  // Indexed by (order - MIN_BUDDY_ORDER)
+        std::unordered_map<vk::DeviceSize, std::pair<uint32_t, vk::DeviceSize>> allocatedOrders;  // {order, requested}
+        // LINEAR
+        vk::DeviceSize head;
+        bool allocate(const STRATEGY strategy, const vk::DeviceSize size, const vk::DeviceSize alignment,
+                      vk::DeviceSize &offset, vk::DeviceSize &allocatedSize);
+        void free(const STRATEGY strategy, const vk::DeviceSize offset, const vk::DeviceSize size);
+        vk::DeviceSize largestFreeRange(const STRATEGY strategy) const;
+    };
+
+    struct Pool {
+        uint32_t memoryTypeIndex;
+        RESOURCE resourceType;
+        STRATEGY strategy;
+        vk::DeviceSize blockSize;
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    struct Dedicated {
+        vk::DeviceSize size;
+        bool mapped;
+    };
+
+    uint32_t getMemoryTypeIndex(const uint32_t typeBits, const vk::MemoryPropertyFlags &properties) const;
+    uint32_t getPoolIndex(const uint32_t memoryTypeIndex, const RESOURCE resourceType, const STRATEGY strategy,
+                          const vk::DeviceSize blockSize);
+    Block *createBlock(Pool &pool);
+    void destroyBlock(Block &block);
+    Allocation allocateDedicated(const uint32_t memoryTypeIndex, const vk::DeviceSize size);
+    vk::DeviceSize clampBlockSize(const uint32_t memoryTypeIndex, const vk::DeviceSize size) const;
+    inline bool isHostVisible(const uint32_t memoryTypeIndex) const {
+        return static_cast<bool>(memProps_.memoryTypes[memoryTypeIndex].propertyFlags &
+                                 vk::MemoryPropertyFlagBits::eHostVisible);
+    }
+    inline uint32_t deviceMemoryCount() const {
+        uint32_t count = static_cast<uint32_t>(dedicated_.size());
+        for (const auto &pool : pools_) count += static_cast<uint32_t>(pool.blocks.size());
+        return count;
+    }
+
+    vk::Device dev_;
+    vk::PhysicalDeviceMemoryProperties memProps_;
+    const vk::AllocationCallbacks *pAllocator_;
+    uint32_t maxMemoryAllocationCount_;
+    vk::DeviceSize nonCoherentAtomSize_;
+    uint32_t nextBlockId_;
+    uint32_t peakDeviceMemoryCount_;
+    std::vector<Pool> pools_;
+    std::unordered_map<VkDeviceMemory, Dedicated> dedicated_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace Memory
+
+#endif  // !MEMORY_H
@@ -68,6 +68,7 @@ struct CreateInfoResources {
     std::vector<vk::PipelineShaderStageCreateInfo> shaderStageInfos;
     std::vector<std::vector<vk::SpecializationMapEntry>> specializationMapEntries;
     std::vector<vk::SpecializationInfo> specializationInfo;
+    std::vector<std::vector<uint8_t>> specializationData;  // For specialization data that has nowhere else to live.
 };
 }  // namespace Pipeline
 
@@ -83,25 +84,38 @@ class NonCopyable {
     NonCopyable &operator=(NonCopyable &&) = delete;
 };
 
+namespace Memory {
+// A range of a vk::DeviceMemory handed out by Memory::Allocator. Resources should be bound at "offset", and if the memory
+// type is host visible "pMappedData" already points at the start of the range (blocks are persistently mapped).
+struct Allocation {
+    vk::DeviceMemory memory;
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = 0;
+    void *pMappedData = nullptr;
+    uint32_t memoryTypeIndex = UINT32_MAX;
+    uint32_t poolIndex = UINT32_MAX;  // UINT32_MAX means a dedicated allocation
+    uint32_t blockId = UINT32_MAX;
+};
+}  // namespace Memory
+
 struct BufferResource {
     vk::Buffer buffer;
-    vk::DeviceMemory memory;
+    Memory::Allocation allocation;
     vk::MemoryRequirements memoryRequirements;
 };
 
 struct ImageResource {
     vk::Format format;
     vk::Image image;
-    vk::DeviceMemory memory;
+    Memory::Allocation allocation;
     vk::ImageView view;
 };
 
+// Command buffers to record a load into. The fences and semaphore are owned by the loading handler's batch.
 struct LoadingResource {
     bool shouldWait = false;
     vk::CommandBuffer graphicsCmd, transferCmd;
     std::vector<BufferResource> stgResources;
-    std::vector<vk::Fence> fences;
-    vk::Semaphore semaphore;
 };
 
 // template <typename T>
@@ -6,8 +6,12 @@
 #ifndef BUFFER_ITEM_H
 #define BUFFER_ITEM_H
 
+#include <algorithm>
 #include <assert.h>
+#include <cstring>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include <vulkan/vulkan.hpp>
 
@@ -37,7 +41,22 @@ class Item {
     virtual ~Item() = default;
 
     const Buffer::Info BUFFER_INFO;
-    bool dirty;
+    bool dirty;  // Every slot needs to be copied.
+    // Ranges of slots [first, last) written since the last update. Only these are copied when "dirty" isn't set.
+    std::vector<std::pair<uint32_t, uint32_t>> dirtySlots;
+
+    inline void setSlotDirty(const uint32_t slot) {
+        assert(slot < BUFFER_INFO.count);
+        // Slots are mostly written in order, so try to extend the previous range first.
+        if (!dirtySlots.empty() && slot >= dirtySlots.back().first && slot <= dirtySlots.back().second)
+            dirtySlots.back().second = std::max(dirtySlots.back().second, slot + 1);
+        else
+            dirtySlots.push_back({slot, slot + 1});
+    }
+
+    // Called by the managers once per frame before anything is recorded. Returns true if the data for "frameIndex"
+    // changed and needs to be copied to the device.
+    virtual bool catchUp(const uint32_t frameIndex) { return false; }
 
    protected:
     /** Virtual inheritance only.
@@ -63,30 +82,62 @@ class DataItem : public virtual Buffer::Item {
     TDATA* pData_;
 };
 
-// This is pretty slow on a bunch of levels, but I'd rather just have it work atm.
+/* Keeps one copy of the data per framebuffer. "data_" is always the latest version, and each slot remembers the
+ *  version it was last written with. Setting the data for every frame only writes the slot of the frame being
+ *  recorded, and bumps the version. The rest of the slots are brought up to date by "catchUp" when their frame comes
+ *  around again. Setting the data for a single frame doesn't change the version since those items are updated by
+ *  each frame anyway.
+ */
 template <typename TDATA>
 class PerFramebufferDataItem : public Buffer::DataItem<TDATA> {
     using TItem = Buffer::DataItem<TDATA>;
 
    public:
-    PerFramebufferDataItem(TDATA* pData) : Buffer::DataItem<TDATA>(pData), data_(*pData) {}
+    PerFramebufferDataItem(TDATA* pData)
+        : Buffer::DataItem<TDATA>(pData),
+          data_(*pData),
+          version_(0),
+          frameIndex_(UINT32_MAX),
+          slotVersions_(Item::BUFFER_INFO.count, 0) {}
+
+    bool catchUp(const uint32_t frameIndex) override {
+        frameIndex_ = frameIndex;
+        if (frameIndex >= Item::BUFFER_INFO.count || slotVersions_[frameIndex] == version_) return false;
+        writeSlot(frameIndex);
+        return true;
+    }
 
    protected:
     void setData(const uint32_t index = UINT32_MAX) override {
         if (index == UINT32_MAX) {
-            for (uint32_t i = 0; i < Item::BUFFER_INFO.count; i++)
-                std::memcpy(PerFramebufferDataItem::getData(i * TItem::BUFFER_INFO.bufferInfo.range), &data_, sizeof(TDATA));
+            version_++;
+            if (frameIndex_ >= Item::BUFFER_INFO.count) {
+                // Either no frame has been recorded yet, or there is only one slot. Write every slot.
+                for (uint32_t i = 0; i < Item::BUFFER_INFO.count; i++) writeSlot(i);
+                Item::dirty = true;
+            } else {
+                writeSlot(frameIndex_);
+                Item::setSlotDirty(frameIndex_);
+            }
         } else {
             assert(index < Item::BUFFER_INFO.count);
-            std::memcpy(PerFramebufferDataItem::getData(index * TItem::BUFFER_INFO.bufferInfo.range), &data_, sizeof(TDATA));
+            writeSlot(index);
+            Item::setSlotDirty(index);
         }
-        Item::dirty = true;
     }
 
     TDATA data_;
 
    private:
     inline void* getData(const vk::DeviceSize offset) { return (((uint8_t*)TItem::pData_) + offset); }
+    inline void writeSlot(const uint32_t index) {
+        std::memcpy(getData(index * TItem::BUFFER_INFO.bufferInfo.range), &data_, sizeof(TDATA));
+        slotVersions_[index] = version_;
+    }
+
+    uint64_t version_;
+    uint32_t frameIndex_;
+    std::vector<uint64_t> slotVersions_;
 };
 
 }  // namespace Buffer
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 #define DIAGNOSE false
@@ -19,6 +20,7 @@
 #include <Common/Helpers.h>
 
 #include "BufferItem.h"
+#include "BufferRing.h"
 #include "Shell.h"
 
 namespace Buffer {
@@ -50,6 +52,12 @@ class Data {
         return (T &)(*(pData_ + offset));
     }
 
+    // Resources are copied around in a std::vector, so the data is freed explicitly instead of in a destructor.
+    inline void destroy() {
+        std::free(pData_);
+        pData_ = nullptr;
+    }
+
    private:
     // TODO: change this to std::array so memory is initialized.
     // As of now all buffer memory copies junk into the device buffer,
@@ -63,27 +71,27 @@ struct Resource {
     Resource(vk::DeviceSize totalSize, vk::DeviceSize alignment)
         : buffer(),
           currentOffset(),
-          memory(),
+          allocation(),
           memoryRequirements(),
-          pMappedData(nullptr),
           data(std::forward<vk::DeviceSize>(totalSize), std::forward<vk::DeviceSize>(alignment)) {}
     vk::Buffer buffer;
     vk::DeviceSize currentOffset;
-    vk::DeviceMemory memory;
+    // Host visible allocations are persistently mapped (see Memory::Allocator).
+    Memory::Allocation allocation;
     vk::MemoryRequirements memoryRequirements;
-    void *pMappedData;
     Buffer::Manager::Data<T> data;
+    // Data index ranges [first, last) written since the last batch was flushed.
+    std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> dirtyRanges;
 };
 
 template <class TBase, class TDerived, template <typename> class TSmartPointer>
 class Base {
    public:
-    /*  Last I checked, forcing a "const maxSize" here is very important unless a proper
-        allocator is written. The mapped memory, and the info objects that are handed out
-        will be invalidated if there is a vector resize operation. So, for now I am just
-        setting a max size, adding asserts that I don't request anything over the original
-        allocation amount, and then recommend just increasing the max size... until I
-        write the allocation code.
+    /*  "maxSize" is the number of items in a single block. When a block fills up another
+        one of the same size is chained onto "resources_" instead of reallocating, so the
+        mapped memory, and the info objects that are handed out are never invalidated. An
+        item's data has to fit in one block, so the block size only needs to be larger than
+        the biggest single item (plus whatever keeps the number of blocks reasonable).
     */
     Base(const std::string &&name, const vk::DeviceSize &&maxSize, const bool &&keepMapped,
          const vk::BufferUsageFlags &&usage, const vk::MemoryPropertyFlags &&properties,
@@ -95,7 +103,8 @@ class Base {
           PROPERTIES(properties),
           MODE(sharingMode),
           FLAGS(flags),
-          alignment_(sizeof(typename TDerived::DATA)) {}
+          alignment_(sizeof(typename TDerived::DATA)),
+          properties_(properties) {}
 
     const std::string NAME;
     const vk::DeviceSize MAX_SIZE;
@@ -107,6 +116,7 @@ class Base {
 
     virtual void init(const Context &ctx, std::vector<uint32_t> queueFamilyIndices = {}) {
         reset(ctx);
+        pCtx_ = &ctx;
         queueFamilyIndices_ = queueFamilyIndices;
         createBuffer(ctx);
     }
@@ -121,7 +131,6 @@ class Base {
 
     template <typename TCreateInfo>
     void insert(const vk::Device &dev, TCreateInfo *pCreateInfo) {
-        assert(pItems.size() < MAX_SIZE);
         auto info = fill(dev, std::vector<typename TDerived::DATA>(pCreateInfo->dataCount), pCreateInfo->countInRange);
         diagnose(info);
         pItems.emplace_back(new TDerived(std::move(info), get(info), pCreateInfo));
@@ -130,7 +139,6 @@ class Base {
 
     TDerived *insert(const vk::Device &dev, bool update = true,
                      const std::vector<typename TDerived::DATA> &data = std::vector<typename TDerived::DATA>(1)) {
-        assert(pItems.size() < MAX_SIZE);
         auto info = fill(dev, data, false);
         diagnose(info);
         pItems.emplace_back(new TDerived(std::move(info), get(info)));
@@ -138,15 +146,101 @@ class Base {
         return static_cast<TDerived *>(pItems.back().get());
     }
 
+    /* Copies the item's dirty slots. If "index" is set only that slot is copied, but only if the item has something
+     *  dirty. Without it, an item marked "dirty" copies every slot, and otherwise just its "dirtySlots" are copied.
+     */
     void updateData(const vk::Device &dev, const Buffer::Info &info, const int index = -1) {
-        if (pItems[info.itemOffset]->dirty) {
-            updateMappedMemory(dev, info, index);
-            pItems[info.itemOffset]->dirty = false;
+        auto &pItem = pItems[info.itemOffset];
+        if (!pItem->dirty && pItem->dirtySlots.empty()) return;
+        if (index != -1) {
+            copySlots(dev, info, static_cast<uint32_t>(index), static_cast<uint32_t>(index) + 1);
+        } else if (pItem->dirty) {
+            copySlots(dev, info, 0, info.count);
+        } else {
+            for (const auto &slots : pItem->dirtySlots) copySlots(dev, info, slots.first, slots.second);
+        }
+        pItem->dirty = false;
+        pItem->dirtySlots.clear();
+    }
+
+    // Bring each item's copy of the data for "frameIndex" up to date. Should be called once per frame before
+    // recording. See "Buffer::PerFramebufferDataItem".
+    void updateFrame(const vk::Device &dev, const uint32_t frameIndex) {
+        for (auto &pItem : pItems) {
+            if (pItem->catchUp(frameIndex)) copySlots(dev, pItem->BUFFER_INFO, frameIndex, frameIndex + 1);
+        }
+    }
+
+    /*  Updates between "beginBatch" and "endBatch" only record the dirty range. "endBatch"
+        coalesces adjacent ranges so a frame's worth of item updates turns into a copy (and
+        flush) per contiguous span. Device local resources are copied out of "pRing" with
+        one "copyBuffer" per resource recorded into "cmd". If "pRing" runs out of room the
+        rest stays dirty for the next batch, so the device can see a partial update for a
+        frame instead of the application stopping.
+    */
+    inline void beginBatch() { batching_ = true; }
+    void endBatch(Buffer::Ring *pRing = nullptr, const vk::CommandBuffer &cmd = {}) {
+        batching_ = false;
+        std::vector<vk::MappedMemoryRange> flushRanges;
+        std::vector<vk::BufferCopy> regions;
+        bool copied = false;
+
+        for (auto &resource : resources_) {
+            if (resource.dirtyRanges.empty()) continue;
+            coalesce(resource.dirtyRanges);
+
+            if (resource.allocation.pMappedData) {
+                for (const auto &[first, last] : resource.dirtyRanges) {
+                    auto offset = first * alignment_, size = (last - first) * alignment_;
+                    memcpy(static_cast<uint8_t *>(resource.allocation.pMappedData) + offset, &resource.data.get(first),
+                           static_cast<size_t>(size));
+                    if (!pCtx_->pMemAllocator->isCoherent(resource.allocation))
+                        flushRanges.push_back(pCtx_->pMemAllocator->getFlushRange(resource.allocation, offset, size));
+                }
+                resource.dirtyRanges.clear();
+            } else {
+                assert(pRing && cmd && "Device local buffer managers need a staging ring to update");
+                regions.clear();
+                auto it = resource.dirtyRanges.begin();
+                while (it != resource.dirtyRanges.end()) {
+                    auto &[first, last] = *it;
+                    // Halve the count until it fits in what is left of the ring.
+                    auto count = last - first;
+                    Buffer::Ring::Range range;
+                    while (count && !pRing->reserve(count * alignment_, alignment_, range)) count /= 2;
+                    if (!count) break;
+                    memcpy(range.pData, &resource.data.get(first), static_cast<size_t>(count * alignment_));
+                    regions.push_back({range.offset, first * alignment_, count * alignment_});
+                    first += count;
+                    if (first == last) ++it;
+                }
+                if (regions.size()) {
+                    // The device could still be reading the old data for an earlier frame.
+                    if (!copied)
+                        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+                                            vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {});
+                    cmd.copyBuffer(pRing->getBuffer(), resource.buffer, regions);
+                    copied = true;
+                }
+                resource.dirtyRanges.erase(resource.dirtyRanges.begin(), it);
+            }
+        }
+
+        if (!flushRanges.empty()) pCtx_->pMemAllocator->flush(flushRanges);
+        if (copied) {
+            pRing->flush(*pCtx_);
+            vk::MemoryBarrier barrier = {vk::AccessFlagBits::eTransferWrite,
+                                         vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead |
+                                             vk::AccessFlagBits::eVertexAttributeRead};
+            cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {},
+                                {barrier}, {}, {});
         }
     }
 
     TDerived &getTypedItem(const uint32_t &index) { return std::ref(*static_cast<TDerived *>(pItems.at(index).get())); }
 
+    inline uint32_t getBlockCount() const { return static_cast<uint32_t>(resources_.size()); }
+
     void destroy(const Context &ctx) {
         reset(ctx);
         pItems.clear();
@@ -158,16 +252,16 @@ class Base {
     virtual void setInfo(Buffer::Info &info){};
 
     Buffer::Info fill(const vk::Device &dev, const std::vector<typename TDerived::DATA> data, const bool countInRange) {
-        assert(resources_.size() && "Did you initialize the manager?");
+        assert(pCtx_ != nullptr && resources_.size() && "Did you initialize the manager?");
+        assert(!data.empty() && "\"data\" cannot be empty.");
+        assert(data.size() <= MAX_SIZE && "An item's data has to fit in a single block. Increase the block size.");
+
+        // Chain a new block if the item doesn't fit in the remainder of the current one. The
+        // remainder is wasted, but nothing already handed out moves.
+        if (((resources_.back().currentOffset + data.size()) * alignment_) > resources_.back().data.TOTAL_SIZE)
+            createBuffer(*pCtx_);
         auto &resource = resources_.back();
 
-        bool isValid = true;
-        isValid = !data.empty();
-        assert(isValid && "\"data\" cannot be empty.");
-        isValid &= ((resource.currentOffset + data.size()) * alignment_) <= resource.data.TOTAL_SIZE;
-        assert(isValid && "Either increase the max size, or figure out how to grow the \"resources_\".");
-        // TODO: other validation? also, does above make any sense?
-
         Buffer::Info info = {};
         info.bufferInfo.buffer = resource.buffer;
         info.bufferInfo.range = countInRange ? alignment_ * data.size() : alignment_;
@@ -193,50 +287,82 @@ class Base {
 
     vk::DeviceSize alignment_;
 
-   private:
-    // TODO: change the caller so that all the memory can be updated at once.
-    void updateMappedMemory(const vk::Device &dev, const Buffer::Info &info, const int index) {
-        auto &resource = resources_[info.resourcesOffset];
+    // What the blocks are allocated with. Starts out as PROPERTIES. A derived class can change it before "init".
+    vk::MemoryPropertyFlags properties_;
 
-        // If the index was set offset into both memory pointers.
-        auto memoryOffset = info.memoryOffset + ((index == -1) ? 0 : (index * resource.data.ALIGNMENT));
-        auto dataOffset = info.dataOffset + ((index == -1) ? 0 : index);
+   private:
+    inline bool isHostVisible() const {
+        return static_cast<bool>(properties_ & vk::MemoryPropertyFlagBits::eHostVisible);
+    }
 
-        auto pData = static_cast<uint8_t *>(resource.pMappedData) + memoryOffset;
-        // If index is not set copy the entire range for the item.
-        vk::DeviceSize range = (index == -1) ? (info.count * resource.data.ALIGNMENT) : resource.data.ALIGNMENT;
+    // Copies the item's slots [firstSlot, lastSlot). Device local resources can only be written through a batch.
+    void copySlots(const vk::Device &dev, const Buffer::Info &info, const uint32_t firstSlot, const uint32_t lastSlot) {
+        assert(firstSlot < lastSlot && lastSlot <= info.count);
+        if (batching_ || !isHostVisible())
+            markDirty(info, firstSlot, lastSlot);
+        else
+            updateMappedMemory(dev, info, firstSlot, lastSlot);
+    }
 
-        if (KEEP_MAPPED) {
-            memcpy(pData, &resource.data.get(dataOffset), range);
-        } else {
-            // TODO: Only map the region that is being copied???
-            resource.pMappedData = dev.mapMemory(resource.memory, 0, resource.memoryRequirements.size);
+    void markDirty(const Buffer::Info &info, const uint32_t firstSlot, const uint32_t lastSlot) {
+        auto first = info.dataOffset + firstSlot;
+        auto last = info.dataOffset + lastSlot;
+        auto &dirtyRanges = resources_[info.resourcesOffset].dirtyRanges;
+        // Most updates are in item order, so try to extend the previous range first.
+        if (!dirtyRanges.empty() && dirtyRanges.back().second == first)
+            dirtyRanges.back().second = last;
+        else
+            dirtyRanges.push_back({first, last});
+    }
 
-            memcpy(pData, &resource.data.get(dataOffset), range);
-            dev.unmapMemory(resource.memory);
+    static void coalesce(std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> &ranges) {
+        std::sort(ranges.begin(), ranges.end());
+        size_t count = 0;
+        for (size_t i = 1; i < ranges.size(); i++) {
+            if (ranges[i].first <= ranges[count].second)
+                ranges[count].second = std::max(ranges[count].second, ranges[i].second);
+            else
+                ranges[++count] = ranges[i];
         }
+        ranges.resize(count + 1);
+    }
+
+    void updateMappedMemory(const vk::Device &dev, const Buffer::Info &info, const uint32_t firstSlot,
+                            const uint32_t lastSlot) {
+        auto &resource = resources_[info.resourcesOffset];
+
+        // Offset into both memory pointers by the first slot.
+        auto memoryOffset = info.memoryOffset + (firstSlot * resource.data.ALIGNMENT);
+        auto dataOffset = info.dataOffset + firstSlot;
+
+        auto pData = static_cast<uint8_t *>(resource.allocation.pMappedData) + memoryOffset;
+        vk::DeviceSize range = (lastSlot - firstSlot) * resource.data.ALIGNMENT;
+
+        // The allocator keeps host visible blocks mapped, so KEEP_MAPPED no longer means a map/unmap per update.
+        memcpy(pData, &resource.data.get(dataOffset), range);
+        pCtx_->pMemAllocator->flush(resource.allocation, memoryOffset, range);
     }
 
     void reset(const Context &ctx) {
         for (auto &resource : resources_) {
-            if (KEEP_MAPPED) ctx.dev.unmapMemory(resource.memory);
             ctx.dev.destroyBuffer(resource.buffer, ctx.pAllocator);
-            ctx.dev.freeMemory(resource.memory, ctx.pAllocator);
+            ctx.pMemAllocator->free(resource.allocation);
+            resource.data.destroy();
         }
+        resources_.clear();
     }
 
     void createBuffer(const Context &ctx) {
         resources_.push_back({MAX_SIZE, alignment_});
         auto &resource = resources_.back();
 
-        // TODO: I FORGOT TO USE A STAGING BUFFER HERE TO SPEED THIS UP!!!
-
         // CREATE BUFFER
 
         vk::BufferCreateInfo createInfo = {};
         createInfo.flags = FLAGS;
         createInfo.size = MAX_SIZE * alignment_;
-        createInfo.usage = USAGE;
+        // Device local resources are written from the staging ring in "endBatch".
+        createInfo.usage = isHostVisible() ? USAGE : (USAGE | vk::BufferUsageFlagBits::eTransferDst);
         createInfo.sharingMode = vk::SharingMode::eExclusive;
         createInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices_.size());
         createInfo.pQueueFamilyIndices = queueFamilyIndices_.data();
@@ -248,31 +374,20 @@ class Base {
         assert(resource.memoryRequirements.size == createInfo.size &&
                "Figure out how to deal with this! (\"range\" of add)");
 
-        vk::MemoryAllocateInfo allocInfo;
-        allocInfo.setAllocationSize(resource.memoryRequirements.size);
-        auto pass = helpers::getMemoryType(ctx.memProps, resource.memoryRequirements.memoryTypeBits, PROPERTIES,
-                                           &allocInfo.memoryTypeIndex);
-        assert(pass && "No mappable, coherent memory");
-
-        resource.memory = ctx.dev.allocateMemory(allocInfo, ctx.pAllocator);
-
-        // MAP MEMORY
-
-        // TODO: why doesn't below work WWWWTTTTTTFFFFFFFFFFF!!!!!!
-        // auto pData = resource.data.data();
-        //  resource.pMappedData = ctx.dev.mapMemory(resource.memory, 0, memReqs.size);
-        resource.pMappedData = ctx.dev.mapMemory(resource.memory, 0, resource.memoryRequirements.size);
+        // ALLOCATE & BIND MEMORY
+        resource.allocation = ctx.pMemAllocator->allocateBuffer(resource.buffer, properties_);
 
         /*  Copying all the memory here is probably a redunant init step. The way its written now,
             each item will do a memcpy if dirty after creation. Maybe just make that a necessary step,
             and leave the rest of the buffer garbage.
         */
-        memcpy(resource.pMappedData, resource.data.data(), static_cast<size_t>(resource.memoryRequirements.size));
-        if (!KEEP_MAPPED) ctx.dev.unmapMemory(resource.memory);
-
-        // BIND MEMORY
+        if (isHostVisible()) {
+            assert(resource.allocation.pMappedData && "No mappable memory");
+            memcpy(resource.allocation.pMappedData, resource.data.data(),
+                   static_cast<size_t>(resource.memoryRequirements.size));
+            ctx.pMemAllocator->flush(resource.allocation);
+        }
 
-        ctx.dev.bindBufferMemory(resource.buffer, resource.memory, 0);
         std::string markerName = NAME + " block (" + std::to_string(resources_.size()) + ")";
         // ctx.dbg.setMarkerName(resource.buffer, markerName.c_str());
         // ctx.dbg.setMarkerTag(resource.buffer, markerName.c_str(), tag);
@@ -282,6 +397,9 @@ class Base {
         return &resources_[info.resourcesOffset].data.get(info.dataOffset);
     }
 
+    // Needed to chain blocks from "fill". The context outlives all of the managers.
+    const Context *pCtx_ = nullptr;
+    bool batching_ = false;
     std::vector<uint32_t> queueFamilyIndices_;
     std::vector<Manager::Resource<typename TDerived::DATA>> resources_;
 };
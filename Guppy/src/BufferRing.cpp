@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "BufferRing.h"
+
+#include <algorithm>
+
+#include <Common/Helpers.h>
+
+namespace Buffer {
+
+Ring::Ring(const std::string &&name, const vk::DeviceSize frameSize, const vk::BufferUsageFlags usage)
+    : NAME(name),
+      FRAME_SIZE(frameSize),
+      USAGE(usage),
+      buffer_(),
+      allocation_(),
+      minAlignment_(1),
+      frameCount_(0),
+      frameIndex_(0),
+      head_(0),
+      highWaterMark_(0) {}
+
+void Ring::init(const Context &ctx) {
+    destroy(ctx);
+    assert(ctx.imageCount);
+    frameCount_ = ctx.imageCount;
+
+    const auto &limits = ctx.physicalDevProps[ctx.physicalDevIndex].properties.limits;
+    minAlignment_ = 1;
+    if (USAGE & vk::BufferUsageFlagBits::eUniformBuffer)
+        minAlignment_ = std::max(minAlignment_, limits.minUniformBufferOffsetAlignment);
+    if (USAGE & vk::BufferUsageFlagBits::eStorageBuffer)
+        minAlignment_ = std::max(minAlignment_, limits.minStorageBufferOffsetAlignment);
+    assert(FRAME_SIZE % minAlignment_ == 0);
+
+    helpers::createBuffer(ctx.dev, *ctx.pMemAllocator, FRAME_SIZE * frameCount_, USAGE,
+                          vk::MemoryPropertyFlagBits::eHostVisible, buffer_, allocation_, ctx.pAllocator);
+    assert(allocation_.pMappedData);
+}
+
+void Ring::beginFrame(const uint32_t frameIndex) {
+    assert(frameIndex < frameCount_);
+    frameIndex_ = frameIndex;
+    head_ = 0;
+}
+
+bool Ring::reserve(const vk::DeviceSize size, const vk::DeviceSize alignment, Range &range) {
+    assert(buffer_ && "Did you initialize the ring?");
+    const auto align = std::max(alignment, minAlignment_);
+    auto offset = ((head_ + align - 1) / align) * align;
+    if (offset + size > FRAME_SIZE) return false;
+    head_ = offset + size;
+    highWaterMark_ = std::max(highWaterMark_, head_);
+
+    range.buffer = buffer_;
+    range.offset = (FRAME_SIZE * frameIndex_) + offset;
+    range.size = size;
+    range.pData = static_cast<uint8_t *>(allocation_.pMappedData) + range.offset;
+    return true;
+}
+
+void Ring::flush(const Context &ctx) const {
+    if (head_) ctx.pMemAllocator->flush(allocation_, FRAME_SIZE * frameIndex_, head_);
+}
+
+void Ring::destroy(const Context &ctx) {
+    if (buffer_) ctx.dev.destroyBuffer(buffer_, ctx.pAllocator);
+    buffer_ = vk::Buffer{};
+    if (ctx.pMemAllocator) ctx.pMemAllocator->free(allocation_);
+    frameCount_ = frameIndex_ = 0;
+    head_ = highWaterMark_ = 0;
+}
+
+}  // namespace Buffer
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef BUFFER_RING_H
+#define BUFFER_RING_H
+
+#include <cstring>
+#include <string>
+#include <vulkan/vulkan.hpp>
+
+#include <Common/Context.h>
+#include <Common/Types.h>
+
+namespace Buffer {
+
+/* Persistently mapped buffer split into one region per swapchain image. Each frame bump allocates out of its own
+ *  region, and the region is rewound in "beginFrame". The owner has to call "beginFrame" after the frame fence has been
+ *  waited on, so nothing in a region can still be in use by the device when it is rewound.
+ *
+ *  Used for staging (eTransferSrc) by "Mesh::Handler", and for streaming transient uniform/storage data by
+ *  "Uniform::Handler", which is rewound by "RenderPass::Manager::acquireBackBuffer". For the latter the ranges are
+ *  aligned to the device's min offset alignment, and can be addressed by a dynamic descriptor pointed at "getBuffer()"
+ *  using "getDynamicOffset".
+ */
+class Ring : NonCopyable {
+   public:
+    struct Range {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        void *pData = nullptr;
+    };
+
+    Ring(const std::string &&name, const vk::DeviceSize frameSize, const vk::BufferUsageFlags usage);
+
+    const std::string NAME;
+    const vk::DeviceSize FRAME_SIZE;
+    const vk::BufferUsageFlags USAGE;
+
+    void init(const Context &ctx);
+    void beginFrame(const uint32_t frameIndex);
+    // Returns false if the current frame's region is full.
+    bool reserve(const vk::DeviceSize size, const vk::DeviceSize alignment, Range &range);
+    // Reserve and write "data" in one step.
+    template <typename T>
+    bool write(const T &data, Range &range) {
+        if (!reserve(sizeof(T), 1, range)) return false;
+        std::memcpy(range.pData, &data, sizeof(T));
+        return true;
+    }
+    // Make the writes for the current frame visible to the device (only does something for non-coherent memory).
+    void flush(const Context &ctx) const;
+    void destroy(const Context &ctx);
+
+    inline const vk::Buffer &getBuffer() const { return buffer_; }
+    inline uint32_t getDynamicOffset(const Range &range) const { return static_cast<uint32_t>(range.offset); }
+    // The descriptor info to use with a dynamic descriptor. "range" should be the largest item written.
+    inline vk::DescriptorBufferInfo getDescriptorInfo(const vk::DeviceSize range) const { return {buffer_, 0, range}; }
+    inline vk::DeviceSize getHighWaterMark() const { return highWaterMark_; }
+
+   private:
+    vk::Buffer buffer_;
+    Memory::Allocation allocation_;
+    vk::DeviceSize minAlignment_;
+    uint32_t frameCount_;
+    uint32_t frameIndex_;
+    vk::DeviceSize head_;
+    vk::DeviceSize highWaterMark_;
+};
+
+}  // namespace Buffer
+
+#endif  // !BUFFER_RING_H
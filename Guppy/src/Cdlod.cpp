@@ -52,13 +52,27 @@ Base::Base(const Buffer::Info&& info, DATA* pData)
 }  // namespace Cdlod
 }  // namespace Uniform
 
+// UNIFORM DYNAMIC
+namespace UniformDynamic {
+namespace Cdlod {
+namespace Grid {
+Base::Base(const Buffer::Info&& info)
+    : Buffer::Item(std::forward<const Buffer::Info>(info)),  //
+      Descriptor::Base(UNIFORM_DYNAMIC::CDLOD_GRID) {}
+}  // namespace Grid
+}  // namespace Cdlod
+}  // namespace UniformDynamic
+
 // DESCRIPTOR SET
 namespace Descriptor {
 namespace Set {
 const CreateInfo CDLOD_DEFAULT_CREATE_INFO = {
     DESCRIPTOR_SET::CDLOD_DEFAULT,
     "_DS_CDLOD",
-    {{{0, 0}, {UNIFORM::CDLOD_QUAD_TREE}}},
+    {
+        {{0, 0}, {UNIFORM::CDLOD_QUAD_TREE}},
+        {{1, 0}, {UNIFORM_DYNAMIC::CDLOD_GRID}},
+    },
 };
 }  // namespace Set
 }  // namespace Descriptor
@@ -107,8 +121,6 @@ const Pipeline::CreateInfo WF_CREATE_INFO = {
         {DESCRIPTOR_SET::UNIFORM_DEFAULT, (vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)},
         {DESCRIPTOR_SET::CDLOD_DEFAULT, (vk::ShaderStageFlagBits::eVertex)},
     },
-    {},
-    {PUSH_CONSTANT::CDLOD},
 };
 Wireframe::Wireframe(Handler& handler) : MRTColor(handler, &WF_CREATE_INFO) {}
 void Wireframe::getInputAssemblyInfoResources(CreateInfoResources& createInfoRes) {
@@ -132,8 +144,6 @@ const Pipeline::CreateInfo TEX_CREATE_INFO = {
         {DESCRIPTOR_SET::SAMPLER_DEFAULT, vk::ShaderStageFlagBits::eFragment},
         {DESCRIPTOR_SET::CDLOD_DEFAULT, (vk::ShaderStageFlagBits::eVertex)},
     },
-    {},
-    {PUSH_CONSTANT::CDLOD},
 };
 Texture::Texture(Handler& handler) : MRTTexture(handler, &TEX_CREATE_INFO) {}
 void Texture::getInputAssemblyInfoResources(CreateInfoResources& createInfoRes) {
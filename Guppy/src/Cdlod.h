@@ -41,6 +41,22 @@ class Base : public Descriptor::Base, public Buffer::DataItem<DATA> {
 }  // namespace Cdlod
 }  // namespace Uniform
 
+// UNIFORM DYNAMIC
+namespace UniformDynamic {
+namespace Cdlod {
+namespace Grid {
+using DATA = CDLODRendererBatchInfo::PerDrawData;
+/* Points at the uniform handler's transient stream instead of a buffer of its own. Every draw writes its data to the
+ *  stream, and rebinds the set with the offset of its copy (see "Cdlod::Renderer::Debug::bindDescSetData").
+ */
+class Base : public Descriptor::Base {
+   public:
+    Base(const Buffer::Info&& info);
+};
+}  // namespace Grid
+}  // namespace Cdlod
+}  // namespace UniformDynamic
+
 // PUSH CONSTANT
 namespace Cdlod {
 using PushConstant = CDLODRendererBatchInfo::PerDrawData;
@@ -5,6 +5,9 @@
 
 #include "CdlodRenderer.h"
 
+#include <utility>
+#include <vector>
+
 #include <Common/Helpers.h>
 
 #include "Box.h"
@@ -13,6 +16,7 @@
 #include "MeshConstants.h"
 #include "RenderPassManager.h"
 // HANDLERS
+#include "CommandHandler.h"
 #include "DescriptorHandler.h"
 #include "LoadingHandler.h"
 #include "MaterialHandler.h"
@@ -97,6 +101,7 @@ void Base::onInit() {
     for (auto& gridMesh : m_gridMeshes) {
         auto pLdgRes = handler().loadingHandler().createLoadingResources();
         gridMesh.CreateBuffers(*pLdgRes.get());
+        // No callback. The loading commands are submitted ahead of the first frame that draws the grid.
         handler().loadingHandler().loadSubmit(std::move(pLdgRes));
     }
 
@@ -380,7 +385,7 @@ void Base::renderTerrain(const CDLODQuadTree::LODSelection& cdlodSelection,
         //    }
         //}
 
-        bindDescSetData(cmd, pPipelineBindData, i);  // CH
+        bindDescSetData(cmd, pPipelineBindData, i, cdlodBatchInfo.renderData);  // CH
 
         // V(device->SetPixelShader(*cdlodBatchInfo.PixelShader));
         // m_dlodRenderer.Render(cdlodBatchInfo, &stepStats);
@@ -546,13 +551,16 @@ bool Debug::shouldDraw(const PIPELINE type) const {
 }
 
 void Debug::bindDescSetData(const vk::CommandBuffer& cmd, const std::shared_ptr<Pipeline::BindData>& pPipelineBindData,
-                            const int lodLevel) const {
+                            const int lodLevel, CDLODRendererBatchInfo::RenderData& renderData) const {
+    auto& uniformHandler = handler().uniformHandler();
+    Descriptor::Base* pGrid = &uniformHandler.getCdlodGrid();
     Descriptor::Set::bindDataMap descSetBindDataMap;
     if (pPipelineBindData->type == PIPELINE{GRAPHICS::CDLOD_WF_DEFERRED}) {
         auto debugLodLevel = lodLevel % 4;
-        handler().descriptorHandler().getBindData(pPipelineBindData->type, descSetBindDataMap, {pMaterials_[debugLodLevel]});
+        handler().descriptorHandler().getBindData(pPipelineBindData->type, descSetBindDataMap,
+                                                  {pMaterials_[debugLodLevel], pGrid});
     } else if (pPipelineBindData->type == PIPELINE{GRAPHICS::CDLOD_TEX_DEFERRED}) {
-        handler().descriptorHandler().getBindData(pPipelineBindData->type, descSetBindDataMap, {pMaterials_[4]});
+        handler().descriptorHandler().getBindData(pPipelineBindData->type, descSetBindDataMap, {pMaterials_[4], pGrid});
     } else {
         assert(false);
     }
@@ -562,6 +570,23 @@ void Debug::bindDescSetData(const vk::CommandBuffer& cmd, const std::shared_ptr<
                                      handler().passHandler().renderPassMgr().getFrameIndex());
     cmd.bindDescriptorSets(pPipelineBindData->bindPoint, pPipelineBindData->layout, descSetBindData.firstSet,
                            descSetBindData.descriptorSets[setIndex], descSetBindData.dynamicOffsets);
+
+    /* The grid data for each draw is written to the uniform stream, and only the CDLOD set is rebound with the offset
+     *  of the copy. It is the last set in both pipelines, and the grid is its only dynamic descriptor.
+     */
+    const auto cdlodSetIndex =
+        descSetBindData.firstSet + static_cast<uint32_t>(descSetBindData.descriptorSets[setIndex].size()) - 1;
+    renderData.setPerDrawData = [&uniformHandler, &cmd, pPipelineBindData, cdlodSetIndex,
+                                 cdlodSet = descSetBindData.descriptorSets[setIndex].back()](
+                                    const CDLODRendererBatchInfo::PerDrawData& perDrawData) {
+        Buffer::Ring::Range range;
+        if (!uniformHandler.stream().write(perDrawData, range)) {
+            assert(false && "The uniform stream is full. Increase Uniform::STREAM_FRAME_SIZE.");
+            exit(EXIT_FAILURE);
+        }
+        cmd.bindDescriptorSets(pPipelineBindData->bindPoint, pPipelineBindData->layout, cdlodSetIndex, cdlodSet,
+                               uniformHandler.stream().getDynamicOffset(range));
+    };
 }
 
 void Debug::setGlobalShaderSettings() {
@@ -580,11 +605,7 @@ CDLODRenderer::PerQuadTreeData& Debug::getPerQuadTreeData() {
 
 void Debug::renderDebug(const CDLODQuadTree::LODSelection& cdlodSelection) {
     if (useDebugBoxes_) {
-        log("\n");
-        log("*************************************************************************************\n");
-        log("**     Debug View (frame count: %d)\n", handler().game().getFrameCount());
-        log("*************************************************************************************\n");
-        debugResetBoxes();
+        std::vector<std::pair<int, AABB>> boxes;
         // const auto l = [](glm::vec3 t, AABB& aabb) {
         //    aabb.Min.x += t.x;
         //    aabb.Max.x += t.x;
@@ -621,7 +642,7 @@ void Debug::renderDebug(const CDLODQuadTree::LODSelection& cdlodSelection) {
             boundingBox.Expand(-0.003f);
             if (drawFull) {
                 // GetCanvas3D()->DrawBox(boundingBox.Min, boundingBox.Max, penColor);
-                debugAddBox(lodLevel, boundingBox);
+                boxes.push_back({lodLevel, boundingBox});
             } else {
                 float midX = boundingBox.Center().x;
                 float midY = boundingBox.Center().y;
@@ -632,7 +653,7 @@ void Debug::renderDebug(const CDLODQuadTree::LODSelection& cdlodSelection) {
                     bbSub.Max.y = midY;
                     bbSub.Expand(-0.002f);
                     // GetCanvas3D()->DrawBox(bbSub.Min, bbSub.Max, penColor);
-                    debugAddBox(lodLevel, boundingBox);
+                    boxes.push_back({lodLevel, boundingBox});
                 }
                 if (nodeSel.TR) {
                     AABB bbSub = boundingBox;
@@ -640,7 +661,7 @@ void Debug::renderDebug(const CDLODQuadTree::LODSelection& cdlodSelection) {
                     bbSub.Max.y = midY;
                     bbSub.Expand(-0.002f);
                     // GetCanvas3D()->DrawBox(bbSub.Min, bbSub.Max, penColor);
-                    debugAddBox(lodLevel, boundingBox);
+                    boxes.push_back({lodLevel, boundingBox});
                 }
                 if (nodeSel.BL) {
                     AABB bbSub = boundingBox;
@@ -648,7 +669,7 @@ void Debug::renderDebug(const CDLODQuadTree::LODSelection& cdlodSelection) {
                     bbSub.Min.y = midY;
                     bbSub.Expand(-0.002f);
                     // GetCanvas3D()->DrawBox(bbSub.Min, bbSub.Max, penColor);
-                    debugAddBox(lodLevel, boundingBox);
+                    boxes.push_back({lodLevel, boundingBox});
                 }
                 if (nodeSel.BR) {
                     AABB bbSub = boundingBox;
@@ -656,12 +677,22 @@ void Debug::renderDebug(const CDLODQuadTree::LODSelection& cdlodSelection) {
                     bbSub.Min.y = midY;
                     bbSub.Expand(-0.002f);
                     // GetCanvas3D()->DrawBox(bbSub.Min, bbSub.Max, penColor);
-                    debugAddBox(lodLevel, boundingBox);
+                    boxes.push_back({lodLevel, boundingBox});
                 }
             }
         }
-        debugUpdateBoxes();
-        log("*************************************************************************************\n");
+
+        // This runs while the workers record, and they draw the box meshes, so change the boxes once they are done.
+        handler().commandHandler().afterWorkers([this, boxes = std::move(boxes)]() {
+            log("\n");
+            log("*************************************************************************************\n");
+            log("**     Debug View (frame count: %d)\n", handler().game().getFrameCount());
+            log("*************************************************************************************\n");
+            debugResetBoxes();
+            for (const auto& [lodLevel, boundingBox] : boxes) debugAddBox(lodLevel, boundingBox);
+            debugUpdateBoxes();
+            log("*************************************************************************************\n");
+        });
     }
 }
 
@@ -90,8 +90,9 @@ class Base : public Handlee<Scene::Handler>, public CDLODRenderer {
     virtual const Settings* getSettings() const = 0;
     virtual const IHeightmapSource* getHeightmap() const = 0;
     virtual const MapDimensions* getMapDimensions() const = 0;
+    // Can set "renderData.setPerDrawData" to get the data for each draw instead of having it pushed as constants.
     virtual void bindDescSetData(const vk::CommandBuffer& cmd, const std::shared_ptr<Pipeline::BindData>& pPipelineBindData,
-                                 const int lodLevel) const = 0;
+                                 const int lodLevel, CDLODRendererBatchInfo::RenderData& renderData) const = 0;
     virtual void setGlobalShaderSettings() = 0;
     virtual PerQuadTreeData& getPerQuadTreeData() = 0;
 
@@ -170,7 +171,7 @@ class Debug : public Base {
     const IHeightmapSource* getHeightmap() const override { return &dbgHeightmap_; }
     const MapDimensions* getMapDimensions() const override { return &dbgHeightmap_.mapDims; }
     void bindDescSetData(const vk::CommandBuffer& cmd, const std::shared_ptr<Pipeline::BindData>& pPipelineBindData,
-                         const int lodLevel) const override;
+                         const int lodLevel, CDLODRendererBatchInfo::RenderData& renderData) const override;
     void setGlobalShaderSettings() override;
     PerQuadTreeData& getPerQuadTreeData() override;
 
@@ -12,7 +12,13 @@
 #include "Constants.h"
 #include "Shell.h"
 
-Command::Handler::Handler(Game* pGame) : Game::Handler(pGame) {}
+Command::Handler::Handler(Game* pGame)
+    : Game::Handler(pGame),
+      pWorkerFunc_(nullptr),
+      workerRun_(0),
+      workersBusy_(0),
+      workersStopping_(false),
+      workersRunning_(false) {}
 
 void Command::Handler::init() {
     reset();
@@ -28,10 +34,18 @@ void Command::Handler::init() {
         // TODO: Begin recording the default command buffers???
         beginCmd(cmds_[queueFamilyIndex]);
     };
+
+    // WORKERS
+    workerPools_.resize(1);
+    createCmdPool(graphicsIndex(), workerPools_.front());
 }
 
 void Command::Handler::reset() {
     // TODO: maybe wait for idle???
+    // workers (their pools free whatever command buffers are left in them)
+    stopWorkers();
+    for (auto& pool : workerPools_) shell().context().dev.destroyCommandPool(pool, shell().context().pAllocator);
+    workerPools_.clear();
     auto uniqueQueueFamilies = getUniqueQueueFamilies();
     // owned command buffers
     for (const auto& queueFamilyIndex : uniqueQueueFamilies) {
@@ -146,3 +160,103 @@ void Command::Handler::beginCmd(const vk::CommandBuffer& cmd,
     };
     cmd.begin(beginInfo);
 }
+
+void Command::Handler::startWorkers(const uint32_t count) {
+    assert(workerThreads_.empty() && workerPools_.size() == 1);
+
+    // POOLS
+    while (workerPools_.size() < count) {
+        workerPools_.push_back({});
+        createCmdPool(graphicsIndex(), workerPools_.back());
+    }
+
+    // THREADS
+    uint64_t run;
+    {
+        std::lock_guard<std::mutex> lock(workerMutex_);
+        workersStopping_ = false;
+        run = workerRun_;
+    }
+    // The first run is passed in, so a "runWorkers" that happens before a thread gets going is not missed.
+    for (uint32_t worker = 1; worker < getWorkerCount(); worker++)
+        workerThreads_.emplace_back(&Command::Handler::workerLoop, this, worker, run);
+}
+
+void Command::Handler::stopWorkers() {
+    if (workerThreads_.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(workerMutex_);
+        workersStopping_ = true;
+    }
+    workerStartCv_.notify_all();
+    for (auto& thread : workerThreads_) thread.join();
+    workerThreads_.clear();
+}
+
+void Command::Handler::runWorkers(const std::function<void(const uint32_t)>& func) {
+    assert(!workersRunning_ && "\"runWorkers\" cannot be nested");
+
+    // No threads means the pools are all used from here, one after the other.
+    if (workerThreads_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(workerMutex_);
+            workersRunning_ = true;
+        }
+        for (uint32_t worker = 0; worker < getWorkerCount(); worker++) func(worker);
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(workerMutex_);
+            pWorkerFunc_ = &func;
+            workersBusy_ = static_cast<uint32_t>(workerThreads_.size());
+            workersRunning_ = true;
+            workerRun_++;
+        }
+        workerStartCv_.notify_all();
+
+        func(0);
+
+        std::unique_lock<std::mutex> lock(workerMutex_);
+        workerDoneCv_.wait(lock, [this]() { return workersBusy_ == 0; });
+        pWorkerFunc_ = nullptr;
+    }
+
+    std::vector<std::function<void()>> funcs;
+    {
+        std::lock_guard<std::mutex> lock(workerMutex_);
+        workersRunning_ = false;
+        funcs.swap(afterWorkerFuncs_);
+    }
+    for (auto& afterFunc : funcs) afterFunc();
+}
+
+void Command::Handler::afterWorkers(std::function<void()>&& func) {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex_);
+        if (workersRunning_) {
+            afterWorkerFuncs_.push_back(std::move(func));
+            return;
+        }
+    }
+    func();
+}
+
+void Command::Handler::workerLoop(const uint32_t worker, uint64_t run) {
+    while (true) {
+        const std::function<void(const uint32_t)>* pFunc;
+        {
+            std::unique_lock<std::mutex> lock(workerMutex_);
+            workerStartCv_.wait(lock, [this, run]() { return workersStopping_ || workerRun_ != run; });
+            if (workersStopping_) return;
+            run = workerRun_;
+            pFunc = pWorkerFunc_;
+        }
+
+        (*pFunc)(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(workerMutex_);
+            workersBusy_--;
+        }
+        workerDoneCv_.notify_one();
+    }
+}
@@ -6,7 +6,12 @@
 #ifndef CMD_BUF_HANDLER_H
 #define CMD_BUF_HANDLER_H
 
+#include <condition_variable>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "Game.h"
@@ -59,6 +64,27 @@ class Handler : public Game::Handler {
 
     void beginCmd(const vk::CommandBuffer &cmd, const vk::CommandBufferInheritanceInfo *inheritanceInfo = nullptr) const;
 
+    // WORKERS
+    /* Threads for recording secondary command buffers. Worker 0 is the thread that calls "runWorkers", and the others
+     *  stay alive between calls. A command pool can only be used by one thread at a time, so every worker has its own
+     *  graphics pool, and a command buffer made with "createWorkerCmdBuffers" should only be recorded by its worker.
+     *  Without "startWorkers" there is just worker 0.
+     */
+    void startWorkers(const uint32_t count);
+    void stopWorkers();
+    inline uint32_t getWorkerCount() const { return static_cast<uint32_t>(workerPools_.size()); }
+    inline const vk::CommandPool &getWorkerCmdPool(const uint32_t worker) const { return workerPools_.at(worker); }
+    inline void createWorkerCmdBuffers(const uint32_t worker, vk::CommandBuffer *pCommandBuffers, uint32_t count = 1) {
+        createCmdBuffers(workerPools_.at(worker), pCommandBuffers, vk::CommandBufferLevel::eSecondary, count);
+    }
+    // Calls "func(worker)" once on every worker, and returns once they have all returned.
+    void runWorkers(const std::function<void(const uint32_t)> &func);
+    /* Calls "func" on the "runWorkers" thread once the current "runWorkers" call is done, or right away if there is
+     *  none. Anything that changes state the workers read while they record (dirty flags, instance data) goes
+     *  through here.
+     */
+    void afterWorkers(std::function<void()> &&func);
+
    private:
     void reset() override;
 
@@ -67,6 +93,20 @@ class Handler : public Game::Handler {
 
     std::map<uint32_t, vk::CommandPool> pools_;
     std::map<uint32_t, vk::CommandBuffer> cmds_;
+
+    // WORKERS
+    void workerLoop(const uint32_t worker, uint64_t run);
+    std::vector<vk::CommandPool> workerPools_;
+    std::vector<std::thread> workerThreads_;
+    std::mutex workerMutex_;
+    std::condition_variable workerStartCv_;
+    std::condition_variable workerDoneCv_;
+    const std::function<void(const uint32_t)> *pWorkerFunc_;
+    uint64_t workerRun_;  // Bumped for every "runWorkers" call.
+    uint32_t workersBusy_;
+    bool workersStopping_;
+    bool workersRunning_;
+    std::vector<std::function<void()>> afterWorkerFuncs_;
 };
 
 }  // namespace Command
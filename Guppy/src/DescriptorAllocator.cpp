@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include <Common/Helpers.h>
+
+namespace {
+
+// Descriptors of each type per set. Most sets are a few uniforms and a couple of samplers.
+constexpr std::array<std::pair<vk::DescriptorType, float>, 11> POOL_SIZE_RATIOS = {{
+    {vk::DescriptorType::eSampler, 0.5f},
+    {vk::DescriptorType::eCombinedImageSampler, 4.0f},
+    {vk::DescriptorType::eSampledImage, 1.0f},
+    {vk::DescriptorType::eStorageImage, 1.0f},
+    {vk::DescriptorType::eUniformTexelBuffer, 0.5f},
+    {vk::DescriptorType::eStorageTexelBuffer, 0.5f},
+    {vk::DescriptorType::eUniformBuffer, 2.0f},
+    {vk::DescriptorType::eStorageBuffer, 1.0f},
+    {vk::DescriptorType::eUniformBufferDynamic, 1.0f},
+    {vk::DescriptorType::eStorageBufferDynamic, 1.0f},
+    {vk::DescriptorType::eInputAttachment, 0.5f},
+}};
+
+}  // namespace
+
+namespace Descriptor {
+
+vk::DescriptorPool CreatePool(const Context &ctx, const uint32_t maxSets, const vk::DescriptorPoolCreateFlags flags) {
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+    for (const auto &[type, ratio] : POOL_SIZE_RATIOS)
+        poolSizes.push_back({type, std::max(static_cast<uint32_t>(ratio * maxSets), 1U)});
+
+    vk::DescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.flags = flags;
+    poolInfo.maxSets = maxSets;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    return ctx.dev.createDescriptorPool(poolInfo, ctx.pAllocator);
+}
+
+Allocator::Allocator(const std::string &&name, const uint32_t setsPerPool)
+    : NAME(name), SETS_PER_POOL(setsPerPool), nextBucket_(0) {
+    assert(SETS_PER_POOL);
+}
+
+bool Allocator::allocate(const Context &ctx, const vk::DescriptorSetLayout *pLayouts, const uint32_t count,
+                         vk::DescriptorSet *pSets) {
+    vk::DescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.descriptorSetCount = count;
+    allocInfo.pSetLayouts = pLayouts;
+
+    // Try the current pool, and then a fresh one. Vulkan does not leave any of the sets allocated if one fails.
+    for (uint32_t attempt = 0; attempt < 2; attempt++) {
+        if (pools_.empty() || attempt) nextPool(ctx);
+        allocInfo.descriptorPool = pools_.back();
+
+        auto result = ctx.dev.allocateDescriptorSets(&allocInfo, pSets);
+        if (result == vk::Result::eSuccess) return true;
+        if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+            helpers::checkVkResult(result);
+    }
+    return false;
+}
+
+void Allocator::nextPool(const Context &ctx) {
+    pools_.push_back(CreatePool(ctx, SETS_PER_POOL << nextBucket_));
+    nextBucket_ = std::min<uint8_t>(nextBucket_ + 1, MAX_BUCKET);
+}
+
+void Allocator::destroy(const Context &ctx) {
+    for (auto &pool : pools_) ctx.dev.destroyDescriptorPool(pool, ctx.pAllocator);
+    pools_.clear();
+    nextBucket_ = 0;
+}
+
+}  // namespace Descriptor
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef DESCRIPTOR_ALLOCATOR_H
+#define DESCRIPTOR_ALLOCATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include <Common/Context.h>
+#include <Common/Types.h>
+
+namespace Descriptor {
+
+/* Hands out descriptor sets from a list of pools instead of a single pool sized up front. Sets come out of the current
+ *  pool until it runs out, and then out of a new one. New pools are size-bucketed: every new pool doubles the set count
+ *  of the last one up to MAX_BUCKET, so a big scene ends up with a few big pools instead of a lot of small ones. The
+ *  descriptor counts of a pool are its set count times POOL_SIZE_RATIOS.
+ *
+ *  Sets are never freed. They live until "destroy" takes the pools with them.
+ */
+class Allocator : NonCopyable {
+   public:
+    static constexpr uint8_t MAX_BUCKET = 4;
+
+    Allocator(const std::string &&name, const uint32_t setsPerPool);
+
+    const std::string NAME;
+    const uint32_t SETS_PER_POOL;  // Of the first bucket.
+
+    // Every set comes out of the same pool. Returns false if a new pool could not fit them.
+    bool allocate(const Context &ctx, const vk::DescriptorSetLayout *pLayouts, const uint32_t count,
+                  vk::DescriptorSet *pSets);
+    void destroy(const Context &ctx);
+
+   private:
+    void nextPool(const Context &ctx);
+
+    std::vector<vk::DescriptorPool> pools_;  // The back is the one being allocated from.
+    uint8_t nextBucket_;
+};
+
+// Makes a pool with "maxSets" times POOL_SIZE_RATIOS descriptors.
+vk::DescriptorPool CreatePool(const Context &ctx, const uint32_t maxSets,
+                              const vk::DescriptorPoolCreateFlags flags = {});
+
+}  // namespace Descriptor
+
+#endif  // !DESCRIPTOR_ALLOCATOR_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "DescriptorBindless.h"
+
+#include <algorithm>
+
+#include <Common/Helpers.h>
+
+namespace {
+
+constexpr std::array<vk::DescriptorType, 2> DESCRIPTOR_TYPES = {
+    vk::DescriptorType::eCombinedImageSampler,
+    vk::DescriptorType::eStorageBuffer,
+};
+
+}  // namespace
+
+namespace Descriptor {
+
+Bindless::Bindless() : layout_(), pool_(), set_(), frameIndex_(0), arrays_() {}
+
+void Bindless::init(const Context &ctx) {
+    destroy(ctx);
+    if (!ctx.bindlessEnabled) return;
+
+    // COUNTS
+    const auto &props = ctx.physicalDevProps[ctx.physicalDevIndex].propsDescIndexing;
+    arrays_[static_cast<uint32_t>(ARRAY::SAMPLER)].count =
+        std::min({MAX_COUNTS[0], props.maxPerStageDescriptorUpdateAfterBindSamplers,
+                  props.maxPerStageDescriptorUpdateAfterBindSampledImages});
+    arrays_[static_cast<uint32_t>(ARRAY::STORAGE_BUFFER)].count =
+        std::min(MAX_COUNTS[1], props.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+    for (auto &array : arrays_) {
+        assert(array.count);
+        array.retiredSlots.resize(ctx.imageCount);
+    }
+    imageInfos_.resize(getCount(ARRAY::SAMPLER));
+    bufferInfos_.resize(getCount(ARRAY::STORAGE_BUFFER));
+
+    // LAYOUT
+    const vk::ShaderStageFlags stageFlags = vk::ShaderStageFlagBits::eAllGraphics | vk::ShaderStageFlagBits::eCompute;
+    std::vector<vk::DescriptorSetLayoutBinding> bindings;
+    std::vector<vk::DescriptorBindingFlagsEXT> bindingFlags;
+    for (uint32_t i = 0; i < arrays_.size(); i++) {
+        bindings.push_back({i, DESCRIPTOR_TYPES[i], arrays_[i].count, stageFlags});
+        bindingFlags.push_back(vk::DescriptorBindingFlagBitsEXT::ePartiallyBound |
+                               vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind |
+                               vk::DescriptorBindingFlagBitsEXT::eUpdateUnusedWhilePending);
+    }
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    vk::DescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    layout_ = ctx.dev.createDescriptorSetLayout(layoutInfo, ctx.pAllocator);
+
+    // POOL
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+    for (uint32_t i = 0; i < arrays_.size(); i++) poolSizes.push_back({DESCRIPTOR_TYPES[i], arrays_[i].count});
+
+    vk::DescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    pool_ = ctx.dev.createDescriptorPool(poolInfo, ctx.pAllocator);
+
+    // SET
+    vk::DescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.descriptorPool = pool_;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout_;
+    helpers::checkVkResult(ctx.dev.allocateDescriptorSets(&allocInfo, &set_));
+}
+
+uint32_t Bindless::add(const vk::DescriptorImageInfo &info, std::vector<vk::WriteDescriptorSet> &writes) {
+    auto index = acquire(ARRAY::SAMPLER);
+    if (index == INVALID_INDEX) return index;
+    imageInfos_[index] = info;
+    writes.push_back(getWrite(ARRAY::SAMPLER, index));
+    return index;
+}
+
+uint32_t Bindless::add(const vk::DescriptorBufferInfo &info, std::vector<vk::WriteDescriptorSet> &writes) {
+    auto index = acquire(ARRAY::STORAGE_BUFFER);
+    if (index == INVALID_INDEX) return index;
+    bufferInfos_[index] = info;
+    writes.push_back(getWrite(ARRAY::STORAGE_BUFFER, index));
+    return index;
+}
+
+void Bindless::release(const ARRAY array, const uint32_t index) {
+    auto &a = arrays_[static_cast<uint32_t>(array)];
+    assert(index < a.next);
+    a.retiredSlots[frameIndex_].push_back(index);
+}
+
+void Bindless::beginFrame(const uint32_t frameIndex) {
+    frameIndex_ = frameIndex;
+    for (auto &array : arrays_) {
+        if (array.retiredSlots.empty()) continue;
+        auto &retired = array.retiredSlots[frameIndex_];
+        array.freeSlots.insert(array.freeSlots.end(), retired.begin(), retired.end());
+        retired.clear();
+    }
+}
+
+uint32_t Bindless::acquire(const ARRAY array) {
+    assert(isEnabled());
+    auto &a = arrays_[static_cast<uint32_t>(array)];
+    if (a.freeSlots.size()) {
+        auto index = a.freeSlots.back();
+        a.freeSlots.pop_back();
+        return index;
+    }
+    return a.next < a.count ? a.next++ : INVALID_INDEX;
+}
+
+vk::WriteDescriptorSet Bindless::getWrite(const ARRAY array, const uint32_t index) const {
+    vk::WriteDescriptorSet write = {};
+    write.dstSet = set_;
+    write.dstBinding = static_cast<uint32_t>(array);
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = DESCRIPTOR_TYPES[static_cast<uint32_t>(array)];
+    if (array == ARRAY::SAMPLER)
+        write.pImageInfo = &imageInfos_[index];
+    else
+        write.pBufferInfo = &bufferInfos_[index];
+    return write;
+}
+
+void Bindless::destroy(const Context &ctx) {
+    // The set goes with the pool.
+    if (pool_) ctx.dev.destroyDescriptorPool(pool_, ctx.pAllocator);
+    if (layout_) ctx.dev.destroyDescriptorSetLayout(layout_, ctx.pAllocator);
+    layout_ = vk::DescriptorSetLayout{};
+    pool_ = vk::DescriptorPool{};
+    set_ = vk::DescriptorSet{};
+    frameIndex_ = 0;
+    arrays_ = {};
+    imageInfos_.clear();
+    bufferInfos_.clear();
+}
+
+}  // namespace Descriptor
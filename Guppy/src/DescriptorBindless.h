@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef DESCRIPTOR_BINDLESS_H
+#define DESCRIPTOR_BINDLESS_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include <Common/Context.h>
+#include <Common/Types.h>
+
+namespace Descriptor {
+
+/* One descriptor set with a big array per descriptor type (descriptor indexing). Anything added gets a slot in its
+ *  array, and shaders index the arrays with what they are handed per draw (Bindless::PushConstant) instead of the
+ *  resource having descriptor sets of its own. A pipeline that is made with "Pipeline::CreateInfo::bindless" gets this
+ *  set after all of its own, and its shaders can declare the arrays like (see link.texture.frag and
+ *  link.default.material.glsl):
+ *
+ *      #define _DS_BINDLESS -1
+ *      #if _DS_BINDLESS > -1
+ *      #extension GL_EXT_nonuniform_qualifier : require
+ *      layout(set=_DS_BINDLESS, binding=0) uniform sampler2DArray samplers[];
+ *      layout(set=_DS_BINDLESS, binding=1) readonly buffer Buffers { ... } buffers[];
+ *      #endif
+ *
+ *  Material textures get a sampler slot when they are ready, and default materials get a storage buffer slot when they
+ *  are made.
+ *
+ *  The arrays are partially bound and update-after-bind, so slots can be written while the set is bound in command
+ *  buffers that are still pending. A released slot is not handed out again until its frame comes around, since a
+ *  pending frame could still be reading it.
+ *
+ *  Only used if the device has descriptor indexing ("Context::bindlessEnabled"). Otherwise "isEnabled" is false and
+ *  nothing else should be called.
+ */
+class Bindless : NonCopyable {
+   public:
+    enum class ARRAY {
+        SAMPLER = 0,
+        STORAGE_BUFFER,
+    };
+
+    static constexpr std::string_view MACRO_NAME = "_DS_BINDLESS";
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    // Upper limits. The real counts can be lower depending on the device.
+    static constexpr std::array<uint32_t, 2> MAX_COUNTS = {4096, 1024};
+
+    // Per draw data for the shaders. "item" is up to the shader (an offset into the buffer, an instance...).
+    struct PushConstant {
+        uint32_t sampler = INVALID_INDEX;
+        uint32_t buffer = INVALID_INDEX;
+        uint32_t item = 0;
+        uint32_t padding = 0;
+    };
+
+    Bindless();
+
+    void init(const Context &ctx);
+    void destroy(const Context &ctx);
+
+    inline bool isEnabled() const { return static_cast<bool>(set_); }
+    inline const vk::DescriptorSetLayout &getLayout() const { return layout_; }
+    inline const vk::DescriptorSet &getSet() const { return set_; }
+    inline uint32_t getCount(const ARRAY array) const { return arrays_[static_cast<uint32_t>(array)].count; }
+
+    // Returns the slot, or INVALID_INDEX if the array is full. The write points at data owned by this.
+    uint32_t add(const vk::DescriptorImageInfo &info, std::vector<vk::WriteDescriptorSet> &writes);
+    uint32_t add(const vk::DescriptorBufferInfo &info, std::vector<vk::WriteDescriptorSet> &writes);
+    void release(const ARRAY array, const uint32_t index);
+    // Called after the frame fence for "frameIndex" has been waited on.
+    void beginFrame(const uint32_t frameIndex);
+
+   private:
+    struct Array {
+        uint32_t count = 0;
+        uint32_t next = 0;  // Slots past this have never been used.
+        std::vector<uint32_t> freeSlots;
+        std::vector<std::vector<uint32_t>> retiredSlots;  // Per frame
+    };
+
+    uint32_t acquire(const ARRAY array);
+    vk::WriteDescriptorSet getWrite(const ARRAY array, const uint32_t index) const;
+
+    vk::DescriptorSetLayout layout_;
+    vk::DescriptorPool pool_;
+    vk::DescriptorSet set_;
+    uint32_t frameIndex_;
+    std::array<Array, 2> arrays_;
+    std::vector<vk::DescriptorImageInfo> imageInfos_;
+    std::vector<vk::DescriptorBufferInfo> bufferInfos_;
+};
+
+}  // namespace Descriptor
+
+#endif  // !DESCRIPTOR_BINDLESS_H
@@ -32,6 +32,7 @@ const std::set<DESCRIPTOR_SET> ALL = {
     // DESCRIPTOR_SET::SWAPCHAIN_IMAGE,
     // DEFAULT
     DESCRIPTOR_SET::UNIFORM_DEFAULT,
+    DESCRIPTOR_SET::UNIFORM_DEFAULT_BINDLESS,
     DESCRIPTOR_SET::UNIFORM_CAMERA_ONLY,
     DESCRIPTOR_SET::UNIFORM_DEFCAM_DEFMAT_MX4,
     DESCRIPTOR_SET::UNIFORM_CAM_MATOBJ3D,
@@ -143,6 +144,18 @@ const CreateInfo UNIFORM_CREATE_INFO = {
     },
 };
 
+// UNIFORM_CREATE_INFO without the material. Bindless pipelines read it from Descriptor::Bindless's storage buffer array.
+const CreateInfo UNIFORM_BINDLESS_CREATE_INFO = {
+    DESCRIPTOR_SET::UNIFORM_DEFAULT_BINDLESS,
+    "_DS_UNI_DEF",
+    {
+        {{0, 0}, {UNIFORM::CAMERA_PERSPECTIVE_DEFAULT}},
+        {{2, 0}, {UNIFORM::FOG_DEFAULT}},
+        {{3, 0}, {UNIFORM::LIGHT_POSITIONAL_DEFAULT}},
+        {{4, 0}, {UNIFORM::LIGHT_SPOT_DEFAULT}},
+    },
+};
+
 const CreateInfo UNIFORM_CAMERA_ONLY_CREATE_INFO = {
     DESCRIPTOR_SET::UNIFORM_CAMERA_ONLY,
     "_DS_UNI_CAM_ONLY",
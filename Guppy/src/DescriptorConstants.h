@@ -23,6 +23,7 @@ namespace Buffer { struct Info; }
 enum class DESCRIPTOR_SET {
     // DEFAULT
     UNIFORM_DEFAULT,
+    UNIFORM_DEFAULT_BINDLESS,
     UNIFORM_CAMERA_ONLY,
     UNIFORM_DEFCAM_DEFMAT_MX4,
     UNIFORM_CAM_MATOBJ3D,
@@ -133,7 +134,13 @@ struct GetTypeString {
 struct GetVulkanBufferUsage {
     template <typename T> vk::BufferUsageFlags operator()(const T&) const { assert(false); exit(EXIT_FAILURE); }
     vk::BufferUsageFlags operator()(const UNIFORM&)                         const { return vk::BufferUsageFlagBits::eUniformBuffer; }
-    vk::BufferUsageFlags operator()(const UNIFORM_DYNAMIC&)                 const { return vk::BufferUsageFlagBits::eUniformBuffer; }
+    vk::BufferUsageFlags operator()(const UNIFORM_DYNAMIC& type)            const {
+        switch (type) {
+            // Bindless pipelines read default materials out of Descriptor::Bindless's storage buffer array.
+            case UNIFORM_DYNAMIC::MATERIAL_DEFAULT: return vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+            default: return vk::BufferUsageFlagBits::eUniformBuffer;
+        }
+    }
     vk::BufferUsageFlags operator()(const UNIFORM_TEXEL_BUFFER&)            const { return vk::BufferUsageFlagBits::eUniformTexelBuffer; }
     vk::BufferUsageFlags operator()(const STORAGE_IMAGE&)                   const { return vk::BufferUsageFlagBits::eStorageBuffer; }
     vk::BufferUsageFlags operator()(const STORAGE_BUFFER&)                  const { return vk::BufferUsageFlagBits::eStorageBuffer; }
@@ -412,6 +419,7 @@ using textReplaceTuples = std::vector<textReplaceTuple>;
 
 namespace Default {
 extern const CreateInfo UNIFORM_CREATE_INFO;
+extern const CreateInfo UNIFORM_BINDLESS_CREATE_INFO;
 extern const CreateInfo UNIFORM_CAMERA_ONLY_CREATE_INFO;
 extern const CreateInfo UNIFORM_DEFCAM_DEFMAT_MX4;
 extern const CreateInfo UNIFORM_CAM_MATOBJ3D_CREATE_INFO;
@@ -24,6 +24,7 @@
 #include "PBR.h"
 #include "Pipeline.h"
 #include "RenderPass.h"
+#include "RenderPassManager.h"
 #include "ScreenSpace.h"
 #include "Shadow.h"
 #include "Tessellation.h"
@@ -35,11 +36,13 @@
 #include "TextureHandler.h"
 #include "UniformHandler.h"
 
-Descriptor::Handler::Handler(Game* pGame) : Game::Handler(pGame), pool_() {
+Descriptor::Handler::Handler(Game* pGame)
+    : Game::Handler(pGame), pool_(), allocator_("Descriptor Sets", 64) {
     for (const auto& type : Descriptor::Set::ALL) {
         // clang-format off
         switch (type) {
             case DESCRIPTOR_SET::UNIFORM_DEFAULT:                           pDescriptorSets_.emplace_back(new Set::Base(std::ref(*this), &Set::Default::UNIFORM_CREATE_INFO)); break;
+            case DESCRIPTOR_SET::UNIFORM_DEFAULT_BINDLESS:                  pDescriptorSets_.emplace_back(new Set::Base(std::ref(*this), &Set::Default::UNIFORM_BINDLESS_CREATE_INFO)); break;
             case DESCRIPTOR_SET::UNIFORM_CAMERA_ONLY:                       pDescriptorSets_.emplace_back(new Set::Base(std::ref(*this), &Set::Default::UNIFORM_CAMERA_ONLY_CREATE_INFO)); break;
             case DESCRIPTOR_SET::UNIFORM_DEFCAM_DEFMAT_MX4:                 pDescriptorSets_.emplace_back(new Set::Base(std::ref(*this), &Set::Default::UNIFORM_DEFCAM_DEFMAT_MX4)); break;
             case DESCRIPTOR_SET::UNIFORM_CAM_MATOBJ3D:                      pDescriptorSets_.emplace_back(new Set::Base(std::ref(*this), &Set::Default::UNIFORM_CAM_MATOBJ3D_CREATE_INFO)); break;
@@ -94,6 +97,7 @@ void Descriptor::Handler::init() {
     reset();
     createPool();
     createLayouts();
+    bindless_.init(shell().context());
 
     assert(shell().context().imageCount == 3);  // Potential imageCount problem
     // Determine the number of sets required
@@ -101,26 +105,21 @@ void Descriptor::Handler::init() {
 }
 
 void Descriptor::Handler::createPool() {
-    // TODO: an actaul allocator that works, and doesn't waste a ton of memory
-    std::vector<vk::DescriptorPoolSize> poolSizes = {
-        {vk::DescriptorType::eSampler, 1000},
-        {vk::DescriptorType::eCombinedImageSampler, 1000},
-        {vk::DescriptorType::eSampledImage, 1000},
-        {vk::DescriptorType::eStorageImage, 1000},
-        {vk::DescriptorType::eUniformTexelBuffer, 1000},
-        {vk::DescriptorType::eStorageTexelBuffer, 1000},
-        {vk::DescriptorType::eUniformBuffer, 1000},
-        {vk::DescriptorType::eStorageBuffer, 1000},
-        {vk::DescriptorType::eUniformBufferDynamic, 1000},
-        {vk::DescriptorType::eStorageBufferDynamic, 1000},
-        {vk::DescriptorType::eInputAttachment, 1000},
-    };
-    vk::DescriptorPoolCreateInfo poolInfo = {};
-    poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
-    poolInfo.maxSets = 1000 * poolSizes.size();
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
-    pool_ = shell().context().dev.createDescriptorPool(poolInfo, shell().context().pAllocator);
+    const auto& ctx = shell().context();
+    // ImGui frees its own sets.
+    pool_ = CreatePool(ctx, 32, vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+}
+
+void Descriptor::Handler::beginFrame(const uint32_t frameIndex) {
+    if (bindless_.isEnabled()) bindless_.beginFrame(frameIndex);
+}
+
+void Descriptor::Handler::flushWrites() {
+    if (pendingWrites_.empty()) return;
+    shell().context().dev.updateDescriptorSets(pendingWrites_, {});
+    pendingWrites_.clear();
+    // Updating a set invalidates the command buffers it is bound in.
+    passHandler().renderPassMgr().setDirty();
 }
 
 /* OLD POOL LOGIC THAT HAD A BAD ATTEMPT AT AN ALLOCATION STRATEGY
@@ -213,7 +212,7 @@ void Descriptor::Handler::prepareDescriptorSet(std::unique_ptr<Descriptor::Set::
     std::set<PIPELINE> pipelineTypes;
     // Gather all of the pipelines that need the set.
     for (const auto& [pipelineType, pPipeline] : pipelineHandler().getPipelines())
-        for (const auto& [setType, stageFlags] : pPipeline->DESC_SET_STAGE_PAIRS)
+        for (const auto& [setType, stageFlags] : pPipeline->getDescSetStagePairs())
             if (pSet->TYPE == setType) pipelineTypes.insert(pPipeline->TYPE);
 
     // Determine the number of layouts needed based on unique offsets for uniforms. gatherDescriptorSetOffsets
@@ -564,7 +563,7 @@ void Descriptor::Handler::getBindData(const PIPELINE& pipelineType, Descriptor::
 
     // Get the same descriptor sets info as the pipeline layouts.
     auto resHelpers =
-        getResourceHelpers(passTypes, pipelineType, pipelineHandler().getPipeline(pipelineType)->DESC_SET_STAGE_PAIRS);
+        getResourceHelpers(passTypes, pipelineType, pipelineHandler().getPipeline(pipelineType)->getDescSetStagePairs());
 
     for (const auto& helpers : resHelpers) {
         assert(helpers.size());
@@ -634,7 +633,15 @@ void Descriptor::Handler::getBindData(const PIPELINE& pipelineType, Descriptor::
                 itResOffsetsMap = it.first;
 
                 // Allocate
-                allocateDescriptorSets(std::ref(*helper.pResource), itResOffsetsMap->second.second);
+                auto result = allocateDescriptorSets(std::ref(*helper.pResource), itResOffsetsMap->second.second);
+                if (result != vk::Result::eSuccess) {
+                    // Don't leave unallocated sets behind for the next call to find. Anything already written for the
+                    //  other sets is still sent.
+                    itDescSetsMap->second.erase(itResOffsetsMap);
+                    flushWrites();
+                    bindDataMap.clear();
+                    throw std::runtime_error("Could not allocate descriptor sets: " + vk::to_string(result));
+                }
 
                 // Update
                 updateDescriptorSets(pSet->getBindingMap(), pSet->getDescriptorOffsets(helper.resourceOffset),
@@ -677,23 +684,25 @@ void Descriptor::Handler::getBindData(const PIPELINE& pipelineType, Descriptor::
             itBindDataMap->second.setResourceInfoMap[pSet->TYPE] = pInfoMap;
         }
     }
+
+    // Every set allocated above gets written in one call.
+    flushWrites();
 }
 
-void Descriptor::Handler::allocateDescriptorSets(const Descriptor::Set::Resource& resource,
-                                                 std::vector<vk::DescriptorSet>& descriptorSets) {
+vk::Result Descriptor::Handler::allocateDescriptorSets(const Descriptor::Set::Resource& resource,
+                                                       std::vector<vk::DescriptorSet>& descriptorSets) {
     std::vector<vk::DescriptorSetLayout> layouts(descriptorSets.size(), resource.layout);
 
-    vk::DescriptorSetAllocateInfo allocInfo = {};
-    allocInfo.descriptorPool = pool_;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
-    allocInfo.pSetLayouts = layouts.data();
-
-    helpers::checkVkResult(shell().context().dev.allocateDescriptorSets(&allocInfo, descriptorSets.data()));
+    // Even a new pool was too small for the sets.
+    if (!allocator_.allocate(shell().context(), layouts.data(), static_cast<uint32_t>(layouts.size()),
+                             descriptorSets.data()))
+        return vk::Result::eErrorOutOfPoolMemory;
+    return vk::Result::eSuccess;
 }
 
 void Descriptor::Handler::updateDescriptorSets(const Descriptor::bindingMap& bindingMap,
                                                const Descriptor::OffsetsMap& offsets, Set::resourceInfoMapSetsPair& pair,
-                                               const std::vector<Descriptor::Base*> pDynamicItems) const {
+                                               const std::vector<Descriptor::Base*> pDynamicItems) {
     std::vector<std::vector<vk::WriteDescriptorSet>> writesList(pair.second.size());
     assert(writesList.size() == pair.second.size());
 
@@ -847,9 +856,8 @@ void Descriptor::Handler::updateDescriptorSets(const Descriptor::bindingMap& bin
         }
     }
 
-    for (auto& writes : writesList) {
-        shell().context().dev.updateDescriptorSets(writes, {});
-    }
+    // The writes point into the resource info map, which stays put until the next update of "pair".
+    for (auto& writes : writesList) pendingWrites_.insert(pendingWrites_.end(), writes.begin(), writes.end());
 }
 
 void Descriptor::Handler::updateBindData(const std::vector<std::string> textureIds) {
@@ -875,6 +883,8 @@ void Descriptor::Handler::updateBindData(const std::vector<std::string> textureI
                             updateDescriptorSets(pSet->getBindingMap(), pSet->getDescriptorOffsets(resourceOffset),
                                                  descriptorSets, {});
                         }
+                        // Flushed before a repeated texture id could update the same sets again.
+                        flushWrites();
                     }
                 }
             }
@@ -922,6 +932,10 @@ void Descriptor::Handler::reset() {
     const auto& ctx = shell().context();
     // POOL
     if (pool_) ctx.dev.destroyDescriptorPool(pool_, ctx.pAllocator);
+    pool_ = vk::DescriptorPool{};
+    allocator_.destroy(ctx);
+    pendingWrites_.clear();
+    bindless_.destroy(ctx);
     // LAYOUT
     for (const auto& pSet : pDescriptorSets_) {
         for (auto& res : pSet->resources_) {
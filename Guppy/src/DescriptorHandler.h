@@ -13,6 +13,8 @@
 #include <vulkan/vulkan.hpp>
 
 #include "Descriptor.h"
+#include "DescriptorAllocator.h"
+#include "DescriptorBindless.h"
 #include "ConstantsAll.h"
 #include "Game.h"
 #include "DescriptorSet.h"
@@ -32,7 +34,26 @@ class Handler : public Game::Handler {
     void init() override;
 
     // POOL
+    // For things that manage their own sets (ImGui). Everything else comes out of the allocator.
     inline const vk::DescriptorPool& getPool() { return pool_; }
+    // Called after the frame fence for "frameIndex" has been waited on, so the bindless slots released for it can be
+    //  reused.
+    void beginFrame(const uint32_t frameIndex);
+
+    // WRITE
+    // Writes are queued, and sent in one call. Anything a write points at has to stay put until then.
+    void flushWrites();
+
+    // BINDLESS
+    inline const Bindless& bindless() const { return bindless_; }
+    // Returns Bindless::INVALID_INDEX if the array is full. The write is flushed right away.
+    template <typename TInfo>
+    uint32_t addBindless(const TInfo& info) {
+        auto index = bindless_.add(info, pendingWrites_);
+        flushWrites();
+        return index;
+    }
+    inline void releaseBindless(const Bindless::ARRAY array, const uint32_t index) { bindless_.release(array, index); }
 
     // SET
     const Descriptor::Set::Base& getDescriptorSet(const DESCRIPTOR_SET& type) const {
@@ -47,6 +68,7 @@ class Handler : public Game::Handler {
         const Descriptor::Set::typeShaderStagePairs& descSetStagePairs) const;
 
     // DESCRIPTOR
+    // Throws if the sets cannot be allocated. Nothing half made is kept, so a later call can try again.
     void getBindData(const PIPELINE& pipelineType, Descriptor::Set::bindDataMap& bindDataMap,
                      const std::vector<Descriptor::Base*> pDynamicItems = {});
     void updateBindData(const std::vector<std::string> textureIds);
@@ -57,6 +79,13 @@ class Handler : public Game::Handler {
     // POOL
     void createPool();
     vk::DescriptorPool pool_;
+    Allocator allocator_;
+
+    // WRITE
+    std::vector<vk::WriteDescriptorSet> pendingWrites_;
+
+    // BINDLESS
+    Bindless bindless_;
 
     // LAYOUT
     void createLayouts();
@@ -74,10 +103,11 @@ class Handler : public Game::Handler {
 
     void prepareDescriptorSet(std::unique_ptr<Descriptor::Set::Base>& pSet);
 
-    void allocateDescriptorSets(const Descriptor::Set::Resource& resource, std::vector<vk::DescriptorSet>& descriptorSets);
+    vk::Result allocateDescriptorSets(const Descriptor::Set::Resource& resource,
+                                      std::vector<vk::DescriptorSet>& descriptorSets);
 
     void updateDescriptorSets(const Descriptor::bindingMap& bindingMap, const Descriptor::OffsetsMap& offsets,
-                              Set::resourceInfoMapSetsPair& pair, const std::vector<Descriptor::Base*> pDynamicItems) const;
+                              Set::resourceInfoMapSetsPair& pair, const std::vector<Descriptor::Base*> pDynamicItems);
 
     vk::WriteDescriptorSet getWrite(const Descriptor::bindingMapKeyValue& keyValue, const vk::DescriptorSet& set) const;
     void getDynamicOffsets(const std::unique_ptr<Descriptor::Set::Base>& pSet, std::vector<uint32_t>& dynamicOffsets,
@@ -6,6 +6,7 @@
 #ifndef BUFFER_MANAGER_DESCRIPTOR_H
 #define BUFFER_MANAGER_DESCRIPTOR_H
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <variant>
@@ -43,8 +44,12 @@ class Manager : public Buffer::Manager::Base<TBase, TDerived, TSmartPointer> {
 
     void init(const Context &ctx, std::vector<uint32_t> queueFamilyIndices = {}) override {
         // TODO: dump the alignment padding here so you can see how bad it is...
-        const auto &minAlignment =
-            ctx.physicalDevProps[ctx.physicalDevIndex].properties.limits.minUniformBufferOffsetAlignment;
+        const auto &limits = ctx.physicalDevProps[ctx.physicalDevIndex].properties.limits;
+        // Items that are also bound as storage buffers have to meet both alignments (both are powers of two).
+        const auto minAlignment = (TManager::USAGE & vk::BufferUsageFlagBits::eStorageBuffer)
+                                      ? (std::max)(limits.minUniformBufferOffsetAlignment,
+                                                   limits.minStorageBufferOffsetAlignment)
+                                      : limits.minUniformBufferOffsetAlignment;
         if (sizeof(typename TDerived::DATA) % minAlignment != 0) {
             TManager::alignment_ = (sizeof(typename TDerived::DATA) + minAlignment - 1) & ~(minAlignment - 1);
         }
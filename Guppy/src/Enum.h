@@ -105,6 +105,7 @@ typedef enum STATUS {
     PENDING_MESH =          0x00000040,
     PENDING_BIND_DATA =     0x00000080,
     REDRAW =                0x00000100,
+    PENDING_LOADING =       0x00000200,
     UPDATE_BUFFERS =        0x00001000,
     DESTROYED =             0x00010000,
     UNKNOWN =               0x00020000,
@@ -132,6 +133,7 @@ enum class PUSH_CONSTANT {
     HFF_COLUMN,
     FFT_ROW_COL_OFFSET,
     CDLOD,
+    BINDLESS,
 };
 
 enum class MESH {
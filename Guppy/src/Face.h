@@ -15,19 +15,15 @@
 
 #include "Mesh.h"
 #include "Vertex.h"
+#include "VertexMap.h"
 
 /*  This is used to store unique vertex information when loading a mesh from a file. The key is a
     Vertex::Complete, and the value is a list of mesh offset to mesh vertex index. So, if you are
     creating more than one mesh based on the vertices, you can smooth vertices and attempt to
     index as many of the vertices as possible.
 */
-using unique_vertices_map_smoothing = std::unordered_multimap<Vertex::Complete, std::pair<size_t, IndexBufferType>,
-                                                              Vertex::Complete::hash_vertex_complete_smoothing,
-                                                              Vertex::Complete::hash_vertex_complete_smoothing>;
-
-using unique_vertices_map_non_smoothing = std::unordered_multimap<Vertex::Complete, std::pair<size_t, IndexBufferType>,
-                                                                  Vertex::Complete::hash_vertex_complete_non_smoothing,
-                                                                  Vertex::Complete::hash_vertex_complete_non_smoothing>;
+using unique_vertices_map_smoothing = Vertex::Map<Vertex::Complete::hash_vertex_complete_smoothing>;
+using unique_vertices_map_non_smoothing = Vertex::Map<Vertex::Complete::hash_vertex_complete_non_smoothing>;
 
 class Face {
    public:
@@ -58,7 +54,13 @@ class Face {
 
     template <typename TMap, class TMesh>
     void indexVertices(TMap &vertexMap, std::vector<TMesh> &pMeshes, uint8_t meshOffset, bool calcNormal = true) {
-        // Calculate per face data.
+        calculateVertexData(pMeshes, calcNormal);
+        indexCalculatedVertices(vertexMap, pMeshes, meshOffset);
+    }
+
+    // Per face data. Only depends on this face, so it can be done for many faces at once before indexing.
+    template <class TMesh>
+    void calculateVertexData(const std::vector<TMesh> &pMeshes, bool calcNormal = true) {
         if (calcNormal) calculateNormal();
         // Check if there is a normal map...
 
@@ -68,86 +70,96 @@ class Face {
             std::any_of(pMeshes.begin(), pMeshes.end(), [](const auto &pMesh) { return pMesh->TYPE == MESH::TEXTURE; });
 
         if (needsTangentSpace || normalMapped) calculateTangentSpaceVectors();
+    }
 
-        for (size_t i = 0; i < NUM_VERTICES; ++i) {
-            long index = -1;
+    // "indexVertices" for a face that already had "calculateVertexData" done.
+    template <typename TMap, class TMesh>
+    void indexCalculatedVertices(TMap &vertexMap, std::vector<TMesh> &pMeshes, uint8_t meshOffset) {
+        // Always add an index for the current mesh.
+        for (uint8_t i = 0; i < NUM_VERTICES; ++i)
+            pMeshes[meshOffset]->addIndex(indexCalculatedVertex(vertexMap, pMeshes, meshOffset, i));
+    }
+
+    // Welds vertex "i" into "vertexMap", and returns its index in the current mesh. The index is not added.
+    template <typename TMap, class TMesh>
+    IndexBufferType indexCalculatedVertex(TMap &vertexMap, std::vector<TMesh> &pMeshes, uint8_t meshOffset,
+                                          const uint8_t i) {
+        long index = -1;
+
+        auto key = vertexMap.find(vertices_[i]);
+        if (key == TMap::NOT_FOUND) {
+            // New vertex
+            index = static_cast<IndexBufferType>(pMeshes[meshOffset]->getVertexCount());
+            vertexMap.insert(vertices_[i], {meshOffset, index});
+            pMeshes[meshOffset]->addVertex(std::move(vertices_[i]));
+        } else {
+            // Non-unique vertex
+            Vertex::Complete vertex;
+
+            vertexMap.forEach(key, [&](const auto &value) {
+                auto &mOffset = value.first;  // mesh offset
+                auto &vIndex = value.second;  // vertex index
+
+                // Averge the vertex attributes
+                vertex = pMeshes[mOffset]->getVertexComplete(vIndex);
+
+                /*  Below was an attempt to fix bad orange smoothing. I decided
+                    that the problem was probably coming from the obj's having
+                    faces with 4 vertices. tiny_obj can spit out 4 vertex faces
+                    so I should try that at some point instead...
+                */
+                // if (glm::dot(vertices_[i].binormal, vertex.binormal) < 0.0f ||
+                //    glm::dot(vertices_[i].tangent, vertex.tangent) < 0.0f) {
+                //    // This is shitty...
+                //    auto r = glm::rotate(glm::mat4(1.0f), M_PI_FLT, vertices_[i].normal);
+                //    vertices_[i].binormal = r * glm::vec4(vertices_[i].binormal, 0.0f);
+                //    vertices_[i].tangent = r * glm::vec4(vertices_[i].tangent, 0.0f);
+                //}
+
+                if (std::is_same<TMap, unique_vertices_map_non_smoothing>::value) {
+                    assert(glm::all(glm::epsilonEqual(vertex.normal, vertices_[i].normal, glm::epsilon<float>())));
+                    // assert(glm::all(glm::epsilonEqual(vertex.tangent, vertices_[i].tangent,
+                    // glm::vec3(glm::epsilon<float>())))); assert(glm::all(glm::epsilonEqual(vertex.binormal,
+                    // vertices_[i].binormal, glm::vec3(glm::epsilon<float>()))));
+                } else if (std::is_same<TMap, unique_vertices_map_smoothing>::value) {
+                    vertex.normal += vertices_[i].normal;
+                    vertex.tangent += vertices_[i].tangent;
+                    vertex.binormal += vertices_[i].binormal;
+                } else {
+                    assert(false && "Unhandled case");
+                }
 
-            auto range = vertexMap.equal_range(vertices_[i]);
-            if (range.first == range.second) {
-                // New vertex
+                // If the vertex already exists in the current mesh then use the existing index.
+                if (mOffset == meshOffset &&
+                    //
+                    (pMeshes[mOffset]->VERTEX_TYPE == VERTEX::COLOR ||
+                     // If the vertex is in going to be in a texture mesh then check tex coords
+                     (pMeshes[mOffset]->VERTEX_TYPE == VERTEX::TEXTURE && vertex.compareTexCoords(vertices_[i])))
+                    //
+                ) {
+                    index = vIndex;
+                }
+
+                // Update the vertex for all meshes.
+                pMeshes[mOffset]->addVertex(vertex, vIndex);
+            });
+
+            // If the vertex is indexed for other meshes but not the current mesh then add
+            // a new value to the vertex map.
+            if (index < 0) {
                 index = static_cast<IndexBufferType>(pMeshes[meshOffset]->getVertexCount());
-                vertexMap.insert({{vertices_[i], {meshOffset, index}}});
+                vertexMap.insert(vertices_[i], {meshOffset, index});
+
+                // this vertex should retain non-normal data (such as texture coords)
+                vertices_[i].normal = vertex.normal;
+                vertices_[i].tangent = vertex.tangent;
+                vertices_[i].binormal = vertex.binormal;
+
                 pMeshes[meshOffset]->addVertex(std::move(vertices_[i]));
-            } else {
-                // Non-unique vertex
-                Vertex::Complete vertex;
-
-                std::for_each(range.first, range.second, [&](auto &keyValue) {
-                    auto &mOffset = keyValue.second.first;  // mesh offset
-                    auto &vIndex = keyValue.second.second;  // vertex index
-
-                    // Averge the vertex attributes
-                    vertex = pMeshes[mOffset]->getVertexComplete(vIndex);
-
-                    /*  Below was an attempt to fix bad orange smoothing. I decided
-                        that the problem was probably coming from the obj's having
-                        faces with 4 vertices. tiny_obj can spit out 4 vertex faces
-                        so I should try that at some point instead...
-                    */
-                    // if (glm::dot(vertices_[i].binormal, vertex.binormal) < 0.0f ||
-                    //    glm::dot(vertices_[i].tangent, vertex.tangent) < 0.0f) {
-                    //    // This is shitty...
-                    //    auto r = glm::rotate(glm::mat4(1.0f), M_PI_FLT, vertices_[i].normal);
-                    //    vertices_[i].binormal = r * glm::vec4(vertices_[i].binormal, 0.0f);
-                    //    vertices_[i].tangent = r * glm::vec4(vertices_[i].tangent, 0.0f);
-                    //}
-
-                    if (std::is_same<TMap, unique_vertices_map_non_smoothing>::value) {
-                        assert(glm::all(glm::epsilonEqual(vertex.normal, vertices_[i].normal, glm::epsilon<float>())));
-                        // assert(glm::all(glm::epsilonEqual(vertex.tangent, vertices_[i].tangent,
-                        // glm::vec3(glm::epsilon<float>())))); assert(glm::all(glm::epsilonEqual(vertex.binormal,
-                        // vertices_[i].binormal, glm::vec3(glm::epsilon<float>()))));
-                    } else if (std::is_same<TMap, unique_vertices_map_smoothing>::value) {
-                        vertex.normal += vertices_[i].normal;
-                        vertex.tangent += vertices_[i].tangent;
-                        vertex.binormal += vertices_[i].binormal;
-                    } else {
-                        assert(false && "Unhandled case");
-                    }
-
-                    // If the vertex already exists in the current mesh then use the existing index.
-                    if (mOffset == meshOffset &&
-                        //
-                        (pMeshes[mOffset]->VERTEX_TYPE == VERTEX::COLOR ||
-                         // If the vertex is in going to be in a texture mesh then check tex coords
-                         (pMeshes[mOffset]->VERTEX_TYPE == VERTEX::TEXTURE && vertex.compareTexCoords(vertices_[i])))
-                        //
-                    ) {
-                        index = vIndex;
-                    }
-
-                    // Update the vertex for all meshes.
-                    pMeshes[mOffset]->addVertex(vertex, vIndex);
-                });
-
-                // If the vertex is indexed for other meshes but not the current mesh then add
-                // a new value to the vertex map.
-                if (index < 0) {
-                    index = static_cast<IndexBufferType>(pMeshes[meshOffset]->getVertexCount());
-                    vertexMap.insert({{vertices_[i], {meshOffset, index}}});
-
-                    // this vertex should retain non-normal data (such as texture coords)
-                    vertices_[i].normal = vertex.normal;
-                    vertices_[i].tangent = vertex.tangent;
-                    vertices_[i].binormal = vertex.binormal;
-
-                    pMeshes[meshOffset]->addVertex(std::move(vertices_[i]));
-                }
             }
-
-            // Always add an index for the current mesh.
-            pMeshes[meshOffset]->addIndex(index);
         }
+
+        return static_cast<IndexBufferType>(index);
     }
 
     inline void transform(const glm::mat4 &t) {
@@ -32,114 +32,271 @@ typedef struct {
 void getObjData(const Shell &sh, tinyobj_data &data);
 
 /* BECUASE TEMPLATES ARE STUPID ALL OF THIS CODE NEEDS TO BE IN THE HEADER */
-template <typename TMap, class TVertex>
-void loadObjData(const tinyobj_data &data, std::vector<TVertex *> &pMeshes, const Mesh::Settings &settings) {
-    // Map of unique vertices for indexed drawing, and calculating smoothing groups.
-    TMap vertexMap;
-    // std::vector<std::pair<Vertex::Complete, size_t>> uniqueVertices1;
-    // std::vector<std::pair<Vertex::Complete, size_t>> uniqueVertices2;
 
+// Shapes with more faces than this are built and welded on every thread. Smaller shapes get a thread each.
+constexpr size_t LARGE_SHAPE_FACE_COUNT = 1 << 16;
+// Faces built at once before they are indexed. Bounds the memory a large shape needs.
+constexpr size_t FACE_BATCH_SIZE = 1 << 14;
+// Faces per task when a batch is built in parallel.
+constexpr size_t FACE_TASK_SIZE = 256;
+// Partitions of the weld hash a large shape is welded in. Fixed, so the result doesn't depend on the thread count.
+constexpr size_t WELD_PARTITION_COUNT = 64;
+
+// A shape's share of one mesh while shapes are indexed in parallel. It looks enough like a mesh for Face to index into.
+template <class TMesh>
+struct MeshPart {
+    using TVertex = typename TMesh::VertexType;
+
+    MeshPart(const TMesh &mesh) : TYPE(mesh.TYPE), VERTEX_TYPE(mesh.VERTEX_TYPE) {}
+
+    const MESH TYPE;
+    const VERTEX VERTEX_TYPE;
+
+    inline Vertex::Complete getVertexComplete(size_t index) const {
+        assert(index < vertices.size());
+        return {vertices[index]};
+    }
+    inline void addVertex(const Vertex::Complete &v, int32_t index = -1) {
+        if (index == -1) {
+            vertices.push_back(v.getVertex<TVertex>());
+        } else {
+            assert(index < vertices.size());
+            vertices[index] = v.getVertex<TVertex>();
+        }
+    }
+    inline uint32_t getVertexCount() const { return static_cast<uint32_t>(vertices.size()); }
+    inline void addIndex(IndexBufferType index) { indices.push_back(index); }
+
+    std::vector<TVertex> vertices;
+    std::vector<IndexBufferType> indices;
+};
+
+// Fills in face "f" of "shape", and returns the offset of the mesh (material) it belongs to.
+template <class TMesh>
+size_t makeFace(const tinyobj_data &data, const tinyobj::shape_t &shape, const size_t f,
+                const std::vector<TMesh *> &pMeshes, const Mesh::Settings &settings, Face &face) {
     bool useColors = !settings.geometryInfo.faceVertexColorsRGB && !data.attrib.colors.empty();
     bool useNormals = !data.attrib.normals.empty();
     bool useTexCoords = !data.attrib.texcoords.empty();
     bool hasNormalMap = false;
 
-    Face face;
     size_t faceOffset = 0, materialOffset;
     tinyobj::index_t index0, index1, index2;
 
-    for (const auto &shape : data.shapes) {
-        vertexMap.clear();
-
-        // Increment by 3 for each face. (A face has 3 vertices. There is a param for forcing
-        // this in the LoadObj function)
-        for (size_t f = 0; f < shape.mesh.indices.size() / 3; f++) {
-            // A face has 3 vertices. There is a param for forcing this in LoadObj.
-            face = {};
-
-            // Smoothing groups are per face
-            auto smoothingGroupId = shape.mesh.smoothing_group_ids[f];
-            face[0].smoothingGroupId = smoothingGroupId;
-            face[1].smoothingGroupId = smoothingGroupId;
-            face[2].smoothingGroupId = smoothingGroupId;
-
-            // Materials are per face
-            hasNormalMap = false;
-            materialOffset = shape.mesh.material_ids[f] < 0 ? 0 : static_cast<size_t>(shape.mesh.material_ids[f]);
-
-            // Mesh is based on material
-            auto &pMesh = pMeshes[materialOffset];
-
-            // TODO: bring back the model class that loads all of these things in the right order...
-            if (pMesh->hasNormalMap()) {
-                hasNormalMap = true;
-            } else if (!data.materials.empty()) {
-                // TODO: do this right...
-                auto &material = data.materials[materialOffset];
-                hasNormalMap = !material.bump_texname.empty() || !material.normal_texname.empty();
+    // A face has 3 vertices. There is a param for forcing this in LoadObj.
+    face = {};
+
+    // Smoothing groups are per face
+    auto smoothingGroupId = shape.mesh.smoothing_group_ids[f];
+    face[0].smoothingGroupId = smoothingGroupId;
+    face[1].smoothingGroupId = smoothingGroupId;
+    face[2].smoothingGroupId = smoothingGroupId;
+
+    // Materials are per face
+    hasNormalMap = false;
+    materialOffset = shape.mesh.material_ids[f] < 0 ? 0 : static_cast<size_t>(shape.mesh.material_ids[f]);
+
+    // Mesh is based on material
+    auto &pMesh = pMeshes[materialOffset];
+
+    // TODO: bring back the model class that loads all of these things in the right order...
+    if (pMesh->hasNormalMap()) {
+        hasNormalMap = true;
+    } else if (!data.materials.empty()) {
+        // TODO: do this right...
+        auto &material = data.materials[materialOffset];
+        hasNormalMap = !material.bump_texname.empty() || !material.normal_texname.empty();
+    }
+
+    // The offset of the face into the vertex list
+    faceOffset = f * 3;
+    index0 = shape.mesh.indices[faceOffset + 0];
+    index1 = shape.mesh.indices[faceOffset + 1];
+    index2 = shape.mesh.indices[faceOffset + 2];
+
+    // Component x, then y, then z per face
+    for (size_t k = 0; k < 3; k++) {
+        // vertex components
+        face[0].position[k] = data.attrib.vertices[3 * static_cast<size_t>(index0.vertex_index) + k];
+        face[1].position[k] = data.attrib.vertices[3 * static_cast<size_t>(index1.vertex_index) + k];
+        face[2].position[k] = data.attrib.vertices[3 * static_cast<size_t>(index2.vertex_index) + k];
+
+        // Color indices share integer offsets with vertex???
+        if (useColors) {
+            // color components
+            face[0].color[k] = data.attrib.colors[3 * static_cast<size_t>(index0.vertex_index) + k];
+            face[1].color[k] = data.attrib.colors[3 * static_cast<size_t>(index1.vertex_index) + k];
+            face[2].color[k] = data.attrib.colors[3 * static_cast<size_t>(index2.vertex_index) + k];
+        } else {
+            // color components
+            face[0].color[k] = COLOR_RED[k];
+            face[1].color[k] = COLOR_GREEN[k];
+            face[2].color[k] = COLOR_BLUE[k];
+        }
+
+        // TODO: These currently will never be used...
+        if (useNormals) {
+            // normal components
+            face[0].normal[k] = data.attrib.normals[3 * static_cast<size_t>(index0.normal_index) + k];
+            face[1].normal[k] = data.attrib.normals[3 * static_cast<size_t>(index1.normal_index) + k];
+            face[2].normal[k] = data.attrib.normals[3 * static_cast<size_t>(index2.normal_index) + k];
+        }
+
+        // Only x, and y component
+        if (useTexCoords && k < 2) {
+            // texture coordinate components
+            face[0].texCoord[k] = data.attrib.texcoords[2 * static_cast<size_t>(index0.texcoord_index) + k];
+            face[1].texCoord[k] = data.attrib.texcoords[2 * static_cast<size_t>(index1.texcoord_index) + k];
+            face[2].texCoord[k] = data.attrib.texcoords[2 * static_cast<size_t>(index2.texcoord_index) + k];
+            if (k == 1) {
+                /*  Vulkan texture coordinates are different from .obj format, so you
+                 *  have to convert the v.
+                 *       (0,1)--------------------------->(1,1)    (0,0)--------------------------->(1,0)
+                 *         ^                                ^        |                                |
+                 *         |                                |        |                                |
+                 *  from   |                                |   to   |                                |
+                 *         |                                |        |                                |
+                 *         |                                |        |                                |
+                 *         |                                |        V                                V
+                 *       (0,0)--------------------------->(1,0)    (0,1)--------------------------->(1,1)
+                 */
+                face[0].texCoord[k] = 1.0f - face[0].texCoord[k];
+                face[1].texCoord[k] = 1.0f - face[1].texCoord[k];
+                face[2].texCoord[k] = 1.0f - face[2].texCoord[k];
+            }
+        }
+    }
+    if (settings.geometryInfo.reverseFaceWinding) face.reverseWinding();
+    return materialOffset;
+}
+
+// Index every face of "shape" into "parts" (one per mesh).
+template <typename TMap, class TMesh>
+void indexShape(const tinyobj_data &data, const tinyobj::shape_t &shape, const std::vector<TMesh *> &pMeshes,
+                const Mesh::Settings &settings, std::vector<MeshPart<TMesh>> &parts) {
+    std::vector<MeshPart<TMesh> *> pParts;
+    for (const auto &pMesh : pMeshes) parts.emplace_back(*pMesh);
+    for (auto &part : parts) pParts.push_back(&part);
+
+    // Map of unique vertices for indexed drawing, and calculating smoothing groups.
+    TMap vertexMap;
+    vertexMap.reserve(shape.mesh.indices.size());
+
+    const size_t faceCount = shape.mesh.indices.size() / 3;
+    Face face;
+    for (size_t f = 0; f < faceCount; f++) {
+        const auto materialOffset = makeFace(data, shape, f, pMeshes, settings, face);
+        face.calculateVertexData(pMeshes);
+        face.indexCalculatedVertices(vertexMap, pParts, static_cast<uint8_t>(materialOffset));
+    }
+}
+
+/* Vertices only weld if they have the same weld hash (see Vertex::Map), so a large shape is welded in partitions of the
+ *  hash on every thread, each with its own map and parts of the meshes. The partitions are then appended to "parts" in
+ *  order, and every face's indices are rebased in face order. Vertices are welded and smoothed exactly like
+ *  "indexShape" does, but they are ordered by partition instead of by first use.
+ */
+template <typename TMap, class TMesh>
+void indexLargeShape(const tinyobj_data &data, const tinyobj::shape_t &shape, const std::vector<TMesh *> &pMeshes,
+                     const Mesh::Settings &settings, std::vector<MeshPart<TMesh>> &parts) {
+    std::vector<std::vector<MeshPart<TMesh>>> partitionParts(WELD_PARTITION_COUNT);
+    std::vector<std::vector<MeshPart<TMesh> *>> pPartitionParts(WELD_PARTITION_COUNT);
+    std::vector<TMap> vertexMaps(WELD_PARTITION_COUNT);
+    for (size_t p = 0; p < WELD_PARTITION_COUNT; p++) {
+        for (const auto &pMesh : pMeshes) partitionParts[p].emplace_back(*pMesh);
+        for (auto &part : partitionParts[p]) pPartitionParts[p].push_back(&part);
+        vertexMaps[p].reserve(shape.mesh.indices.size() / WELD_PARTITION_COUNT);
+    }
+
+    const size_t faceCount = shape.mesh.indices.size() / 3;
+    // Per face, and per face vertex: where everything ended up.
+    std::vector<uint8_t> materialOffsets(faceCount), partitions(faceCount * Face::NUM_VERTICES);
+    std::vector<IndexBufferType> indices(faceCount * Face::NUM_VERTICES);
+
+    std::vector<Face> faces(std::min(faceCount, FACE_BATCH_SIZE));
+    std::vector<std::vector<uint32_t>> partitionVertices(WELD_PARTITION_COUNT);
+
+    for (size_t first = 0; first < faceCount; first += FACE_BATCH_SIZE) {
+        const auto count = std::min(FACE_BATCH_SIZE, faceCount - first);
+        auto *pPartitions = &partitions[first * Face::NUM_VERTICES];
+        auto *pIndices = &indices[first * Face::NUM_VERTICES];
+
+        // Faces only depend on themselves until they are indexed.
+        helpers::parallelFor((count + FACE_TASK_SIZE - 1) / FACE_TASK_SIZE, [&](const size_t task) {
+            const auto end = std::min(count, (task + 1) * FACE_TASK_SIZE);
+            for (size_t i = task * FACE_TASK_SIZE; i < end; i++) {
+                materialOffsets[first + i] =
+                    static_cast<uint8_t>(makeFace(data, shape, first + i, pMeshes, settings, faces[i]));
+                faces[i].calculateVertexData(pMeshes);
+                // From the upper half of the hash. The maps use the low bits for their slots.
+                for (uint8_t v = 0; v < Face::NUM_VERTICES; v++)
+                    pPartitions[i * Face::NUM_VERTICES + v] =
+                        static_cast<uint8_t>((typename TMap::Weld()(faces[i][v]) >> (sizeof(size_t) * 4)) %
+                                             WELD_PARTITION_COUNT);
             }
+        });
 
-            // The offset of the face into the vertex list
-            faceOffset = f * 3;
-            index0 = shape.mesh.indices[faceOffset + 0];
-            index1 = shape.mesh.indices[faceOffset + 1];
-            index2 = shape.mesh.indices[faceOffset + 2];
-
-            // Component x, then y, then z per face
-            for (size_t k = 0; k < 3; k++) {
-                // vertex components
-                face[0].position[k] = data.attrib.vertices[3 * static_cast<size_t>(index0.vertex_index) + k];
-                face[1].position[k] = data.attrib.vertices[3 * static_cast<size_t>(index1.vertex_index) + k];
-                face[2].position[k] = data.attrib.vertices[3 * static_cast<size_t>(index2.vertex_index) + k];
-
-                // Color indices share integer offsets with vertex???
-                if (useColors) {
-                    // color components
-                    face[0].color[k] = data.attrib.colors[3 * static_cast<size_t>(index0.vertex_index) + k];
-                    face[1].color[k] = data.attrib.colors[3 * static_cast<size_t>(index1.vertex_index) + k];
-                    face[2].color[k] = data.attrib.colors[3 * static_cast<size_t>(index2.vertex_index) + k];
-                } else {
-                    // color components
-                    face[0].color[k] = COLOR_RED[k];
-                    face[1].color[k] = COLOR_GREEN[k];
-                    face[2].color[k] = COLOR_BLUE[k];
-                }
-
-                // TODO: These currently will never be used...
-                if (useNormals) {
-                    // normal components
-                    face[0].normal[k] = data.attrib.normals[3 * static_cast<size_t>(index0.normal_index) + k];
-                    face[1].normal[k] = data.attrib.normals[3 * static_cast<size_t>(index1.normal_index) + k];
-                    face[2].normal[k] = data.attrib.normals[3 * static_cast<size_t>(index2.normal_index) + k];
-                }
-
-                // Only x, and y component
-                if (useTexCoords && k < 2) {
-                    // texture coordinate components
-                    face[0].texCoord[k] = data.attrib.texcoords[2 * static_cast<size_t>(index0.texcoord_index) + k];
-                    face[1].texCoord[k] = data.attrib.texcoords[2 * static_cast<size_t>(index1.texcoord_index) + k];
-                    face[2].texCoord[k] = data.attrib.texcoords[2 * static_cast<size_t>(index2.texcoord_index) + k];
-                    if (k == 1) {
-                        /*  Vulkan texture coordinates are different from .obj format, so you
-                         *  have to convert the v.
-                         *       (0,1)--------------------------->(1,1)    (0,0)--------------------------->(1,0)
-                         *         ^                                ^        |                                |
-                         *         |                                |        |                                |
-                         *  from   |                                |   to   |                                |
-                         *         |                                |        |                                |
-                         *         |                                |        |                                |
-                         *         |                                |        V                                V
-                         *       (0,0)--------------------------->(1,0)    (0,1)--------------------------->(1,1)
-                         */
-                        face[0].texCoord[k] = 1.0f - face[0].texCoord[k];
-                        face[1].texCoord[k] = 1.0f - face[1].texCoord[k];
-                        face[2].texCoord[k] = 1.0f - face[2].texCoord[k];
-                    }
-                }
+        // Within a partition, indexing has to happen in order.
+        for (auto &vertices : partitionVertices) vertices.clear();
+        for (uint32_t v = 0; v < count * Face::NUM_VERTICES; v++) partitionVertices[pPartitions[v]].push_back(v);
+        helpers::parallelFor(WELD_PARTITION_COUNT, [&](const size_t p) {
+            for (const auto v : partitionVertices[p]) {
+                const auto i = v / Face::NUM_VERTICES;
+                pIndices[v] = faces[i].indexCalculatedVertex(vertexMaps[p], pPartitionParts[p],
+                                                             materialOffsets[first + i], v % Face::NUM_VERTICES);
             }
-            if (settings.geometryInfo.reverseFaceWinding) face.reverseWinding();
-            face.indexVertices(vertexMap, pMeshes, materialOffset);
+        });
+    }
+    vertexMaps.clear();
+
+    // Merge
+    std::vector<std::vector<IndexBufferType>> bases(WELD_PARTITION_COUNT);
+    for (const auto &pMesh : pMeshes) parts.emplace_back(*pMesh);
+    for (size_t p = 0; p < WELD_PARTITION_COUNT; p++) {
+        for (size_t m = 0; m < pMeshes.size(); m++) {
+            bases[p].push_back(static_cast<IndexBufferType>(parts[m].vertices.size()));
+            auto &vertices = partitionParts[p][m].vertices;
+            parts[m].vertices.insert(parts[m].vertices.end(), vertices.begin(), vertices.end());
+        }
+        partitionParts[p].clear();
+    }
+    for (size_t f = 0; f < faceCount; f++) {
+        auto &part = parts[materialOffsets[f]];
+        for (size_t v = f * Face::NUM_VERTICES; v < (f + 1) * Face::NUM_VERTICES; v++)
+            part.addIndex(bases[partitions[v]][materialOffsets[f]] + indices[v]);
+    }
+}
+
+/* Vertices are only welded within a shape, so shapes are indexed in parallel into their own parts of the meshes, and
+ *  then appended to the meshes in shape order with their indices rebased. The result is exactly what indexing the
+ *  shapes one after another gives, whatever the thread count. Large shapes are indexed one at a time instead, each on
+ *  every thread (see "indexLargeShape").
+ */
+template <typename TMap, class TMesh>
+void loadObjData(const tinyobj_data &data, std::vector<TMesh *> &pMeshes, const Mesh::Settings &settings) {
+    std::vector<std::vector<MeshPart<TMesh>>> parts(data.shapes.size());
+
+    std::vector<size_t> smallShapes;
+    for (size_t s = 0; s < data.shapes.size(); s++) {
+        if (data.shapes[s].mesh.indices.size() / 3 > LARGE_SHAPE_FACE_COUNT)
+            indexLargeShape<TMap>(data, data.shapes[s], pMeshes, settings, parts[s]);
+        else
+            smallShapes.push_back(s);
+    }
+    helpers::parallelFor(smallShapes.size(), [&](const size_t i) {
+        const auto s = smallShapes[i];
+        indexShape<TMap>(data, data.shapes[s], pMeshes, settings, parts[s]);
+    });
+
+    // Merge
+    for (auto &shapeParts : parts) {
+        for (size_t m = 0; m < pMeshes.size(); m++) {
+            const auto &part = shapeParts[m];
+            const auto base = static_cast<IndexBufferType>(pMeshes[m]->getVertexCount());
+            pMeshes[m]->addVertices(part.vertices);
+            for (const auto index : part.indices) pMeshes[m]->addIndex(base + index);
         }
+        shapeParts.clear();
     }
     for (auto &pMesh : pMeshes) pMesh->setStatus(STATUS::PENDING_BUFFERS);
 }
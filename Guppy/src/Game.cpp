@@ -41,6 +41,7 @@ Game::Settings::Settings()
 #endif
       noTick(false),
       noRender(false),
+      bake(false),
       trySamplerAnisotropy(true),  // TODO: Not sure what this does
       trySampleRateShading(true),
       tryComputeShading(true),
@@ -55,6 +56,8 @@ Game::Settings::Settings()
       tryDebugMarkers(false),
       tryIndependentBlend(true),
       tryImageCubeArray(true),
+      tryTextureCompressionBC(true),
+      tryBindless(true),  // Falls back to per material descriptor sets if unsupported ("-nbl" to turn it off).
       enableSampleShading(true),
       enableDoubleClicks(false),
       enableDirectoryListener(true),
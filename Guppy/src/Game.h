@@ -64,6 +64,7 @@ class Game {
 
         bool noTick;
         bool noRender;
+        bool bake;  // Exit once every texture is loaded, and so baked.
 
         // *
         bool trySamplerAnisotropy;  // TODO: Not sure what this does
@@ -75,6 +76,8 @@ class Game {
         bool tryDebugMarkers;
         bool tryIndependentBlend;
         bool tryImageCubeArray;
+        bool tryTextureCompressionBC;
+        bool tryBindless;
         bool enableSampleShading;
         bool enableDoubleClicks;
         bool enableDirectoryListener;
@@ -199,6 +202,10 @@ class Game {
                 settings_.noRender = true;
             } else if (*it == "-dbgm") {
                 settings_.tryDebugMarkers = true;
+            } else if (*it == "-nbl") {
+                settings_.tryBindless = false;
+            } else if (*it == "-bake") {
+                settings_.bake = true;
             }
         }
     }
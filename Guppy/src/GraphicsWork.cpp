@@ -25,6 +25,9 @@ Base::Base(Pass::Handler& handler, const CreateInfo* pCreateInfo)
     assert(PIPELINE_TYPES.size());
 }
 
+// Works are reset without "onDestroy" (see "Ocean::Renderer::reset"), so the load callback is cancelled here.
+Base::~Base() { handler().loadingHandler().cancelCallbacks(this); }
+
 void Base::onDestroy() {
     destroy();
     drawMode = GRAPHICS::ALL_ENUM;
@@ -51,8 +54,10 @@ void Base::onTick() {
     if ((status_ & STATUS::PENDING_BUFFERS)) {
         auto pLdgRes = handler().loadingHandler().createLoadingResources();
         load(pLdgRes);
-        handler().loadingHandler().loadSubmit(std::move(std::move(pLdgRes)));
+        handler().loadingHandler().loadSubmit(
+            std::move(pLdgRes), [this]() { status_ ^= STATUS::PENDING_LOADING; }, this);
         status_ ^= STATUS::PENDING_BUFFERS;
+        status_ |= STATUS::PENDING_LOADING;
     }
 }
 
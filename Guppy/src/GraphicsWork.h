@@ -34,6 +34,7 @@ class Base : public Handlee<Pass::Handler> {
     const std::set<PIPELINE> PIPELINE_TYPES;
 
     Base(Pass::Handler& handler, const CreateInfo* pCreateInfo);
+    virtual ~Base();
 
     void onInit() { init(); }
     void onDestroy();
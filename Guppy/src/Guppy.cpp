@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <functional>
 #include <queue>
+#include <thread>
 
 #include "ComputeWorkManager.h"
 #include "ConstantsAll.h"
@@ -80,7 +81,8 @@ Guppy::Guppy(const std::vector<std::string>& args)
     // TODO: use these or get rid of them...
     multithread_(true),
     use_push_constants_(false),
-    sim_paused_(false)
+    sim_paused_(false),
+    benchmark_instances_(false)
     // sim_fade_(false),
     // sim_(5000),
 // clang-format on
@@ -91,9 +93,9 @@ Guppy::Guppy(const std::vector<std::string>& args)
             multithread_ = false;
         else if (*it == "-p")
             use_push_constants_ = true;
+        else if (*it == "-ib")
+            benchmark_instances_ = true;
     }
-
-    // init_workers();
 }
 
 Guppy::~Guppy() {}
@@ -116,6 +118,8 @@ void Guppy::attachShell() {
     handlers_.pModel->init();
     handlers_.pScene->init();
 
+    if (benchmark_instances_) handlers_.pMesh->benchmarkInstanceMemory();
+
     // SHELL LISTENERS
     if (settings().enableDirectoryListener) {
         watchDirectory(Shader::BASE_DIRNAME,
@@ -123,7 +127,8 @@ void Guppy::attachShell() {
     }
 
     if (multithread_) {
-        // for (auto &worker : workers_) worker->start();
+        // Secondary command buffer recording (hardware_concurrency can be 0 if it is unknown).
+        handlers_.pCommand->startWorkers(std::max(std::thread::hardware_concurrency(), 1u));
     }
 }
 
@@ -161,6 +166,9 @@ void Guppy::tick() {
     handlers_.pParticle->tick();
     handlers_.pScene->tick();
 
+    // "-bake" is done once nothing that can make a texture is still loading. Every sampler is baked by then.
+    if (settings().bake && !handlers_.pModel->isLoading() && !handlers_.pTexture->isLoading()) shell().quit();
+
     // ComputeWorkManager assumes this is at least called once per frame, and before each frame.
     handlers_.pPass->tick();
 
@@ -179,6 +187,7 @@ void Guppy::frame() {
     handlers_.pUniform->frame();  // Camera updates happen here... this seems bad.
     handlers_.pScene->frame();
     handlers_.pParticle->frame();
+    handlers_.pMesh->frame();  // After anything that writes instance data.
     // DRAW
     handlers_.pPass->frame();
     // POST-DRAW
@@ -201,9 +210,11 @@ void Guppy::detachShell() {
     // TODO: kill futures !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
     if (multithread_) {
-        // for (auto &worker : workers_) worker->stop();
+        handlers_.pCommand->stopWorkers();
     }
 
+    // Finish any loads before the resources they write to are destroyed.
+    handlers_.pLoading->destroy();
     handlers_.pPipeline->destroy();
     handlers_.pShader->destroy();
     handlers_.pDescriptor->destroy();
@@ -216,7 +227,6 @@ void Guppy::detachShell() {
     handlers_.pUI->destroy();
     handlers_.pPass->destroy();
     handlers_.pCommand->destroy();
-    handlers_.pLoading->destroy();
 }
 
 void Guppy::processInput() {
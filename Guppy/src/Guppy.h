@@ -53,6 +53,7 @@ class Guppy : public Game {
     bool multithread_;
     bool use_push_constants_;
     bool sim_paused_;
+    bool benchmark_instances_;  // "-ib": log how each instance memory type performs at startup.
     // bool sim_fade_;
     // Simulation sim_;
 };
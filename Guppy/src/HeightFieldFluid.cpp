@@ -425,27 +425,21 @@ void Buffer::loadBuffers() {
     pLdgRes_ = handler().loadingHandler().createLoadingResources();
 
     // VERTEX
-    BufferResource stgRes = {};
-    ctx.createBuffer(pLdgRes_->transferCmd, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                     sizeof(VertexData) * verticesHFF_.size(), NAME + " vertex", stgRes, verticesHFFRes_,
+    ctx.createBuffer(*pLdgRes_, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+                     sizeof(VertexData) * verticesHFF_.size(), NAME + " vertex", verticesHFFRes_,
                      verticesHFF_.data());
-    pLdgRes_->stgResources.push_back(std::move(stgRes));
 
     // INDEX (SURFACE)
     assert(indices_.size());
-    stgRes = {};
-    ctx.createBuffer(pLdgRes_->transferCmd, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                     sizeof(IndexBufferType) * indices_.size(), NAME + " index (surface)", stgRes, indexRes_,
+    ctx.createBuffer(*pLdgRes_, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+                     sizeof(IndexBufferType) * indices_.size(), NAME + " index (surface)", indexRes_,
                      indices_.data());
-    pLdgRes_->stgResources.push_back(std::move(stgRes));
 
     // INDEX (WIREFRAME)
     assert(indicesWF_.size());
-    stgRes = {};
-    ctx.createBuffer(pLdgRes_->transferCmd, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                     sizeof(IndexBufferType) * indicesWF_.size(), NAME + " index (wireframe)", stgRes, indexWFRes_,
+    ctx.createBuffer(*pLdgRes_, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+                     sizeof(IndexBufferType) * indicesWF_.size(), NAME + " index (wireframe)", indexWFRes_,
                      indicesWF_.data());
-    pLdgRes_->stgResources.push_back(std::move(stgRes));
 }
 
 void Buffer::destroy() {
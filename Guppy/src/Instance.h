@@ -71,12 +71,12 @@ class Base : public ::Obj3d::AbstractBase, public Buffer::DataItem<DATA>, public
 
     inline void transform(const glm::mat4 t, const uint32_t index = 0) override {
         ::Obj3d::AbstractBase::transform(std::forward<const glm::mat4>(t), std::forward<const uint32_t>(index));
-        dirty = true;
+        setSlotDirty(index);
     }
     void putOnTop(const ::Obj3d::BoundingBoxMinMax& inBoundingBoxMinMax, const uint32_t index = MODEL_ALL) override;
     inline void setModel(const glm::mat4 m, const uint32_t index = 0) override {
         ::Obj3d::AbstractBase::setModel(std::forward<const glm::mat4>(m), std::forward<const uint32_t>(index));
-        dirty = true;
+        setSlotDirty(index);
     }
 
    protected:
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "InstanceManager.h"
+
+#include <algorithm>
+
+namespace {
+
+// Heaps smaller than this are treated as a BAR window. They are usually 256MB, and other things want them too.
+constexpr vk::DeviceSize MIN_DEVICE_HOST_HEAP_SIZE = 1024ull * 1024 * 1024;
+
+}  // namespace
+
+namespace Instance {
+
+vk::MemoryPropertyFlags GetMemoryProperties(const MEMORY memory) {
+    switch (memory) {
+        case MEMORY::DEVICE_HOST:
+            return vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible;
+        case MEMORY::STAGED:
+            return vk::MemoryPropertyFlagBits::eDeviceLocal;
+        case MEMORY::AUTO:
+        case MEMORY::AUTO_STAGED:
+        case MEMORY::HOST:
+            return vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        default:
+            assert(false);
+            exit(EXIT_FAILURE);
+    }
+}
+
+bool HasDeviceHostMemory(const Context& ctx, const vk::DeviceSize blockSize) {
+    const auto& memProps = ctx.pMemAllocator->getMemoryProperties();
+    const auto properties = GetMemoryProperties(MEMORY::DEVICE_HOST);
+    // The allocator takes the first memory type that matches, so only that one matters.
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if ((memProps.memoryTypes[i].propertyFlags & properties) != properties) continue;
+        const auto& heap = memProps.memoryHeaps[memProps.memoryTypes[i].heapIndex];
+        return heap.size >= std::max(MIN_DEVICE_HOST_HEAP_SIZE, blockSize * 4);
+    }
+    return false;
+}
+
+MEMORY ResolveMemory(const Context& ctx, const MEMORY memory, const vk::DeviceSize blockSize) {
+    if (memory != MEMORY::AUTO && memory != MEMORY::AUTO_STAGED) return memory;
+#if (defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
+    // This has always been host memory with MoltenVK.
+    return MEMORY::HOST;
+#else
+    if (HasDeviceHostMemory(ctx, blockSize)) return MEMORY::DEVICE_HOST;
+    return (memory == MEMORY::AUTO_STAGED) ? MEMORY::STAGED : MEMORY::HOST;
+#endif
+}
+
+const char* GetMemoryName(const MEMORY memory) {
+    // clang-format off
+    switch (memory) {
+        case MEMORY::AUTO:        return "AUTO";
+        case MEMORY::AUTO_STAGED: return "AUTO_STAGED";
+        case MEMORY::DEVICE_HOST: return "DEVICE_HOST";
+        case MEMORY::HOST:        return "HOST";
+        case MEMORY::STAGED:      return "STAGED";
+        default: assert(false); exit(EXIT_FAILURE);
+    }
+    // clang-format on
+}
+
+}  // namespace Instance
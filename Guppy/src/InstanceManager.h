@@ -11,14 +11,37 @@
 #include <type_traits>
 #include <vulkan/vulkan.hpp>
 
+#include <Common/Context.h>
+
 #include "Constants.h"
 #include "BufferManager.h"
 #include "Instance.h"
 
 namespace Instance {
 
+// Where a manager's blocks live.
+enum class MEMORY {
+    AUTO = 0,     // DEVICE_HOST if it is worth it (see "ResolveMemory"), otherwise HOST.
+    AUTO_STAGED,  // DEVICE_HOST if it is worth it, otherwise STAGED.
+    DEVICE_HOST,  // Device local and host visible (resizable BAR, or unified memory). Written directly.
+    HOST,         // Host visible system memory. Written directly, and read by the device over the bus.
+    STAGED,       // Device local only. Written through a staging ring when a batch ends (see "Buffer::Manager::Base").
+};
+
+/* Non-coherent memory types are fine for DEVICE_HOST, since writes are flushed per contiguous span when a batch ends.
+ *  The AUTO values are what the manager asks for until "init" resolves them.
+ */
+vk::MemoryPropertyFlags GetMemoryProperties(const MEMORY memory);
+// DEVICE_HOST is only picked if its heap is big enough that blocks of "blockSize" don't crowd out everything else.
+bool HasDeviceHostMemory(const Context& ctx, const vk::DeviceSize blockSize);
+MEMORY ResolveMemory(const Context& ctx, const MEMORY memory, const vk::DeviceSize blockSize);
+const char* GetMemoryName(const MEMORY memory);
+
 // TODO: I think that this class should probably go away at this point, and I should just use the Descriptor::Manager.
 
+/* A STAGED manager can only be updated inside of a batch that is ended with a staging ring and a command buffer. Only
+ *  ask for AUTO_STAGED, or STAGED, if the owner does that.
+ */
 template <class TBase, class TDerived>
 class Manager : public Buffer::Manager::Base<TBase, TDerived, std::shared_ptr> {
     static_assert(std::is_base_of<Instance::Base, TBase>::value, "TBase must be a descendant of Instance::Base");
@@ -26,29 +49,37 @@ class Manager : public Buffer::Manager::Base<TBase, TDerived, std::shared_ptr> {
 
    public:
     Manager(const std::string&& name, const vk::DeviceSize&& maxSize, const bool&& keepMapped = true,
-            const vk::BufferUsageFlagBits&& usage = vk::BufferUsageFlagBits::eVertexBuffer)
+            const vk::BufferUsageFlags&& usage = vk::BufferUsageFlagBits::eVertexBuffer,
+            const MEMORY&& memory = MEMORY::AUTO)
         : TManager(
               //
               std::forward<const std::string>(name),        //
               std::forward<const vk::DeviceSize>(maxSize),  //
               std::forward<const bool>(keepMapped),         //
-              std::forward<const vk::BufferUsageFlagBits>(usage),
-              // This used to not have the vk::MemoryPropertyFlagBits::eHostCoherent set. It was needed to work
-              // with the macOS build. TBH I am not sure which would be faster - using the coherent bit,
-              // or flusing and invalidating. I just set the bit because I didn't know how to test it atm.
-              (vk::MemoryPropertyFlagBits::eHostVisible
-#if !(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
-                | vk::MemoryPropertyFlagBits::eDeviceLocal
-#endif
-               | vk::MemoryPropertyFlagBits::eHostCoherent)) {
-    }
+              std::forward<const vk::BufferUsageFlags>(usage),
+              // This used to be host visible, device local, and coherent no matter what. That fails on devices that
+              // only have a small window of device local memory that the host can see (no resizable BAR).
+              GetMemoryProperties(memory)),
+          MEMORY_REQUEST(memory),
+          memory_(memory) {}
     virtual ~Manager() = default;
 
     const DESCRIPTOR DESCRIPTOR_TYPE;
+    const MEMORY MEMORY_REQUEST;
+
+    void init(const Context& ctx, std::vector<uint32_t> queueFamilyIndices = {}) override {
+        memory_ = ResolveMemory(ctx, MEMORY_REQUEST, TManager::MAX_SIZE * TManager::alignment_);
+        TManager::properties_ = GetMemoryProperties(memory_);
+        TManager::init(ctx, queueFamilyIndices);
+    }
+
+    inline MEMORY getMemory() const { return memory_; }
 
    private:
     // TODO: Should this, and in turn the entire class, be derived from Descriptor::Manager?
     void setInfo(Buffer::Info& info) override { info.bufferInfo.offset = 0; }
+
+    MEMORY memory_;
 };
 
 }  // namespace Instance
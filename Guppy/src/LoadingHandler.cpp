@@ -5,6 +5,8 @@
 
 #include "LoadingHandler.h"
 
+#include <algorithm>
+
 #include "Constants.h"
 #include "Shell.h"
 // HANDLERS
@@ -19,137 +21,194 @@ void Loading::Handler::init() {
 
 // This used to be called cleanup but was executed during onTick, so I changed the name.
 void Loading::Handler::tick() {
-    // Check loading resources for cleanup
-    if (!ldgResources_.empty()) {
-        auto itRes = ldgResources_.begin();
-        while (itRes != ldgResources_.end()) {
-            auto& pRes = (*itRes);
-            // Check if mesh loading resources can be cleaned up.
-            if (destroyResource(*pRes)) {
-                // Remove the resources from the list if all goes well.
-                itRes = ldgResources_.erase(itRes);
-            } else {
-                ++itRes;
-            }
+    // Anything requested since the last tick goes out together.
+    submit();
+
+    // Check submitted batches for cleanup
+    auto itBatch = pSubmitted_.begin();
+    while (itBatch != pSubmitted_.end()) {
+        if (isFinished(**itBatch)) {
+            recycle(**itBatch);
+            pFree_.push_back(std::move(*itBatch));
+            itBatch = pSubmitted_.erase(itBatch);
+        } else {
+            ++itBatch;
         }
     }
 }
 
-// thread sync
-std::unique_ptr<LoadingResource> Loading::Handler::createLoadingResources() const {
-    auto pLdgRes = std::make_unique<LoadingResource>();
+void Loading::Handler::destroy() {
+    const auto& ctx = shell().context();
+    submit();
+    std::vector<vk::Fence> fences;
+    getFences(fences);
+    if (!fences.empty()) {
+        auto result = ctx.dev.waitForFences(fences, VK_TRUE, UINT64_MAX);
+        assert(result == vk::Result::eSuccess);
+    }
+    tick();
+    reset();
+}
 
-    // There should always be at least a graphics queue...
-    vk::CommandBufferAllocateInfo allocInfo = {commandHandler().graphicsCmdPool(), vk::CommandBufferLevel::ePrimary, 1};
-    pLdgRes->graphicsCmd = shell().context().dev.allocateCommandBuffers(allocInfo).front();
-    // being recording
-    commandHandler().beginCmd(pLdgRes->graphicsCmd);
+void Loading::Handler::reset() {
+    if (pRecording_) destroyBatch(*pRecording_);
+    pRecording_ = nullptr;
+    for (auto& pBatch : pSubmitted_) destroyBatch(*pBatch);
+    pSubmitted_.clear();
+    for (auto& pBatch : pFree_) destroyBatch(*pBatch);
+    pFree_.clear();
+}
 
-    // There might not be a dedicated transfer queue...
-    if (commandHandler().graphicsIndex() != commandHandler().transferIndex()) {
-        allocInfo.commandPool = commandHandler().transferCmdPool();
-        pLdgRes->transferCmd = shell().context().dev.allocateCommandBuffers(allocInfo).front();
+// thread sync
+std::unique_ptr<LoadingResource> Loading::Handler::createLoadingResources() {
+    if (pRecording_ == nullptr) {
+        if (pFree_.empty()) {
+            pRecording_ = makeBatch();
+        } else {
+            pRecording_ = std::move(pFree_.back());
+            pFree_.pop_back();
+        }
         // being recording
-        commandHandler().beginCmd(pLdgRes->transferCmd);
+        commandHandler().beginCmd(pRecording_->graphicsCmd);
+        if (hasTransferQueue()) commandHandler().beginCmd(pRecording_->transferCmd);
     }
 
+    auto pLdgRes = std::make_unique<LoadingResource>();
+    pLdgRes->shouldWait = hasTransferQueue();
+    pLdgRes->graphicsCmd = pRecording_->graphicsCmd;
+    // There might not be a dedicated transfer queue...
+    pLdgRes->transferCmd = hasTransferQueue() ? pRecording_->transferCmd : pRecording_->graphicsCmd;
     return pLdgRes;
 }
 
-void Loading::Handler::loadSubmit(std::unique_ptr<LoadingResource> pLdgRes) {
-    const auto& ctx = shell().context();
+void Loading::Handler::loadSubmit(std::unique_ptr<LoadingResource> pLdgRes, std::function<void()> callback,
+                                  const void* pOwner) {
+    assert(pRecording_ && pLdgRes->graphicsCmd == pRecording_->graphicsCmd &&
+           "Loading resource was not created for the current batch");
 
-    auto queueFamilyIndices = commandHandler().getUniqueQueueFamilies(true, false, true, false);
-    pLdgRes->shouldWait = queueFamilyIndices.size() > 1;
+    // The staging resources now live until the batch is finished.
+    auto& stgResources = pRecording_->stgResources;
+    stgResources.insert(stgResources.end(), pLdgRes->stgResources.begin(), pLdgRes->stgResources.end());
+    pLdgRes->stgResources.clear();
 
-    // End buffer recording
-    pLdgRes->graphicsCmd.end();
-    if (pLdgRes->shouldWait) pLdgRes->transferCmd.end();
+    if (callback) pRecording_->callbacks.push_back({pOwner, std::move(callback)});
+    pRecording_->loadCount++;
+}
 
-    // Fences for cleanup ...
-    for (int i = 0; i < queueFamilyIndices.size(); i++) {
-        vk::FenceCreateInfo fenceInfo = {};
-        pLdgRes->fences.push_back(ctx.dev.createFence(fenceInfo, ctx.pAllocator));
-    }
+void Loading::Handler::cancelCallbacks(const void* pOwner) {
+    assert(pOwner);
+    auto cancel = [pOwner](Batch& batch) {
+        auto& callbacks = batch.callbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                       [pOwner](const auto& callback) { return callback.first == pOwner; }),
+                        callbacks.end());
+    };
+    if (pRecording_) cancel(*pRecording_);
+    for (auto& pBatch : pSubmitted_) cancel(*pBatch);
+}
+
+void Loading::Handler::submit() {
+    if (pRecording_ == nullptr || pRecording_->loadCount == 0) return;
+    auto& batch = *pRecording_;
 
-    // Semaphore
-    vk::SemaphoreCreateInfo semaphoreInfo = {};
-    pLdgRes->semaphore = ctx.dev.createSemaphore(semaphoreInfo, ctx.pAllocator);
+    // Make everything written by the batch visible to whatever uses it next on the graphics queue. Resources written
+    // on the transfer queue have already been acquired by the graphics command buffer at this point.
+    vk::MemoryBarrier barrier = {vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead};
+    batch.graphicsCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {},
+                                      {barrier}, {}, {});
+
+    // End buffer recording
+    batch.graphicsCmd.end();
+    if (hasTransferQueue()) batch.transferCmd.end();
 
     // Wait stages
-    vk::PipelineStageFlags wait_stages[] = {vk::PipelineStageFlagBits::eTransfer};
-
-    // Staging submit info
-    vk::SubmitInfo stagSubInfo = {};
-    // Wait
-    stagSubInfo.waitSemaphoreCount = 0;
-    stagSubInfo.pWaitSemaphores = nullptr;
-    stagSubInfo.pWaitDstStageMask = 0;
-    // Command buffers
-    stagSubInfo.commandBufferCount = 1;
-    stagSubInfo.pCommandBuffers = &pLdgRes->transferCmd;
-    // Signal
-    stagSubInfo.signalSemaphoreCount = 1;
-    stagSubInfo.pSignalSemaphores = &pLdgRes->semaphore;
-
-    // Wait submit info
-    vk::SubmitInfo waitSubInfo = {};
-    if (pLdgRes->shouldWait) {
-        // Wait
-        waitSubInfo.waitSemaphoreCount = 1;
-        waitSubInfo.pWaitSemaphores = &pLdgRes->semaphore;
-        waitSubInfo.pWaitDstStageMask = wait_stages;
-        // Command buffers
-        waitSubInfo.commandBufferCount = 1;
-        waitSubInfo.pCommandBuffers = &pLdgRes->graphicsCmd;
-        // Signal
-        waitSubInfo.signalSemaphoreCount = 0;
-        waitSubInfo.pSignalSemaphores = nullptr;
-    }
+    vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eTransfer};
+
+    // Graphics submit info
+    vk::SubmitInfo graphicsSubInfo = {};
+    graphicsSubInfo.commandBufferCount = 1;
+    graphicsSubInfo.pCommandBuffers = &batch.graphicsCmd;
 
     // Sumbit ...
-    if (pLdgRes->shouldWait) {
-        commandHandler().transferQueue().submit({stagSubInfo}, pLdgRes->fences[0]);
+    if (hasTransferQueue()) {
+        // Staging submit info
+        vk::SubmitInfo stagSubInfo = {};
+        stagSubInfo.commandBufferCount = 1;
+        stagSubInfo.pCommandBuffers = &batch.transferCmd;
+        stagSubInfo.signalSemaphoreCount = 1;
+        stagSubInfo.pSignalSemaphores = &batch.semaphore;
+        commandHandler().transferQueue().submit({stagSubInfo}, batch.transferFence);
+
+        graphicsSubInfo.waitSemaphoreCount = 1;
+        graphicsSubInfo.pWaitSemaphores = &batch.semaphore;
+        graphicsSubInfo.pWaitDstStageMask = waitStages;
     }
-    commandHandler().graphicsQueue().submit({waitSubInfo}, pLdgRes->fences[1]);
+    commandHandler().graphicsQueue().submit({graphicsSubInfo}, batch.graphicsFence);
 
-    ldgResources_.push_back(std::move(pLdgRes));
+    pSubmitted_.push_back(std::move(pRecording_));
 }
 
 void Loading::Handler::getFences(std::vector<vk::Fence>& fences) {
-    for (const auto& res : ldgResources_) fences.insert(fences.end(), res->fences.begin(), res->fences.end());
+    for (const auto& pBatch : pSubmitted_) {
+        fences.push_back(pBatch->graphicsFence);
+        if (pBatch->transferFence) fences.push_back(pBatch->transferFence);
+    }
 }
 
-bool Loading::Handler::destroyResource(LoadingResource& resource) const {
+std::unique_ptr<Loading::Handler::Batch> Loading::Handler::makeBatch() const {
     const auto& ctx = shell().context();
+    auto pBatch = std::make_unique<Batch>();
 
-    // Check fences for cleanup
-    bool ready = true;
-    for (auto& fence : resource.fences) ready &= ctx.dev.getFenceStatus(fence) == vk::Result::eSuccess;
+    // There should always be at least a graphics queue...
+    vk::CommandBufferAllocateInfo allocInfo = {commandHandler().graphicsCmdPool(), vk::CommandBufferLevel::ePrimary, 1};
+    pBatch->graphicsCmd = ctx.dev.allocateCommandBuffers(allocInfo).front();
+    pBatch->graphicsFence = ctx.dev.createFence({}, ctx.pAllocator);
 
-    if (ready) {
-        // Free stating resources
-        for (auto& res : resource.stgResources) {
-            ctx.dev.destroyBuffer(res.buffer, ctx.pAllocator);
-            ctx.dev.freeMemory(res.memory, ctx.pAllocator);
-        }
-        resource.stgResources.clear();
+    if (hasTransferQueue()) {
+        allocInfo.commandPool = commandHandler().transferCmdPool();
+        pBatch->transferCmd = ctx.dev.allocateCommandBuffers(allocInfo).front();
+        pBatch->transferFence = ctx.dev.createFence({}, ctx.pAllocator);
+        pBatch->semaphore = ctx.dev.createSemaphore({}, ctx.pAllocator);
+    }
 
-        // Free fences
-        for (auto& fence : resource.fences) ctx.dev.destroyFence(fence, ctx.pAllocator);
-        resource.fences.clear();
+    return pBatch;
+}
 
-        // Free semaphores
-        ctx.dev.destroySemaphore(resource.semaphore, ctx.pAllocator);
+bool Loading::Handler::isFinished(const Batch& batch) const {
+    const auto& ctx = shell().context();
+    if (ctx.dev.getFenceStatus(batch.graphicsFence) != vk::Result::eSuccess) return false;
+    if (batch.transferFence && ctx.dev.getFenceStatus(batch.transferFence) != vk::Result::eSuccess) return false;
+    return true;
+}
 
-        // Free command buffers
-        ctx.dev.freeCommandBuffers(commandHandler().graphicsCmdPool(), 1, &resource.graphicsCmd);
-        if (resource.shouldWait) {
-            ctx.dev.freeCommandBuffers(commandHandler().transferCmdPool(), 1, &resource.transferCmd);
-        }
+void Loading::Handler::recycle(Batch& batch) {
+    const auto& ctx = shell().context();
 
-        return true;
-    }
+    // Free staging resources
+    for (auto& res : batch.stgResources) ctx.destroyBuffer(res);
+    batch.stgResources.clear();
+
+    // Wake up the owners
+    for (auto& [pOwner, callback] : batch.callbacks) callback();
+    batch.callbacks.clear();
+    batch.loadCount = 0;
+
+    // Reset everything else for the next batch.
+    ctx.dev.resetFences({batch.graphicsFence});
+    if (batch.transferFence) ctx.dev.resetFences({batch.transferFence});
+    batch.graphicsCmd.reset({});
+    if (batch.transferCmd) batch.transferCmd.reset({});
+}
+
+void Loading::Handler::destroyBatch(Batch& batch) const {
+    const auto& ctx = shell().context();
+
+    for (auto& res : batch.stgResources) ctx.destroyBuffer(res);
+    batch.stgResources.clear();
+
+    if (batch.graphicsFence) ctx.dev.destroyFence(batch.graphicsFence, ctx.pAllocator);
+    if (batch.transferFence) ctx.dev.destroyFence(batch.transferFence, ctx.pAllocator);
+    if (batch.semaphore) ctx.dev.destroySemaphore(batch.semaphore, ctx.pAllocator);
 
-    return false;
+    // The command buffers are freed with the command handler's pools.
 }
@@ -6,7 +6,9 @@
 #ifndef LDG_RESOURCE_HANDLER_H
 #define LDG_RESOURCE_HANDLER_H
 
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -17,24 +19,53 @@
 
 namespace Loading {
 
+/* Every load requested between submits is recorded into the same command buffer per queue family, and submitted
+ *  together. A batch only has one fence per queue (and one semaphore between the transfer and graphics submits), and
+ *  the command buffers, fences, and semaphore are recycled once the batch is finished. The render pass manager submits
+ *  any pending batch before each frame, so loads still complete before anything that was recorded after them is drawn.
+ */
 class Handler : public Game::Handler {
    public:
     Handler(Game *pGame);
 
     void init() override;
     void tick() override;
-    inline void destroy() override { tick(); };
-
-    std::unique_ptr<LoadingResource> createLoadingResources() const;
-    void loadSubmit(std::unique_ptr<LoadingResource> pLdgRes);
+    void destroy() override;
 
-    void getFences(std::vector<vk::Fence> &fences);
+    // Returns a resource that records into the current batch. Hand it back with "loadSubmit" when done recording.
+    std::unique_ptr<LoadingResource> createLoadingResources();
+    /* "callback" is called once the load has finished on the device, and its staging resources have been freed. A
+     *  callback that uses "pOwner" has to pass it, and the owner has to call "cancelCallbacks" when it is destroyed,
+     *  since the batch can outlive it.
+     */
+    void loadSubmit(std::unique_ptr<LoadingResource> pLdgRes, std::function<void()> callback = nullptr,
+                    const void *pOwner = nullptr);
+    // Drop the callbacks of "pOwner" that have not been called yet.
+    void cancelCallbacks(const void *pOwner);
+    // Submit the current batch if anything was recorded.
+    void submit();
 
    private:
-    void reset() override{};
-    bool destroyResource(LoadingResource &resource) const;
+    struct Batch {
+        vk::CommandBuffer graphicsCmd, transferCmd;
+        vk::Fence graphicsFence, transferFence;
+        vk::Semaphore semaphore;
+        std::vector<BufferResource> stgResources;
+        std::vector<std::pair<const void *, std::function<void()>>> callbacks;
+        uint32_t loadCount = 0;
+    };
+
+    void reset() override;
+    inline bool hasTransferQueue() const { return commandHandler().graphicsIndex() != commandHandler().transferIndex(); }
+    std::unique_ptr<Batch> makeBatch() const;
+    bool isFinished(const Batch &batch) const;
+    void recycle(Batch &batch);
+    void destroyBatch(Batch &batch) const;
+    void getFences(std::vector<vk::Fence> &fences);
 
-    std::vector<std::unique_ptr<LoadingResource>> ldgResources_;
+    std::unique_ptr<Batch> pRecording_;
+    std::vector<std::unique_ptr<Batch>> pSubmitted_;
+    std::vector<std::unique_ptr<Batch>> pFree_;
 };
 
 }  // namespace Loading
@@ -14,7 +14,8 @@
 Material::Base::Base(const DESCRIPTOR &&descType, const CreateInfo *pCreateInfo)  //
     : Descriptor::Base(std::forward<const DESCRIPTOR>(descType)),
       pTexture_(pCreateInfo->pTexture),
-      repeat_(pCreateInfo->repeat) {
+      repeat_(pCreateInfo->repeat),
+      bindlessBufferIndex_(UINT32_MAX) {
     status_ = (hasTexture() && pTexture_->status != STATUS::READY) ? STATUS::PENDING_TEXTURE : STATUS::READY;
 }
 
@@ -78,11 +78,19 @@ struct DATA {
 // BASE
 
 class Base : public Descriptor::Base {
+    friend class Handler;
+
    public:
     virtual_inline STATUS getStatus() const { return status_; }
     inline bool hasTexture() const { return pTexture_ != nullptr; }
     virtual_inline const auto& getTexture() const { return pTexture_; }
     virtual_inline const auto& getRepeat() const { return repeat_; }
+    // Slot of the texture's first sampler in the bindless sampler array, or UINT32_MAX.
+    inline uint32_t getBindlessSamplerIndex() const {
+        return hasTexture() ? pTexture_->samplers.front().bindlessIndex : UINT32_MAX;
+    }
+    // Slot of the material's data in the bindless storage buffer array, or UINT32_MAX. Only default materials get one.
+    inline uint32_t getBindlessBufferIndex() const { return bindlessBufferIndex_; }
 
     virtual FlagBits getFlags() = 0;
     virtual void setFlags(FlagBits flags) = 0;
@@ -101,6 +109,9 @@ class Base : public Descriptor::Base {
     // TEXTURE
     std::shared_ptr<Texture::Base> pTexture_;
     float repeat_;
+
+   private:
+    uint32_t bindlessBufferIndex_;
 };
 
 // FUNCTIONS
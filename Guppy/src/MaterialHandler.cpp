@@ -5,6 +5,7 @@
 
 #include "MaterialHandler.h"
 
+#include "DescriptorHandler.h"
 #include "Shell.h"
 
 Material::Handler::Handler(Game* pGame)
@@ -27,7 +28,26 @@ void Material::Handler::updateTexture(const std::shared_ptr<Texture::Base>& pTex
     obj3dMgr_.updateTexture(shell().context().dev, pTexture);
 }
 
+void Material::Handler::addBindless(Material::Base& material) {
+    // Bindless pipelines read the data out of the storage buffer array instead of a dynamic uniform binding.
+    if (!descriptorHandler().bindless().isEnabled()) return;
+    const auto& bufferInfo = material.BUFFER_INFO;
+    material.bindlessBufferIndex_ = descriptorHandler().addBindless(
+        vk::DescriptorBufferInfo{bufferInfo.bufferInfo.buffer, bufferInfo.memoryOffset, bufferInfo.bufferInfo.range});
+    if (material.bindlessBufferIndex_ == Descriptor::Bindless::INVALID_INDEX)
+        shell().log(Shell::LogPriority::LOG_WARN, "Bindless storage buffer array is full");
+}
+
+void Material::Handler::releaseBindless(Material::Base& material) {
+    if (material.bindlessBufferIndex_ == Descriptor::Bindless::INVALID_INDEX) return;
+    // The bindless set goes away first on shutdown.
+    if (descriptorHandler().bindless().isEnabled())
+        descriptorHandler().releaseBindless(Descriptor::Bindless::ARRAY::STORAGE_BUFFER, material.bindlessBufferIndex_);
+    material.bindlessBufferIndex_ = Descriptor::Bindless::INVALID_INDEX;
+}
+
 void Material::Handler::reset() {
+    for (auto& pMaterial : defMgr_.pItems) releaseBindless(*pMaterial);
     defMgr_.destroy(shell().context());
     pbrMgr_.destroy(shell().context());
     obj3dMgr_.destroy(shell().context());
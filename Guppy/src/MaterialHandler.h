@@ -85,6 +85,7 @@ class Handler : public Game::Handler {
     template <>
     std::shared_ptr<Material::Base> &makeMaterial(Material::Default::CreateInfo *pCreateInfo) {
         defMgr_.insert(shell().context().dev, pCreateInfo);
+        addBindless(*defMgr_.pItems.back());
         return defMgr_.pItems.back();
     }
     // PBR
@@ -103,6 +104,10 @@ class Handler : public Game::Handler {
    private:
     void reset() override;
 
+    // BINDLESS
+    void addBindless(Material::Base &material);
+    void releaseBindless(Material::Base &material);
+
     // clang-format off
     template <class T> inline Manager<T>& getManager() { /*static_assert(false, "Not implemented");*/ }
     template <> inline Manager<Material::Default::Base>& getManager() { return defMgr_; }
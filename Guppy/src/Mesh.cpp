@@ -10,11 +10,13 @@
 #include "Face.h"
 #include "FileLoader.h"
 #include "PBR.h"  // TODO: this is bad
+#include "RenderPassManager.h"
 // HANDLERS
 #include "DescriptorHandler.h"
 #include "LoadingHandler.h"
 #include "MaterialHandler.h"
 #include "MeshHandler.h"
+#include "PassHandler.h"
 #include "PipelineHandler.h"
 #include "SceneHandler.h"
 #include "TextureHandler.h"
@@ -78,13 +80,19 @@ void Mesh::Base::prepare() {
 
     if (status_ == STATUS::PENDING_BUFFERS) {
         loadBuffers();
-        // Submit vertex loading commands...
-        handler().loadingHandler().loadSubmit(std::move(pLdgRes_));
+        // Submit vertex loading commands. The callback runs once the device is done with them.
+        handler().loadingHandler().loadSubmit(
+            std::move(pLdgRes_),
+            [this]() {
+                status_ ^= STATUS::PENDING_LOADING;
+                if (status_ == STATUS::READY) setReady();
+            },
+            this);
         // Screen quad mesh only needs vertex/index buffers
         if (PIPELINE_TYPE == PIPELINE{GRAPHICS::ALL_ENUM} && PASS_TYPES.empty())
-            status_ = STATUS::READY;
+            status_ = STATUS::PENDING_LOADING;
         else
-            status_ = STATUS::PENDING_MATERIAL | STATUS::PENDING_PIPELINE;
+            status_ = STATUS::PENDING_LOADING | STATUS::PENDING_MATERIAL | STATUS::PENDING_PIPELINE;
     }
 
     if (status_ & STATUS::PENDING_MATERIAL) {
@@ -107,15 +115,22 @@ void Mesh::Base::prepare() {
      *  can allocate and update all at once.
      */
     if (status_ == STATUS::READY) {
-        // Screen quad mesh will not keep track of descriptor data.
-        if (PIPELINE_TYPE == PIPELINE{GRAPHICS::ALL_ENUM} && PASS_TYPES.empty()) return;
-
-        handler().descriptorHandler().getBindData(PIPELINE_TYPE, descSetBindDataMap_, {pMaterial_.get()});
-    } else {
+        setReady();
+    } else if (status_ != STATUS::PENDING_LOADING) {
+        // Only waiting on the loading commands is handled by their callback.
         handler().ldgOffsets_.insert({TYPE, getOffset()});
     }
 }
 
+void Mesh::Base::setReady() {
+    // Screen quad mesh will not keep track of descriptor data.
+    if (PIPELINE_TYPE == PIPELINE{GRAPHICS::ALL_ENUM} && PASS_TYPES.empty()) return;
+
+    handler().descriptorHandler().getBindData(PIPELINE_TYPE, descSetBindDataMap_, {pMaterial_.get()});
+    // Passes that already recorded this pipeline did it without this mesh.
+    handler().passHandler().renderPassMgr().setDirty(PIPELINE_TYPE);
+}
+
 void Mesh::Base::makeAdjacenyList() {
     // Only have done triangle adjacency so far.
     assert(TYPE == MESH::COLOR || TYPE == MESH::TEXTURE);
@@ -139,29 +154,23 @@ void Mesh::Base::loadBuffers() {
     vk::BufferUsageFlags vertexUsage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer;
 
     // Vertex buffer
-    BufferResource stgRes = {};
-    ctx.createBuffer(pLdgRes_->transferCmd, vertexUsage, getVertexBufferSize(), NAME + " vertex", stgRes, vertexRes_,
-                     getVertexData(), MAPPABLE);
-    pLdgRes_->stgResources.push_back(std::move(stgRes));
+    ctx.createBuffer(*pLdgRes_, vertexUsage, getVertexBufferSize(), NAME + " vertex", vertexRes_, getVertexData(),
+                     MAPPABLE);
 
     vk::BufferUsageFlags indexUsage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer;
 
     // Index buffer
     if (getIndexCount()) {
-        stgRes = {};
-        ctx.createBuffer(pLdgRes_->transferCmd, indexUsage, getIndexBufferSize(), NAME + " index", stgRes, indexRes_,
-                         getIndexData(), MAPPABLE);
-        pLdgRes_->stgResources.push_back(std::move(stgRes));
+        ctx.createBuffer(*pLdgRes_, indexUsage, getIndexBufferSize(), NAME + " index", indexRes_, getIndexData(),
+                         MAPPABLE);
     }
 
     // Index adjacency buffer
     if (indicesAdjaceny_.size()) {
         // TODO: I should probably either create this buffer or the normal index buffer. If you
         // update this then you should also do this everywhere like "updateBuffers" for example.
-        stgRes = {};
-        ctx.createBuffer(pLdgRes_->transferCmd, indexUsage, getIndexBufferAdjSize(), NAME + " adjacency index", stgRes,
-                         indexAdjacencyRes_, indicesAdjaceny_.data(), MAPPABLE);
-        pLdgRes_->stgResources.push_back(std::move(stgRes));
+        ctx.createBuffer(*pLdgRes_, indexUsage, getIndexBufferAdjSize(), NAME + " adjacency index", indexAdjacencyRes_,
+                         indicesAdjaceny_.data(), MAPPABLE);
     }
 }
 
@@ -172,14 +181,14 @@ void Mesh::Base::createBufferData(const vk::CommandBuffer& cmd, BufferResource&
 
     // STAGING RESOURCE
     res.memoryRequirements.size =
-        helpers::createBuffer(ctx.dev, bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
+        helpers::createBuffer(ctx.dev, *ctx.pMemAllocator, bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
                               vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                              ctx.memProps, stgRes.buffer, stgRes.memory, ctx.pAllocator);
+                              stgRes.buffer, stgRes.allocation, ctx.pAllocator, true);
 
     // FILL STAGING BUFFER ON DEVICE
-    void* pData = ctx.dev.mapMemory(stgRes.memory, 0, res.memoryRequirements.size);
+    void* pData = stgRes.allocation.pMappedData;
     /*
-     *  You can now simply memcpy the vertex data to the mapped memory and unmap it again using unmapMemory.
+     *  Staging memory is persistently mapped by the allocator, so you can simply memcpy the vertex data to it.
      *  Unfortunately the driver may not immediately copy the data into the buffer memory, for example because
      *  of caching. It is also possible that writes to the buffer are not visible in the mapped memory yet. There
      *  are two ways to deal with that problem:
@@ -191,14 +200,13 @@ void Mesh::Base::createBufferData(const vk::CommandBuffer& cmd, BufferResource&
      *  but we'll see why that doesn't matter in the next chapter.
      */
     memcpy(pData, data, static_cast<size_t>(bufferSize));
-    ctx.dev.unmapMemory(stgRes.memory);
 
     // FAST VERTEX BUFFER
     vk::MemoryPropertyFlags memProps = vk::MemoryPropertyFlagBits::eDeviceLocal;
     if (MAPPABLE) memProps |= vk::MemoryPropertyFlagBits::eHostVisible;
-    helpers::createBuffer(ctx.dev, bufferSize,
+    helpers::createBuffer(ctx.dev, *ctx.pMemAllocator, bufferSize,
                           // TODO: probably don't need to check memory requirements again
-                          usage, memProps, ctx.memProps, res.buffer, res.memory, ctx.pAllocator);
+                          usage, memProps, res.buffer, res.allocation, ctx.pAllocator);
 
     // COPY FROM STAGING TO FAST
     helpers::copyBuffer(cmd, stgRes.buffer, res.buffer, res.memoryRequirements.size);
@@ -213,29 +221,40 @@ void Mesh::Base::addVertex(const Face& face) {
     }
 }
 
+void Mesh::Base::addBoundingBox(const ::Obj3d::BoundingBox& boundingBox) {
+    struct {
+        glm::vec3 position;
+    } point;
+    for (const auto& position : boundingBox) {
+        point.position = position;
+        pInstObj3d_->updateBoundingBox(point);
+    }
+}
+
 void Mesh::Base::updateBuffers() {
-    auto& dev = handler().shell().context().dev;
+    // Mappable buffers live in persistently mapped memory so there is no need to map/unmap here.
+    const auto& allocator = *handler().shell().context().pMemAllocator;
 
     // VERTEX BUFFER
     vk::DeviceSize bufferSize = getVertexBufferSize(true);
-    void* pData = dev.mapMemory(vertexRes_.memory, 0, VK_WHOLE_SIZE);
-    memcpy(pData, getVertexData(), static_cast<size_t>(bufferSize));
-    dev.unmapMemory(vertexRes_.memory);
+    assert(vertexRes_.allocation.pMappedData);
+    memcpy(vertexRes_.allocation.pMappedData, getVertexData(), static_cast<size_t>(bufferSize));
+    allocator.flush(vertexRes_.allocation, 0, bufferSize);
 
     // INDEX BUFFER
     if (getIndexCount()) {
         bufferSize = getIndexBufferSize(true);
-        pData = dev.mapMemory(indexRes_.memory, 0, indexRes_.memoryRequirements.size);
-        memcpy(pData, getIndexData(), static_cast<size_t>(bufferSize));
-        dev.unmapMemory(indexRes_.memory);
+        assert(indexRes_.allocation.pMappedData);
+        memcpy(indexRes_.allocation.pMappedData, getIndexData(), static_cast<size_t>(bufferSize));
+        allocator.flush(indexRes_.allocation, 0, bufferSize);
     }
 
     // INDEX BUFFER (ADJACENCY)
     if (indicesAdjaceny_.size()) {
         bufferSize = getIndexBufferAdjSize(true);
-        pData = dev.mapMemory(indexAdjacencyRes_.memory, 0, indexAdjacencyRes_.memoryRequirements.size);
-        memcpy(pData, indicesAdjaceny_.data(), static_cast<size_t>(bufferSize));
-        dev.unmapMemory(indexAdjacencyRes_.memory);
+        assert(indexAdjacencyRes_.allocation.pMappedData);
+        memcpy(indexAdjacencyRes_.allocation.pMappedData, indicesAdjaceny_.data(), static_cast<size_t>(bufferSize));
+        allocator.flush(indexAdjacencyRes_.allocation, 0, bufferSize);
     }
 }
 
@@ -415,6 +434,18 @@ void Mesh::Base::draw(const RENDER_PASS& passType, const std::shared_ptr<Pipelin
     cmd.bindDescriptorSets(pPipelineBindData->bindPoint, pPipelineBindData->layout, descSetBindData.firstSet,
                            descSetBindData.descriptorSets[setIndex], descSetBindData.dynamicOffsets);
 
+    // BINDLESS (The material, and its texture, are indexed instead of bound.)
+    if (pPipelineBindData->bindlessSet != UINT32_MAX) {
+        cmd.bindDescriptorSets(pPipelineBindData->bindPoint, pPipelineBindData->layout, pPipelineBindData->bindlessSet,
+                               {handler().descriptorHandler().bindless().getSet()}, {});
+        Descriptor::Bindless::PushConstant pushConstant = {};
+        pushConstant.sampler = pMaterial_->getBindlessSamplerIndex();
+        pushConstant.buffer = pMaterial_->getBindlessBufferIndex();
+        assert(pushConstant.buffer != Descriptor::Bindless::INVALID_INDEX);
+        cmd.pushConstants(pPipelineBindData->layout, pPipelineBindData->pushConstantStages, 0,
+                          static_cast<uint32_t>(sizeof(Descriptor::Bindless::PushConstant)), &pushConstant);
+    }
+
     // VERTEX
     cmd.bindVertexBuffers(Vertex::BINDING, {vertexRes_.buffer}, {0});
 
@@ -459,9 +490,11 @@ void Mesh::Base::draw(const RENDER_PASS& passType, const std::shared_ptr<Pipelin
 }
 
 void Mesh::Base::destroy() {
+    handler().loadingHandler().cancelCallbacks(this);
     const auto& ctx = handler().shell().context();
     ctx.destroyBuffer(vertexRes_);
     ctx.destroyBuffer(indexRes_);
+    ctx.destroyBuffer(indexAdjacencyRes_);
 }
 
 // COLOR
@@ -481,9 +514,11 @@ Mesh::Color::Color(Mesh::Handler& handler, const index&& offset, const GenericCr
     assert(vertices_.empty() && pCreateInfo->faces.size());
     if (pCreateInfo->settings.geometryInfo.smoothNormals) {
         unique_vertices_map_smoothing vertexMap = {};
+        vertexMap.reserve(pCreateInfo->faces.size() * Face::NUM_VERTICES);
         for (auto& face : pCreateInfo->faces) const_cast<Face&>(face).indexVertices(vertexMap, this);
     } else {
         unique_vertices_map_non_smoothing vertexMap = {};
+        vertexMap.reserve(pCreateInfo->faces.size() * Face::NUM_VERTICES);
         for (auto& face : pCreateInfo->faces) const_cast<Face&>(face).indexVertices(vertexMap, this);
     }
     status_ = STATUS::PENDING_BUFFERS;
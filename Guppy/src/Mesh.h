@@ -79,6 +79,8 @@ class Base : public NonCopyable, public Handlee<Mesh::Handler>, public Obj3d::In
     virtual void addVertex(const Face& face);
     virtual inline uint32_t getVertexCount() const = 0;  // TODO: this shouldn't be public
     virtual const glm::vec3& getVertexPositionAtOffset(size_t offset) const = 0;
+    virtual inline const void* getVertexData() const = 0;
+    virtual inline vk::DeviceSize getVertexBufferSize(bool assert = false) const = 0;
     void updateBuffers();
     inline vk::Buffer& getVertexBuffer() { return vertexRes_.buffer; }
 
@@ -89,6 +91,16 @@ class Base : public NonCopyable, public Handlee<Mesh::Handler>, public Obj3d::In
         for (auto i : is) indices_.push_back(i);
     }
     inline void addIndex(IndexBufferType index) { indices_.push_back(index); }
+    inline const std::vector<IndexBufferType>& getIndices() const { return indices_; }
+
+    // CACHE
+    // Mesh::Cache reads straight into these instead of going through addVertex/addIndex.
+    virtual void* resizeVertices(const uint32_t count) = 0;
+    inline IndexBufferType* resizeIndices(const uint32_t count) {
+        indices_.resize(count);
+        return indices_.data();
+    }
+    void addBoundingBox(const ::Obj3d::BoundingBox& boundingBox);
 
     // FACE
     inline bool isSelectable() { return selectable_; }
@@ -117,8 +129,8 @@ class Base : public NonCopyable, public Handlee<Mesh::Handler>, public Obj3d::In
 
     // VERTEX
     void loadBuffers();
-    virtual inline const void* getVertexData() const = 0;
-    virtual inline vk::DeviceSize getVertexBufferSize(bool assert = false) const = 0;
+    // Called once nothing is pending anymore.
+    void setReady();
 
     // INDEX
     inline IndexBufferType* getIndexData() { return indices_.data(); }
@@ -166,6 +178,8 @@ class Color : public Base {
     friend class Mesh::Handler;
 
    public:
+    using VertexType = Vertex::Color;
+
     ~Color();
 
     // VERTEX
@@ -182,7 +196,15 @@ class Color : public Base {
         }
         pInstObj3d_->updateBoundingBox(vertices_.back());
     }
+    inline void addVertices(const std::vector<Vertex::Color>& vertices) {
+        vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+        pInstObj3d_->updateBoundingBox(vertices);
+    }
     inline virtual const void* getVertexData() const override { return vertices_.data(); }
+    inline void* resizeVertices(const uint32_t count) override {
+        vertices_.resize(count);
+        return vertices_.data();
+    }
     inline uint32_t getVertexCount() const override { return vertices_.size(); }
     inline vk::DeviceSize getVertexBufferSize(bool assert = false) const override {
         vk::DeviceSize bufferSize = sizeof(Vertex::Color) * vertices_.size();
@@ -223,6 +245,8 @@ class Texture : public Base {
     friend class Mesh::Handler;
 
    public:
+    using VertexType = Vertex::Texture;
+
     ~Texture();
 
     // VERTEX
@@ -239,7 +263,15 @@ class Texture : public Base {
         }
         pInstObj3d_->updateBoundingBox(vertices_.back());
     }
+    inline void addVertices(const std::vector<Vertex::Texture>& vertices) {
+        vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+        pInstObj3d_->updateBoundingBox(vertices);
+    }
     inline virtual const void* getVertexData() const override { return vertices_.data(); }
+    inline void* resizeVertices(const uint32_t count) override {
+        vertices_.resize(count);
+        return vertices_.data();
+    }
     inline uint32_t getVertexCount() const override { return vertices_.size(); }
     inline vk::DeviceSize getVertexBufferSize(bool assert = false) const override {
         vk::DeviceSize bufferSize = sizeof(Vertex::Texture) * vertices_.size();
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#include <Common/Helpers.h>
+
+#include "Mesh.h"
+#include "Shell.h"
+
+namespace {
+
+using MtllibNames = std::vector<std::vector<std::string>>;
+
+uint64_t getMaterialStamp(const std::string &mtlBaseDir, const MtllibNames &mtllibs) {
+    uint64_t h = helpers::FNV_OFFSET_BASIS;
+    for (const auto &names : mtllibs)
+        for (const auto &name : names) helpers::hashFile(h, mtlBaseDir + name, helpers::FILE_HASH::CONTENTS);
+    return h;
+}
+
+// The same "mtllib" statements tinyobj looks at while parsing.
+MtllibNames getMtllibNames(const std::string &modelPath) {
+    MtllibNames mtllibs;
+    std::ifstream file(helpers::normalizePath(modelPath));
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 6, "mtllib") != 0 || line.size() < 7 || (line[6] != ' ' && line[6] != '\t')) continue;
+        if (line.back() == '\r') line.pop_back();
+        std::stringstream ss(line.substr(7));
+        std::vector<std::string> names;
+        for (std::string name; ss >> name;) names.push_back(name);
+        if (!names.empty()) mtllibs.push_back(std::move(names));
+    }
+    return mtllibs;
+}
+
+// Same as tinyobj: the first file in a statement that loads wins.
+void loadMaterials(const Shell &shell, const MtllibNames &mtllibs, FileLoader::tinyobj_data &data) {
+    tinyobj::MaterialFileReader reader(data.mtl_basedir);
+    std::map<std::string, int> materialMap;
+    for (const auto &names : mtllibs) {
+        for (const auto &name : names) {
+            std::string warn, err;
+            bool loaded = reader(name, &data.materials, &materialMap, &warn, &err);
+            if (!warn.empty()) shell.log(Shell::LogPriority::LOG_WARN, warn.c_str());
+            if (loaded) break;
+        }
+    }
+}
+
+}  // namespace
+
+namespace Mesh {
+namespace Cache {
+
+namespace {
+
+// The settings that change the vertices, and the model path. "contents" adds the bytes of the .obj.
+uint64_t hashModel(const std::string &modelPath, const Settings &settings, const VERTEX vertexType,
+                   const bool contents) {
+    uint64_t h = helpers::FNV_OFFSET_BASIS;
+    const uint32_t values[] = {
+        VERSION,
+        static_cast<uint32_t>(vertexType),
+        static_cast<uint32_t>(settings.geometryInfo.faceVertexColorsRGB),
+        static_cast<uint32_t>(settings.geometryInfo.reverseFaceWinding),
+        static_cast<uint32_t>(settings.geometryInfo.smoothNormals),
+        static_cast<uint32_t>(sizeof(Vertex::Color)),
+        static_cast<uint32_t>(sizeof(Vertex::Texture)),
+        static_cast<uint32_t>(sizeof(IndexBufferType)),
+    };
+    helpers::hash(h, values, sizeof(values));
+    helpers::hashFile(h, modelPath, contents ? helpers::FILE_HASH::CONTENTS : helpers::FILE_HASH::PATH);
+    return h;
+}
+
+}  // namespace
+
+std::string GetPath(const std::string &modelPath, const Settings &settings, const VERTEX vertexType) {
+    std::stringstream ss;
+    ss << helpers::normalizePath(modelPath) << '.' << std::hex << hashModel(modelPath, settings, vertexType, false)
+       << EXTENSION;
+    return ss.str();
+}
+
+uint64_t GetSourceStamp(const std::string &modelPath, const Settings &settings, const VERTEX vertexType) {
+    return hashModel(modelPath, settings, vertexType, true);
+}
+
+bool Open(const Shell &shell, const Settings &settings, const VERTEX vertexType, FileLoader::tinyobj_data &data,
+          File &file) {
+    file.stream.open(GetPath(data.filename, settings, vertexType), std::ios::binary);
+    if (!file.stream.is_open()) return false;
+
+    Header header = {};
+    if (!helpers::readValue(file.stream, header)) return false;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.vertexType != static_cast<uint32_t>(vertexType) ||
+        header.sourceStamp != GetSourceStamp(data.filename, settings, vertexType) || header.meshCount == 0)
+        return false;
+
+    MtllibNames mtllibs(header.mtllibCount);
+    for (auto &names : mtllibs) {
+        uint32_t count = 0;
+        if (!helpers::readValue(file.stream, count)) return false;
+        names.resize(count);
+        for (auto &name : names) {
+            uint32_t length = 0;
+            if (!helpers::readValue(file.stream, length)) return false;
+            name.resize(length);
+            if (!file.stream.read(name.data(), length)) return false;
+        }
+    }
+    if (header.materialStamp != getMaterialStamp(data.mtl_basedir, mtllibs)) return false;
+
+    file.records.resize(header.meshCount);
+    if (!file.stream.read(reinterpret_cast<char *>(file.records.data()), sizeof(Record) * file.records.size()))
+        return false;
+
+    // Make sure everything the records point at is actually there before any mesh is touched.
+    file.stream.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(file.stream.tellg());
+    for (const auto &record : file.records) {
+        if (record.vertexCount == 0 || record.vertexOffset + record.vertexSize > fileSize ||
+            record.indexOffset + (sizeof(IndexBufferType) * record.indexCount) > fileSize)
+            return false;
+    }
+
+    loadMaterials(shell, mtllibs, data);
+    if (std::max<size_t>(data.materials.size(), 1) != file.records.size()) {
+        data.materials.clear();
+        return false;
+    }
+    return true;
+}
+
+bool Read(File &file, const std::vector<Base *> &pMeshes) {
+    assert(pMeshes.size() == file.records.size());
+
+    bool success = true;
+    for (size_t i = 0; i < pMeshes.size() && success; i++) {
+        const auto &record = file.records[i];
+        auto *pVertices = pMeshes[i]->resizeVertices(record.vertexCount);
+        success = pMeshes[i]->getVertexBufferSize() == record.vertexSize;
+        success = success && file.stream.seekg(static_cast<std::streamoff>(record.vertexOffset)) &&
+                  file.stream.read(static_cast<char *>(pVertices), record.vertexSize);
+
+        auto *pIndices = pMeshes[i]->resizeIndices(record.indexCount);
+        success = success && file.stream.seekg(static_cast<std::streamoff>(record.indexOffset)) &&
+                  file.stream.read(reinterpret_cast<char *>(pIndices), sizeof(IndexBufferType) * record.indexCount);
+    }
+
+    if (!success) {
+        for (auto &pMesh : pMeshes) {
+            pMesh->resizeVertices(0);
+            pMesh->resizeIndices(0);
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < pMeshes.size(); i++) {
+        ::Obj3d::BoundingBox boundingBox;
+        for (size_t p = 0; p < boundingBox.size(); p++)
+            boundingBox[p] = {file.records[i].boundingBox[p][0], file.records[i].boundingBox[p][1],
+                              file.records[i].boundingBox[p][2]};
+        pMeshes[i]->addBoundingBox(boundingBox);
+        pMeshes[i]->setStatus(STATUS::PENDING_BUFFERS);
+    }
+    return true;
+}
+
+namespace {
+
+// Everything "Save" writes.
+bool writeCache(std::ofstream &file, const Settings &settings, const VERTEX vertexType,
+                const FileLoader::tinyobj_data &data, const std::vector<Base *> &pMeshes) {
+    const auto mtllibs = getMtllibNames(data.filename);
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sourceStamp = 0;  // Written last, so a partially written file never matches.
+    header.materialStamp = getMaterialStamp(data.mtl_basedir, mtllibs);
+    header.vertexType = static_cast<uint32_t>(vertexType);
+    header.meshCount = static_cast<uint32_t>(pMeshes.size());
+    header.mtllibCount = static_cast<uint32_t>(mtllibs.size());
+
+    helpers::writeValue(file, header);
+    for (const auto &names : mtllibs) {
+        helpers::writeValue(file, static_cast<uint32_t>(names.size()));
+        for (const auto &name : names) {
+            helpers::writeValue(file, static_cast<uint32_t>(name.size()));
+            file.write(name.data(), name.size());
+        }
+    }
+
+    std::vector<Record> records(pMeshes.size());
+    uint64_t offset = static_cast<uint64_t>(file.tellp()) + (sizeof(Record) * records.size());
+    auto align = [](const uint64_t offset) { return ((offset + 15) / 16) * 16; };
+    for (size_t i = 0; i < pMeshes.size(); i++) {
+        const auto &pMesh = pMeshes[i];
+        auto &record = records[i];
+        record.vertexCount = pMesh->getVertexCount();
+        record.vertexSize = pMesh->getVertexBufferSize();
+        record.vertexOffset = align(offset);
+        record.indexCount = static_cast<uint32_t>(pMesh->getIndices().size());
+        record.indexOffset = align(record.vertexOffset + record.vertexSize);
+        offset = record.indexOffset + (sizeof(IndexBufferType) * record.indexCount);
+
+        // Same extremes as Obj3d::AbstractBase::updateBoundingBox.
+        auto boundingBox = ::Obj3d::DEFAULT_BOUNDING_BOX;
+        for (uint32_t v = 0; v < record.vertexCount; v++) {
+            const auto &position = pMesh->getVertexPositionAtOffset(v);
+            for (glm::length_t axis = 0; axis < 3; axis++) {
+                if (position[axis] < boundingBox[axis * 2][axis]) boundingBox[axis * 2] = position;
+                if (position[axis] > boundingBox[axis * 2 + 1][axis]) boundingBox[axis * 2 + 1] = position;
+            }
+        }
+        for (size_t p = 0; p < boundingBox.size(); p++)
+            for (glm::length_t c = 0; c < 3; c++) record.boundingBox[p][c] = boundingBox[p][c];
+    }
+    file.write(reinterpret_cast<const char *>(records.data()), sizeof(Record) * records.size());
+
+    for (size_t i = 0; i < pMeshes.size(); i++) {
+        file.seekp(static_cast<std::streamoff>(records[i].vertexOffset));
+        file.write(static_cast<const char *>(pMeshes[i]->getVertexData()), records[i].vertexSize);
+        file.seekp(static_cast<std::streamoff>(records[i].indexOffset));
+        file.write(reinterpret_cast<const char *>(pMeshes[i]->getIndices().data()),
+                   sizeof(IndexBufferType) * records[i].indexCount);
+    }
+
+    header.sourceStamp = GetSourceStamp(data.filename, settings, vertexType);
+    file.seekp(0);
+    helpers::writeValue(file, header);
+    return true;
+}
+
+}  // namespace
+
+bool Save(const Shell &shell, const Settings &settings, const VERTEX vertexType, const FileLoader::tinyobj_data &data,
+          const std::vector<Base *> &pMeshes) {
+    const auto path = GetPath(data.filename, settings, vertexType);
+    bool saved = helpers::writeFileAtomic(
+        path, [&](std::ofstream &file) { return writeCache(file, settings, vertexType, data, pMeshes); });
+    if (!saved) {
+        std::string msg = "\nCould not write mesh cache \"" + path + "\".\n";
+        shell.log(Shell::LogPriority::LOG_WARN, msg.c_str());
+    }
+    return saved;
+}
+
+}  // namespace Cache
+}  // namespace Mesh
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Enum.h"
+#include "FileLoader.h"
+#include "MeshConstants.h"
+
+class Shell;
+
+namespace Mesh {
+
+class Base;
+
+/* Models loaded from .obj files are cached next to the source in a small container with the final, already indexed
+ *  (and smoothed) vertex and index data for every mesh the model makes, so loading one skips parsing and the vertex
+ *  maps completely. There is a mesh per material, in material order, and the materials themselves still come from the
+ *  .mtl files the model references, so textures are made the same way either way. Every vertex type and set of
+ *  geometry settings that change the vertices has its own container, which is thrown out, and rewritten, if the .obj
+ *  or any of the .mtl files are different.
+ *
+ *  Layout (little-endian, like every device this runs on):
+ *      Header
+ *      mtllib names        per "mtllib" statement: { count, { length, chars }[count] }
+ *      Record[meshCount]   where the mesh's data is, and its bounding box.
+ *      mesh data           vertices, then indices, 16 byte aligned.
+ */
+namespace Cache {
+
+constexpr std::string_view EXTENSION = ".gmesh";
+constexpr char MAGIC[4] = {'G', 'M', 'S', 'H'};
+constexpr uint32_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceStamp;
+    uint64_t materialStamp;
+    uint32_t vertexType;  // VERTEX
+    uint32_t meshCount;
+    uint32_t mtllibCount;
+    uint32_t padding;
+};
+
+struct Record {
+    uint64_t vertexOffset;
+    uint64_t vertexSize;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    float boundingBox[6][3];  // Obj3d::BoundingBox
+};
+
+// A container whose stamps matched. Everything but the mesh data has been read.
+struct File {
+    std::ifstream stream;
+    std::vector<Record> records;
+};
+
+// "<model path>.<settings hash>.gmesh", so loading a model with different settings doesn't replace its container.
+std::string GetPath(const std::string &modelPath, const Settings &settings, const VERTEX vertexType);
+// Hash of the settings that change the vertices, and the path and contents of the .obj.
+uint64_t GetSourceStamp(const std::string &modelPath, const Settings &settings, const VERTEX vertexType);
+
+// Fills in "data.materials" from the model's .mtl files if there is a usable container for the model. The caller
+//  should parse the .obj instead if this returns false.
+bool Open(const Shell &shell, const Settings &settings, const VERTEX vertexType, FileLoader::tinyobj_data &data,
+          File &file);
+// Reads the vertices/indices of every mesh. "pMeshes" are the meshes made for "data.materials", in order, and are left
+//  empty if this fails.
+bool Read(File &file, const std::vector<Base *> &pMeshes);
+bool Save(const Shell &shell, const Settings &settings, const VERTEX vertexType, const FileLoader::tinyobj_data &data,
+          const std::vector<Base *> &pMeshes);
+
+}  // namespace Cache
+}  // namespace Mesh
+
+#endif  // !MESH_CACHE_H
@@ -5,19 +5,44 @@
 
 #include "MeshHandler.h"
 
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+#include "RenderPassManager.h"
 #include "Shell.h"
 // HANDLERS
+#include "CommandHandler.h"
+#include "PassHandler.h"
 #include "SceneHandler.h"
 
+namespace {
+// Per frame. Whatever doesn't fit is copied the next frame.
+constexpr vk::DeviceSize INSTANCE_STAGING_FRAME_SIZE = 16 * 1024 * 1024;
+}  // namespace
+
 Mesh::Handler::Handler(Game* pGame)
-    : Game::Handler(pGame),                                          //
-      instObj3dMgr_{"Instance Object 3d Data", (2 * 1000000) + 100}  //
-{}
+    : Game::Handler(pGame),  //
+      instObj3dMgr_{"Instance Object 3d Data", (2 * 1000000) + 100, true, vk::BufferUsageFlagBits::eVertexBuffer,
+                    Instance::MEMORY::AUTO_STAGED},
+      instStaging_{"Instance Staging", INSTANCE_STAGING_FRAME_SIZE, vk::BufferUsageFlagBits::eTransferSrc} {}
 
 void Mesh::Handler::init() {
     reset();
+    const auto& ctx = shell().context();
+
     // INSTANCE
-    instObj3dMgr_.init(shell().context());
+    instObj3dMgr_.init(ctx);
+    if (instObj3dMgr_.getMemory() == Instance::MEMORY::STAGED) {
+        instStaging_.init(ctx);
+        instUploadCmds_.resize(ctx.imageCount);
+        commandHandler().createCmdBuffers(QUEUE::GRAPHICS, instUploadCmds_.data(), vk::CommandBufferLevel::ePrimary,
+                                          static_cast<uint32_t>(instUploadCmds_.size()));
+    }
+    instObj3dMgr_.beginBatch();
+
+    std::string msg = "Instance Object 3d Data memory: ";
+    shell().log(Shell::LogPriority::LOG_INFO, (msg + Instance::GetMemoryName(instObj3dMgr_.getMemory())).c_str());
 }
 
 void Mesh::Handler::tick() {
@@ -61,6 +86,115 @@ void Mesh::Handler::tick() {
     }
 }
 
+void Mesh::Handler::frame() {
+    const auto frameIndex = passHandler().renderPassMgr().getFrameIndex();
+
+    // INSTANCE
+    // Everything written since the last frame goes out together: a flush, or a staged copy, per contiguous span.
+    if (instUploadCmds_.size()) {
+        // The frame fence has been waited on, so the command buffer and the staging region are free.
+        auto& cmd = instUploadCmds_[frameIndex];
+        instStaging_.beginFrame(frameIndex);
+        cmd.reset({});
+        cmd.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+        instObj3dMgr_.endBatch(&instStaging_, cmd);
+        cmd.end();
+    } else {
+        instObj3dMgr_.endBatch();
+    }
+    instObj3dMgr_.beginBatch();
+}
+
+void Mesh::Handler::updateSubmitResource(RenderPass::SubmitResource& resource, const uint8_t frameIndex) const {
+    if (instUploadCmds_.empty()) return;
+    resource.commandBuffers[resource.commandBufferCount] = instUploadCmds_[frameIndex];
+    resource.commandBufferCount++;
+}
+
+void Mesh::Handler::benchmarkInstanceMemory(const uint32_t instanceCount, const uint32_t iterations) {
+    using clock = std::chrono::high_resolution_clock;
+    const auto& ctx = shell().context();
+    const vk::DeviceSize dataSize = sizeof(Instance::Obj3d::DATA) * instanceCount;
+
+    // Every iteration the device reads all of the data once, like a draw of all of the instances would.
+    vk::Buffer readBuffer;
+    Memory::Allocation readAllocation;
+    helpers::createBuffer(ctx.dev, *ctx.pMemAllocator, dataSize, vk::BufferUsageFlagBits::eTransferDst,
+                          vk::MemoryPropertyFlagBits::eDeviceLocal, readBuffer, readAllocation, ctx.pAllocator);
+    Buffer::Ring staging{"Instance Benchmark Staging", dataSize, vk::BufferUsageFlagBits::eTransferSrc};
+    staging.init(ctx);
+    vk::CommandBuffer cmd;
+    commandHandler().createCmdBuffers(QUEUE::GRAPHICS, &cmd);
+    auto fence = ctx.dev.createFence({}, ctx.pAllocator);
+
+    std::vector<Instance::Obj3d::DATA> data(instanceCount);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "\nInstance memory benchmark (" << instanceCount << " instances, " << iterations << " iterations):\n";
+    ss << "    memory          host ms     total ms    GB/s\n";
+
+    for (const auto memory : {Instance::MEMORY::DEVICE_HOST, Instance::MEMORY::HOST, Instance::MEMORY::STAGED}) {
+        ss << "    " << std::setw(16) << std::left << Instance::GetMemoryName(memory) << std::right;
+        if (memory == Instance::MEMORY::DEVICE_HOST && !Instance::HasDeviceHostMemory(ctx, dataSize)) {
+            ss << "not available\n";
+            continue;
+        }
+
+        Instance::Manager<Instance::Obj3d::Base, Instance::Obj3d::Base> manager{
+            "Instance Benchmark Data", instanceCount, true,
+            vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferSrc, Instance::MEMORY(memory)};
+        manager.init(ctx);
+        auto pItem = manager.insert(ctx.dev, false, data);
+
+        double hostMs = 0.0, totalMs = 0.0;
+        for (uint32_t i = 0; i < iterations; i++) {
+            const auto start = clock::now();
+
+            // HOST
+            manager.beginBatch();
+            for (uint32_t j = 0; j < instanceCount; j++) pItem->setModel(glm::mat4{static_cast<float>(i + 1)}, j);
+            manager.updateData(ctx.dev, pItem->BUFFER_INFO);
+            staging.beginFrame(0);
+            cmd.reset({});
+            cmd.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+            manager.endBatch(&staging, cmd);
+
+            // DEVICE
+            vk::MemoryBarrier barrier = {vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead};
+            cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
+                                {barrier}, {}, {});
+            cmd.copyBuffer(pItem->BUFFER_INFO.bufferInfo.buffer, readBuffer, {vk::BufferCopy{0, 0, dataSize}});
+            cmd.end();
+            const auto recorded = clock::now();
+
+            vk::SubmitInfo submitInfo = {};
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &cmd;
+            commandHandler().graphicsQueue().submit({submitInfo}, fence);
+            helpers::checkVkResult(ctx.dev.waitForFences(fence, VK_TRUE, UINT64_MAX));
+            ctx.dev.resetFences(fence);
+            const auto done = clock::now();
+
+            hostMs += std::chrono::duration<double, std::milli>(recorded - start).count();
+            totalMs += std::chrono::duration<double, std::milli>(done - start).count();
+        }
+        hostMs /= iterations;
+        totalMs /= iterations;
+
+        ss << std::setw(11) << hostMs << "  " << std::setw(11) << totalMs << "  " << std::setw(6)
+           << (static_cast<double>(dataSize) / (totalMs * 1.0e6)) << "\n";
+        manager.destroy(ctx);
+    }
+
+    shell().log(Shell::LogPriority::LOG_INFO, ss.str().c_str());
+
+    ctx.dev.destroyFence(fence, ctx.pAllocator);
+    ctx.dev.freeCommandBuffers(commandHandler().graphicsCmdPool(), cmd);
+    staging.destroy(ctx);
+    ctx.dev.destroyBuffer(readBuffer, ctx.pAllocator);
+    ctx.pMemAllocator->free(readAllocation);
+}
+
 bool Mesh::Handler::checkOffset(const MESH type, const Mesh::index offset) {
     switch (type) {
         case MESH::COLOR:
@@ -90,8 +224,13 @@ void Mesh::Handler::reset() {
     texMeshes_.clear();
     // INSTANCE
     instObj3dMgr_.destroy(shell().context());
+    instStaging_.destroy(shell().context());
+    if (instUploadCmds_.size())
+        helpers::destroyCommandBuffers(shell().context().dev, commandHandler().graphicsCmdPool(), instUploadCmds_);
 }
 
 void Mesh::Handler::addOffsetToScene(const MESH type, const Mesh::index offset) {
     sceneHandler().getActiveScene()->addMeshIndex(type, offset);
 }
+
+void Mesh::Handler::setDirty(const PIPELINE& pipelineType) { passHandler().renderPassMgr().setDirty(pipelineType); }
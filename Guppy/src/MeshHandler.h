@@ -12,11 +12,13 @@
 
 #include <Common/Helpers.h>
 
+#include "BufferRing.h"
 #include "Game.h"
 #include "Instance.h"
 #include "InstanceManager.h"
 #include "MaterialHandler.h"  // TODO: including this is sketchy
 #include "Mesh.h"
+#include "RenderPassConstants.h"
 #include "VisualHelper.h"
 
 // clang-format off
@@ -66,6 +68,7 @@ class Handler : public Game::Handler {
 
     void init() override;
     void tick() override;
+    void frame() override;
 
     bool checkOffset(const MESH type, const Mesh::index offset);
 
@@ -179,10 +182,17 @@ class Handler : public Game::Handler {
     void removeMesh(std::unique_ptr<Mesh::Base> &pMesh);
 
     inline void updateInstanceData(const Buffer::Info &info) { instObj3dMgr_.updateData(shell().context().dev, info); }
+    // Adds the command buffer with the staged instance copies for "frameIndex" if there is one. It has to be submitted
+    //  before anything that draws.
+    void updateSubmitResource(RenderPass::SubmitResource &resource, const uint8_t frameIndex) const;
+    // Times "iterations" updates of "instanceCount" instances with each instance memory type, and logs the results.
+    void benchmarkInstanceMemory(const uint32_t instanceCount = 250000, const uint32_t iterations = 60);
 
     template <typename TMesh>
     inline void updateMesh(std::unique_ptr<TMesh> &pMesh) {
         instObj3dMgr_.updateData(shell().context().dev, pMesh->pInstObj3d_->BUFFER_INFO);
+        // The instance count could have changed.
+        setDirty(pMesh->PIPELINE_TYPE);
     }
 
    private:
@@ -190,6 +200,7 @@ class Handler : public Game::Handler {
 
     // TODO: Not sure this should be here.
     void addOffsetToScene(const MESH type, const Mesh::index offset);
+    void setDirty(const PIPELINE &pipelineType);
 
     // MESH
     // COLOR
@@ -199,7 +210,10 @@ class Handler : public Game::Handler {
     std::vector<std::unique_ptr<Mesh::Texture>> texMeshes_;
 
     // INSTANCE
+    // Updates are batched between frames (see "frame").
     Instance::Manager<Instance::Obj3d::Base, Instance::Obj3d::Base> instObj3dMgr_;
+    Buffer::Ring instStaging_;
+    std::vector<vk::CommandBuffer> instUploadCmds_;  // Per frame. Only made if the instance memory is STAGED.
 
     // LOADING
     std::vector<std::future<Mesh::Base *>> ldgFutures_;
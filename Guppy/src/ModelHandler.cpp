@@ -5,6 +5,7 @@
 
 #include "ModelHandler.h"
 
+#include <algorithm>
 #include <vulkan/vulkan.hpp>
 
 #include "Mesh.h"
@@ -24,13 +25,16 @@ void Model::Handler::tick() {
     checkFutures(pScene, ldgTexFutures_);
 }
 
-FileLoader::tinyobj_data Model::Handler::loadData(Model::Base &model) {
-    // Get .obj data from the file loader.
+bool Model::Handler::loadData(Model::Base &model, const VERTEX vertexType, FileLoader::tinyobj_data &data,
+                              Mesh::Cache::File &cache) {
     std::string modelDirectory = helpers::getFilePath(model.MODEL_PATH);
-    FileLoader::tinyobj_data data = {model.MODEL_PATH, modelDirectory.c_str()};
+    data = {model.MODEL_PATH, modelDirectory.c_str()};
+    if (Mesh::Cache::Open(shell(), model.getSettings(), vertexType, data, cache)) return true;
+
+    // Get .obj data from the file loader.
     FileLoader::getObjData(shell(), data);
     assert(data.attrib.vertices.size());
-    return data;
+    return false;
 }
 
 void Model::Handler::makeTexture(const tinyobj::material_t &tinyobj_mat, const std::string &modelDirectory,
@@ -82,6 +86,12 @@ void Model::Handler::makeTexture(const tinyobj::material_t &tinyobj_mat, const s
 
             // TODO: there are a bunch of combinations not accounted for.
 
+            // Only compress if there is nothing but color in the sampler.
+            auto& samplerCreateInfo = texCreateInfo.samplerCreateInfos.back();
+            samplerCreateInfo.compress = std::all_of(samplerCreateInfo.layersInfo.infos.begin(),
+                                                     samplerCreateInfo.layersInfo.infos.end(),
+                                                     [](const auto& info) { return info.type == Sampler::USAGE::COLOR; });
+
             pCreateInfo->pTexture = textureHandler().make(&texCreateInfo);
 
         } else {
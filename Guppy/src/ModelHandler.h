@@ -16,6 +16,7 @@
 #include "Instance.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "MeshCache.h"
 #include "MeshHandler.h"  // TODO: including this is sketchy
 #include "Model.h"
 #include "ModelMesh.h"
@@ -80,17 +81,44 @@ class Handler : public Game::Handler {
     }
 
     std::unique_ptr<Model::Base>& getModel(Model::index offset) { return pModels_.at(offset); }
+    inline bool isLoading() const { return !ldgColorFutures_.empty() || !ldgTexFutures_.empty(); }
 
    private:
     void reset() override{};
 
-    FileLoader::tinyobj_data loadData(Model::Base& model);
+    // Returns true if the meshes can be read from the model's mesh cache, in which case only "data.materials" is filled
+    //  in. Otherwise "data" is the parsed .obj file.
+    bool loadData(Model::Base& model, const VERTEX vertexType, FileLoader::tinyobj_data& data, Mesh::Cache::File& cache);
+
+    template <typename TMesh>
+    void loadMeshData(Model::Base& model, const VERTEX vertexType, FileLoader::tinyobj_data& data,
+                      Mesh::Cache::File& cache, const bool cached, std::vector<TMesh*>& pMeshes) {
+        std::vector<Mesh::Base*> pBaseMeshes(pMeshes.begin(), pMeshes.end());
+        if (cached) {
+            if (Mesh::Cache::Read(cache, pBaseMeshes)) return;
+            // The cache went bad after it was opened. Parse the source instead.
+            data.materials.clear();
+            FileLoader::getObjData(shell(), data);
+        }
+
+        // Load .obj data into mesh
+        // (The map types have comparison predicates that smooth or not)
+        if (model.getSettings().geometryInfo.smoothNormals) {
+            FileLoader::loadObjData<unique_vertices_map_smoothing>(data, pMeshes, model.getSettings());
+        } else {
+            FileLoader::loadObjData<unique_vertices_map_non_smoothing>(data, pMeshes, model.getSettings());
+        }
+
+        Mesh::Cache::Save(shell(), model.getSettings(), vertexType, data, pBaseMeshes);
+    }
 
     // clang requires pInstanceData to be pass by value.
     template <typename TMaterialCreateInfo>
     std::vector<Mesh::Color*> loadColor(Model::Base& model, TMaterialCreateInfo materialCreateInfo,
                                         std::shared_ptr<::Instance::Obj3d::Base> pInstanceData) {
-        auto data = loadData(model);
+        FileLoader::tinyobj_data data;
+        Mesh::Cache::File cache;
+        bool cached = loadData(model, VERTEX::COLOR, data, cache);
         auto createInfo = model.getMeshCreateInfo();
 
         // Determine amount and type of meshes
@@ -106,13 +134,7 @@ class Handler : public Game::Handler {
             }
         }
 
-        // Load .obj data into mesh
-        // (The map types have comparison predicates that smooth or not)
-        if (model.getSettings().geometryInfo.smoothNormals) {
-            FileLoader::loadObjData<unique_vertices_map_smoothing>(data, pMeshes, model.getSettings());
-        } else {
-            FileLoader::loadObjData<unique_vertices_map_non_smoothing>(data, pMeshes, model.getSettings());
-        }
+        loadMeshData(model, VERTEX::COLOR, data, cache, cached, pMeshes);
 
         for (auto& pMesh : pMeshes) assert(pMesh->getVertexCount());  // ensure something was loaded
 
@@ -123,7 +145,9 @@ class Handler : public Game::Handler {
     template <typename TMaterialCreateInfo>
     std::vector<Mesh::Texture*> loadTexture(Model::Base& model, TMaterialCreateInfo materialCreateInfo,
                                             std::shared_ptr<::Instance::Obj3d::Base> pInstanceData) {
-        auto data = loadData(model);
+        FileLoader::tinyobj_data data;
+        Mesh::Cache::File cache;
+        bool cached = loadData(model, VERTEX::TEXTURE, data, cache);
         auto createInfo = model.getMeshCreateInfo();
 
         // Determine amount and type of meshes
@@ -142,13 +166,7 @@ class Handler : public Game::Handler {
             }
         }
 
-        // Load .obj data into mesh
-        // (The map types have comparison predicates that smooth or not)
-        if (model.getSettings().geometryInfo.smoothNormals) {
-            FileLoader::loadObjData<unique_vertices_map_smoothing>(data, pMeshes, model.getSettings());
-        } else {
-            FileLoader::loadObjData<unique_vertices_map_non_smoothing>(data, pMeshes, model.getSettings());
-        }
+        loadMeshData(model, VERTEX::TEXTURE, data, cache, cached, pMeshes);
 
         for (auto& pMesh : pMeshes) assert(pMesh->getVertexCount());  // ensure something was loaded
 
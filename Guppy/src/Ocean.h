@@ -29,9 +29,8 @@ namespace Ocean {
 
 /**
  * Unfortunately the ocean data sample dimensions need to be square because of how the fft compute shader works currently.
- * The sample dimensions also need to be known here because of the pipeline creation order, and having to use a text
- * replacement routine for the local size value. Still not sure if specialization info could be used for something like that.
- * It didn't work the first time I tried it.
+ * The sample dimensions also need to be known here because of the pipeline creation order. The local sizes are
+ * specialization constants (see Pipeline::Compute::setInfo).
  */
 constexpr uint32_t N = 256;
 constexpr uint32_t M = N;
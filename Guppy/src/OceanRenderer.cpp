@@ -148,7 +148,7 @@ std::shared_ptr<Instance::Cdlod::Ocean::Base>& Renderer::makeInstance(Instance::
 }
 
 void Renderer::bindDescSetData(const vk::CommandBuffer& cmd, const std::shared_ptr<Pipeline::BindData>& pPipelineBindData,
-                               const int lodLevel) const {
+                               const int lodLevel, CDLODRendererBatchInfo::RenderData& renderData) const {
     assert(false);
     // const auto frameIndex = handler().passHandler().renderPassMgr().getFrameIndex();
     // const auto it = std::find(pBuffer_->GRAPHICS_TYPES.begin(), pBuffer_->GRAPHICS_TYPES.end(),
@@ -79,7 +79,7 @@ class Renderer : public Cdlod::Renderer::Base {
     const IHeightmapSource* getHeightmap() const override { return &dbgHeightmap_; }
     const MapDimensions* getMapDimensions() const override { return &dbgHeightmap_.mapDims; }
     void bindDescSetData(const vk::CommandBuffer& cmd, const std::shared_ptr<Pipeline::BindData>& pPipelineBindData,
-                         const int lodLevel) const override;
+                         const int lodLevel, CDLODRendererBatchInfo::RenderData& renderData) const override;
     void setGlobalShaderSettings() override;
     PerQuadTreeData& getPerQuadTreeData() override;
 
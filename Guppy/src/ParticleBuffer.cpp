@@ -195,9 +195,16 @@ void Base::update(const float time, const float elapsed, const uint32_t frameInd
 void Base::prepare() {
     if (status_ & STATUS::PENDING_BUFFERS) {
         loadBuffers();
-        // Submit vertex loading commands...
-        handler().loadingHandler().loadSubmit(std::move(pLdgRes_));
+        // Submit vertex loading commands. The callback runs once the device is done with them.
+        handler().loadingHandler().loadSubmit(
+            std::move(pLdgRes_),
+            [this]() {
+                status_ ^= STATUS::PENDING_LOADING;
+                if (status_ == STATUS::READY) setReady();
+            },
+            this);
         status_ ^= STATUS::PENDING_BUFFERS;
+        status_ |= STATUS::PENDING_LOADING;
     } else if (!vertexRes_.buffer && !indexRes_.buffer) {
         assert(vertices_.empty() && indices_.empty() && "Did you mean to set the status to PENDING_BUFFERS?");
     }
@@ -210,14 +217,19 @@ void Base::prepare() {
 
     // TODO: see comment in Mesh::Base::prepare about descriptors.
     if (status_ == STATUS::READY) {
-        if (COMPUTE_TYPES.size()) getComputeDescSetBindData();
-        if (GRAPHICS_TYPES.size()) getGraphicsDescSetBindData();
-        if (SHADOW_PIPELINE_TYPE != GRAPHICS::ALL_ENUM) getShadowDescSetBindData();
-    } else {
+        setReady();
+    } else if (status_ != STATUS::PENDING_LOADING) {
+        // Only waiting on the loading commands is handled by their callback.
         handler().ldgOffsets_.insert(getOffset());
     }
 }
 
+void Base::setReady() {
+    if (COMPUTE_TYPES.size()) getComputeDescSetBindData();
+    if (GRAPHICS_TYPES.size()) getGraphicsDescSetBindData();
+    if (SHADOW_PIPELINE_TYPE != GRAPHICS::ALL_ENUM) getShadowDescSetBindData();
+}
+
 void Base::loadBuffers() {
     assert(vertices_.size() || indices_.size() || texCoords_.size());
 
@@ -225,34 +237,29 @@ void Base::loadBuffers() {
     pLdgRes_ = handler().loadingHandler().createLoadingResources();
 
     // Vertex buffer
-    BufferResource stgRes = {};
     if (vertices_.size()) {
-        ctx.createBuffer(pLdgRes_->transferCmd,
+        ctx.createBuffer(*pLdgRes_,
                          vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                         sizeof(Vertex::Color) * vertices_.size(), NAME + " vertex", stgRes, vertexRes_, vertices_.data());
-        pLdgRes_->stgResources.push_back(std::move(stgRes));
+                         sizeof(Vertex::Color) * vertices_.size(), NAME + " vertex", vertexRes_, vertices_.data());
     }
 
     // Index buffer
     if (indices_.size()) {
-        stgRes = {};
-        ctx.createBuffer(pLdgRes_->transferCmd,
+        ctx.createBuffer(*pLdgRes_,
                          vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                         sizeof(IndexBufferType) * indices_.size(), NAME + " index", stgRes, indexRes_, indices_.data());
-        pLdgRes_->stgResources.push_back(std::move(stgRes));
+                         sizeof(IndexBufferType) * indices_.size(), NAME + " index", indexRes_, indices_.data());
     }
 
     // Texture coordinate buffer
     if (texCoords_.size()) {
-        stgRes = {};
         ctx.createBuffer(
-            pLdgRes_->transferCmd, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-            sizeof(glm::vec2) * texCoords_.size(), NAME + " tex coords", stgRes, texCoordRes_, texCoords_.data());
-        pLdgRes_->stgResources.push_back(std::move(stgRes));
+            *pLdgRes_, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+            sizeof(glm::vec2) * texCoords_.size(), NAME + " tex coords", texCoordRes_, texCoords_.data());
     }
 }
 
 void Base::destroy() {
+    handler().loadingHandler().cancelCallbacks(this);
     const auto& ctx = handler().shell().context();
     if (vertices_.size()) ctx.destroyBuffer(vertexRes_);
     if (indices_.size()) ctx.destroyBuffer(indexRes_);
@@ -262,7 +269,7 @@ void Base::destroy() {
 const std::vector<Descriptor::Base*> Base::getDynamicDataItems(const PIPELINE pipelineType) const {
     std::vector<Descriptor::Base*> pDescs;
     for (const auto [descSetType, stageFlags] :
-         handler().pipelineHandler().getPipeline(pipelineType)->DESC_SET_STAGE_PAIRS) {
+         handler().pipelineHandler().getPipeline(pipelineType)->getDescSetStagePairs()) {
         const auto& descSet = handler().descriptorHandler().getDescriptorSet(descSetType);
         for (const auto& [key, bindingInfo] : descSet.getBindingMap()) {
             if (std::visit(Descriptor::IsDynamic{}, bindingInfo.descType)) {
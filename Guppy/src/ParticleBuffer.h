@@ -205,6 +205,8 @@ class Base : public NonCopyable, public Handlee<Handler> {
 
    private:
     virtual void loadBuffers();
+    // Called once nothing is pending anymore.
+    void setReady();
 
     index offset_;
     uint32_t descTimeOffset_;
@@ -64,9 +64,8 @@ void Particle::Handler::tick() {
         for (auto it = ldgOffsets_.begin(); it != ldgOffsets_.end();) {
             auto& pBuffer = pBuffers_.at(*it);
 
-            // Prepare function should be the only way to set ready status atm.
-            assert(pBuffer->getStatus() != STATUS::READY);
-            pBuffer->prepare();
+            // The loading callback can set the ready status too.
+            if (pBuffer->getStatus() != STATUS::READY) pBuffer->prepare();
 
             if (pBuffer->getStatus() == STATUS::READY)
                 it = ldgOffsets_.erase(it);
@@ -77,10 +76,17 @@ void Particle::Handler::tick() {
 }
 
 void Particle::Handler::frame() {
-    if (!doUpdate_) return;
-
     const auto frameIndex = passHandler().renderPassMgr().getFrameIndex();
 
+    // Catch up the per-framebuffer data for this frame even if nothing is updated below.
+    const auto& dev = shell().context().dev;
+    prtclAttrMgr.updateFrame(dev, frameIndex);
+    prtclClthMgr.updateFrame(dev, frameIndex);
+    prtclFntnMgr.updateFrame(dev, frameIndex);
+    hffMgr.updateFrame(dev, frameIndex);
+
+    if (!doUpdate_) return;
+
     // WAVE
     {
         auto& wave = uniformHandler().uniWaveMgr().getTypedItem(0);
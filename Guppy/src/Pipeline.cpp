@@ -67,6 +67,49 @@ void Pipeline::GetDefaultScreenQuadInputAssemblyInfoResources(CreateInfoResource
     createInfoRes.inputAssemblyStateInfo.topology = vk::PrimitiveTopology::eTriangleList;
 }
 
+void Pipeline::AddSpecializationConstants(CreateInfoResources& createInfoRes,
+                                          const std::vector<specializationConstants>& stagesConstants) {
+    auto& stageInfos = createInfoRes.shaderStageInfos;
+    assert(stagesConstants.size() <= stageInfos.size());
+
+    /* Stages can already point into "specializationInfo", and adding to it can move them, so everything a stage was
+     *  specialized with is copied out before anything is added.
+     */
+    std::vector<std::pair<std::vector<vk::SpecializationMapEntry>, std::vector<uint8_t>>> merged(stageInfos.size());
+    for (size_t i = 0; i < stageInfos.size(); i++) {
+        auto& [mapEntries, data] = merged[i];
+        if (stageInfos[i].pSpecializationInfo != nullptr) {
+            const auto& info = *stageInfos[i].pSpecializationInfo;
+            mapEntries.assign(info.pMapEntries, info.pMapEntries + info.mapEntryCount);
+            const auto* pData = static_cast<const uint8_t*>(info.pData);
+            data.assign(pData, pData + info.dataSize);
+        }
+        if (i >= stagesConstants.size()) continue;
+        for (const auto& [constantID, value] : stagesConstants[i]) {
+            for (const auto& mapEntry : mapEntries) assert(mapEntry.constantID != constantID);
+            mapEntries.push_back({constantID, static_cast<uint32_t>(data.size()), sizeof(value)});
+            const auto* pValue = reinterpret_cast<const uint8_t*>(&value);
+            data.insert(data.end(), pValue, pValue + sizeof(value));
+        }
+    }
+
+    const auto first = createInfoRes.specializationInfo.size();
+    for (auto& [mapEntries, data] : merged) {
+        createInfoRes.specializationMapEntries.push_back(std::move(mapEntries));
+        createInfoRes.specializationData.push_back(std::move(data));
+        createInfoRes.specializationInfo.push_back({});
+        auto& info = createInfoRes.specializationInfo.back();
+        info.mapEntryCount = static_cast<uint32_t>(createInfoRes.specializationMapEntries.back().size());
+        info.pMapEntries = createInfoRes.specializationMapEntries.back().data();
+        info.dataSize = createInfoRes.specializationData.back().size();
+        info.pData = createInfoRes.specializationData.back().data();
+    }
+    for (size_t i = 0; i < stageInfos.size(); i++) {
+        const auto& info = createInfoRes.specializationInfo[first + i];
+        stageInfos[i].pSpecializationInfo = info.mapEntryCount ? &info : nullptr;
+    }
+}
+
 // BASE
 
 Pipeline::Base::Base(Handler& handler, const vk::PipelineBindPoint&& bindPoint, const CreateInfo* pCreateInfo)
@@ -76,12 +119,22 @@ Pipeline::Base::Base(Handler& handler, const vk::PipelineBindPoint&& bindPoint,
       NAME(pCreateInfo->name),
       PUSH_CONSTANT_TYPES(pCreateInfo->pushConstantTypes),
       TYPE(pCreateInfo->type),
+      BINDLESS(pCreateInfo->bindless),
+      BINDLESS_DESC_SET_STAGE_PAIRS(pCreateInfo->bindlessDescSetStagePairs),
       status_(STATUS::PENDING),
       descriptorOffsets_(pCreateInfo->uniformOffsets),
       isInitialized_(false),
       shaderTypes_(pCreateInfo->shaderTypes) {
     assert(!std::visit(IsAll{}, TYPE));
     for (const auto& type : PUSH_CONSTANT_TYPES) assert(type != PUSH_CONSTANT::DONT_CARE);
+    assert(!BINDLESS || (PUSH_CONSTANT_TYPES.size() && PUSH_CONSTANT_TYPES.front() == PUSH_CONSTANT::BINDLESS));
+    assert(BINDLESS || BINDLESS_DESC_SET_STAGE_PAIRS.empty());
+}
+
+bool Pipeline::Base::isBindless() const { return BINDLESS && handler().shell().context().bindlessEnabled; }
+
+const Descriptor::Set::typeShaderStagePairs& Pipeline::Base::getDescSetStagePairs() const {
+    return isBindless() ? BINDLESS_DESC_SET_STAGE_PAIRS : DESC_SET_STAGE_PAIRS;
 }
 
 void Pipeline::Base::init() {
@@ -102,7 +155,8 @@ void Pipeline::Base::updateStatus() {
         else
             ++it;
     }
-    if (pendingTexturesOffsets_.empty()) status_ = STATUS::READY;
+    if (pendingTexturesOffsets_.empty())
+        status_ = handler().isPending(TYPE) ? STATUS::PENDING_PIPELINE : STATUS::READY;
 }
 
 bool Pipeline::Base::checkTextureStatus(const std::string& id) {
@@ -113,7 +167,7 @@ bool Pipeline::Base::checkTextureStatus(const std::string& id) {
 }
 
 void Pipeline::Base::validatePipelineDescriptorSets() {
-    for (const auto& [setType, stageFlags] : DESC_SET_STAGE_PAIRS) {
+    for (const auto& [setType, stageFlags] : getDescSetStagePairs()) {
         // Make sure the descriptor set shader stage flags make sense for the pipeline.
         assert((stageFlags & handler().shaderHandler().getStageFlags(getShaderTypes())) == stageFlags);
 
@@ -157,7 +211,7 @@ void Pipeline::Base::prepareDescriptorSetInfo() {
     handler().passHandler().getActivePassTypes(passTypes, TYPE);
 
     // Gather a culled list of resources.
-    auto helpers = handler().descriptorHandler().getResourceHelpers(passTypes, TYPE, DESC_SET_STAGE_PAIRS);
+    auto helpers = handler().descriptorHandler().getResourceHelpers(passTypes, TYPE, getDescSetStagePairs());
 
     for (auto resourceIndex = 0; resourceIndex < helpers.front().size(); resourceIndex++) {
         // Loop through each layer of descriptor set resources at resourceIndex
@@ -192,9 +246,20 @@ void Pipeline::Base::prepareDescriptorSetInfo() {
         }
     }
 
-    for (const auto& keyValue : shaderTextReplaceInfoMap_) assert(keyValue.second.size() == DESC_SET_STAGE_PAIRS.size());
+    const auto& descSetStagePairs = getDescSetStagePairs();
+    for (const auto& keyValue : shaderTextReplaceInfoMap_) assert(keyValue.second.size() == descSetStagePairs.size());
     assert(layoutsMap_.size() == helpers.front().size());
-    for (const auto& keyValue : layoutsMap_) assert(keyValue.second.descSetLayouts.size() == DESC_SET_STAGE_PAIRS.size());
+    for (const auto& keyValue : layoutsMap_) assert(keyValue.second.descSetLayouts.size() == descSetStagePairs.size());
+
+    // BINDLESS
+    if (isBindless()) {
+        const auto& bindless = handler().descriptorHandler().bindless();
+        assert(bindless.isEnabled());
+        const auto setIndex = static_cast<uint8_t>(descSetStagePairs.size());
+        for (auto& [passTypes, replaceTuples] : shaderTextReplaceInfoMap_)
+            replaceTuples.push_back({std::string(Descriptor::Bindless::MACRO_NAME), setIndex, {}, passTypes});
+        for (auto& [passTypes, layouts] : layoutsMap_) layouts.descSetLayouts.push_back(bindless.getLayout());
+    }
 }
 
 std::shared_ptr<Pipeline::BindData> Pipeline::Base::makeBindData(const vk::PipelineLayout& layout) {
@@ -208,6 +273,7 @@ std::shared_ptr<Pipeline::BindData> Pipeline::Base::makeBindData(const vk::Pipel
         pushConstantStages,
         PUSH_CONSTANT_TYPES,
         false,
+        isBindless() ? static_cast<uint32_t>(getDescSetStagePairs().size()) : UINT32_MAX,
     });
 }
 
@@ -332,6 +398,14 @@ void Pipeline::Compute::setInfo(CreateInfoResources& createInfoRes, vk::Graphics
     // I believe these asserts should always be the case. Not sure though.
     assert(createInfoRes.shaderStageInfos.size() == 1);
     assert(createInfoRes.shaderStageInfos.front().stage == vk::ShaderStageFlagBits::eCompute);
+
+    // LOCAL SIZE
+    // The local size is specialized instead of replaced in the shader text, so pipelines that only differ by local size
+    //  share a module.
+    AddSpecializationConstants(createInfoRes, {{{LOCAL_SIZE_X_CONSTANT_ID, localSize_.x},
+                                                {LOCAL_SIZE_Y_CONSTANT_ID, localSize_.y},
+                                                {LOCAL_SIZE_Z_CONSTANT_ID, localSize_.z}}});
+
     pComputeInfo->stage = createInfoRes.shaderStageInfos.front();
 }
 
@@ -649,6 +723,9 @@ std::unique_ptr<Pipeline::Base> Pipeline::Default::MakeCubeMapTexture(Pipeline::
     info.name = "Cube Map Texture";
     info.type = GRAPHICS::CUBE_MAP_TEX;
     info.shaderTypes = {SHADER::VERT_TEX_CUBE_MAP, SHADER::GEOM_TEX_CUBE_MAP, SHADER::TEX_FRAG};
+    info.pushConstantTypes.clear();
+    info.bindless = false;
+    info.bindlessDescSetStagePairs.clear();
     info.descSetStagePairs.push_back(
         {DESCRIPTOR_SET::CAMERA_CUBE_MAP,
          (vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eGeometry | vk::ShaderStageFlagBits::eFragment)});
@@ -28,6 +28,10 @@ class Handler;
 void GetDefaultColorInputAssemblyInfoResources(CreateInfoResources &createInfoRes);
 void GetDefaultTextureInputAssemblyInfoResources(CreateInfoResources &createInfoRes);
 void GetDefaultScreenQuadInputAssemblyInfoResources(CreateInfoResources &createInfoRes);
+// Specializes each stage in "shaderStageInfos" with the constants at the same index, keeping whatever the stage was
+//  already specialized with.
+void AddSpecializationConstants(CreateInfoResources &createInfoRes,
+                                const std::vector<specializationConstants> &stagesConstants);
 
 struct Layouts {
     vk::PipelineLayout pipelineLayout;
@@ -50,6 +54,13 @@ class Base : public Handlee<Pipeline::Handler> {
     const std::string NAME;
     const std::vector<PUSH_CONSTANT> PUSH_CONSTANT_TYPES;
     const PIPELINE TYPE;
+    const bool BINDLESS;
+    const Descriptor::Set::typeShaderStagePairs BINDLESS_DESC_SET_STAGE_PAIRS;
+
+    // True if the pipeline was made bindless and the device has descriptor indexing.
+    bool isBindless() const;
+    // The pipeline's own sets on this device. A bindless pipeline also gets Descriptor::Bindless's set after these.
+    const Descriptor::Set::typeShaderStagePairs &getDescSetStagePairs() const;
 
     virtual void init();
     virtual void updateStatus();
@@ -214,6 +214,15 @@ const Pipeline::CreateInfo TRI_LIST_TEX_CREATE_INFO = {
         {DESCRIPTOR_SET::SAMPLER_DEFAULT, vk::ShaderStageFlagBits::eFragment},
         // {DESCRIPTOR_SET::PROJECTOR_DEFAULT, vk::ShaderStageFlagBits::eFragment},
     },
+    {},
+    {PUSH_CONSTANT::BINDLESS},
+    {1, 1, 1},
+    // The material and its texture are indexed out of the bindless arrays, so there is no per material set.
+    true,
+    {
+        {DESCRIPTOR_SET::UNIFORM_DEFAULT_BINDLESS,
+         (vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)},
+    },
 };
 
 // CUBE
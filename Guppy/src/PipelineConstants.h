@@ -24,7 +24,14 @@ enum class VERTEX;
 
 namespace Pipeline {
 
-constexpr std::string_view LOCAL_SIZE_MACRO_ID_PREFIX = "_LS_";
+// Specialization constant ids of the compute local size ("local_size_x_id" etc.). Every compute pipeline specializes
+//  them, so they are high enough to stay out of the way of a pipeline's own constants.
+constexpr uint32_t LOCAL_SIZE_X_CONSTANT_ID = 100;
+constexpr uint32_t LOCAL_SIZE_Y_CONSTANT_ID = 101;
+constexpr uint32_t LOCAL_SIZE_Z_CONSTANT_ID = 102;
+
+// {constant_id, value} pairs a shader stage is specialized with when its pipeline is created.
+using specializationConstants = std::vector<std::pair<uint32_t, uint32_t>>;
 
 // clang-format off
 struct IsGraphics {
@@ -67,6 +74,7 @@ struct BindData {
     vk::ShaderStageFlags pushConstantStages;
     const std::vector<PUSH_CONSTANT> pushConstantTypes;
     bool usesAdjacency;
+    const uint32_t bindlessSet;  // Index of Descriptor::Bindless's set in the layout, or UINT32_MAX.
 };
 
 // Map of pipeline/pass to bind data shared pointers
@@ -86,6 +94,11 @@ struct CreateInfo {
     Descriptor::OffsetsMap uniformOffsets;
     std::vector<PUSH_CONSTANT> pushConstantTypes;
     glm::uvec3 localSize{1, 1, 1};  // compute only
+    // If the device has descriptor indexing (Context::bindlessEnabled) the pipeline uses "bindlessDescSetStagePairs"
+    //  instead of "descSetStagePairs", and gets Descriptor::Bindless's set after them. PUSH_CONSTANT::BINDLESS has to be
+    //  the first push constant type.
+    bool bindless = false;
+    Descriptor::Set::typeShaderStagePairs bindlessDescSetStagePairs;
 };
 
 namespace Default {
@@ -5,7 +5,11 @@
 
 #include "PipelineHandler.h"
 
+#include <chrono>
+#include <cstring>
+#include <fstream>
 #include <variant>
+#include <Common/Helpers.h>
 
 #include "Cdlod.h"
 #include "Cloth.h"
@@ -36,6 +40,17 @@
 
 namespace {
 
+const std::string PIPELINE_CACHE_PATH = ROOT_PATH + "pipelines.gpc";
+
+// VkPipelineCacheHeaderVersionOne
+struct PipelineCacheHeader {
+    uint32_t headerSize;
+    uint32_t headerVersion;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+};
+
 template <typename TCreateInfo>
 void setBase(const vk::Pipeline& pipeline, TCreateInfo& info, bool& hasBase) {
     if (!hasBase && pipeline) {
@@ -145,10 +160,22 @@ Pipeline::Handler::Handler(Game* pGame) : Game::Handler(pGame), cache_(), maxPus
 
 void Pipeline::Handler::reset() {
     // PIPELINE
+    if (pCreateBatch_) {
+        // Nothing is going to use them.
+        pCreateBatch_->future.wait();
+        for (auto& job : pCreateBatch_->jobs)
+            if (job.pipeline) shell().context().dev.destroyPipeline(job.pipeline, shell().context().pAllocator);
+        pCreateBatch_ = nullptr;
+        pendingTypes_.clear();
+    }
     pipelineBindDataMap_.clear();
     for (auto& [type, pPipeline] : pPipelines_) pPipeline->destroy();
     // CACHE
-    if (cache_) shell().context().dev.destroyPipelineCache(cache_, shell().context().pAllocator);
+    if (cache_) {
+        savePipelineCache();
+        shell().context().dev.destroyPipelineCache(cache_, shell().context().pAllocator);
+        cache_ = nullptr;
+    }
 
     maxPushConstantsSize_ = 0;
 }
@@ -181,6 +208,8 @@ void Pipeline::Handler::init() {
 }
 
 void Pipeline::Handler::tick() {
+    // One batch at a time. Anything that needs an update in the meantime waits for the next one.
+    if (pCreateBatch_ && !finishPipelines(false)) return;
     if (needsUpdateSet_.empty()) return;
 
     pipelinePassSet updateSet;
@@ -200,7 +229,6 @@ void Pipeline::Handler::tick() {
     if (updateSet.empty()) return;
 
     createPipelines(updateSet);
-    passHandler().updateBindData(updateSet);
 
     needsUpdateSet_.clear();
 }
@@ -232,6 +260,7 @@ std::vector<vk::PushConstantRange> Pipeline::Handler::getPushConstantRanges(
             case PUSH_CONSTANT::HFF_COLUMN:         range.size = sizeof(HeightFieldFluid::Column::PushConstant); break;
             case PUSH_CONSTANT::FFT_ROW_COL_OFFSET: range.size = sizeof(::FFT::RowColumnOffset); break;
             case PUSH_CONSTANT::CDLOD:              range.size = sizeof(::Cdlod::PushConstant); break;
+            case PUSH_CONSTANT::BINDLESS:           range.size = sizeof(Descriptor::Bindless::PushConstant); break;
             default: assert(false && "Unknown push constant"); exit(EXIT_FAILURE);
         }
         // clang-format on
@@ -269,12 +298,46 @@ std::vector<vk::PushConstantRange> Pipeline::Handler::getPushConstantRanges(
 }
 
 void Pipeline::Handler::createPipelineCache(vk::PipelineCache& cache) {
+    std::vector<char> data;
+    std::ifstream file(PIPELINE_CACHE_PATH, std::ios::binary | std::ios::ate);
+    if (file.is_open()) {
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(data.data(), data.size())) data.clear();
+    }
+
+    // Only hand the driver data that it made for this exact device.
+    if (data.size() >= sizeof(PipelineCacheHeader)) {
+        const auto& props = shell().context().physicalDevProps[shell().context().physicalDevIndex].properties;
+        PipelineCacheHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.headerSize < sizeof(PipelineCacheHeader) || header.headerSize > data.size() ||
+            header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || header.vendorID != props.vendorID ||
+            header.deviceID != props.deviceID ||
+            std::memcmp(header.pipelineCacheUUID, &props.pipelineCacheUUID[0], VK_UUID_SIZE) != 0) {
+            shell().log(Shell::LogPriority::LOG_INFO, "Pipeline cache was made for a different device or driver.");
+            data.clear();
+        }
+    } else {
+        data.clear();
+    }
+
     vk::PipelineCacheCreateInfo createInfo = {};
-    createInfo.initialDataSize = 0;
-    createInfo.pInitialData = nullptr;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
     cache = shell().context().dev.createPipelineCache(createInfo, shell().context().pAllocator);
 }
 
+void Pipeline::Handler::savePipelineCache() {
+    auto data = shell().context().dev.getPipelineCacheData(cache_);
+    if (data.empty()) return;
+    std::ofstream file(PIPELINE_CACHE_PATH, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !file.write(reinterpret_cast<const char*>(data.data()), data.size())) {
+        std::string msg = "\nCould not write pipeline cache \"" + PIPELINE_CACHE_PATH + "\".\n";
+        shell().log(Shell::LogPriority::LOG_WARN, msg.c_str());
+    }
+}
+
 #define PRINT_NAME_BEFORE_CREATE false
 #define PRINT_NAME_AFTER_CREATE false
 #if PRINT_NAME_AFTER_CREATE
@@ -326,99 +389,115 @@ void Pipeline::Handler::initPipelines() {
     pipelinePassSet set;
     passHandler().addPipelinePassPairs(set);
     createPipelines(set);
-    passHandler().updateBindData(set);
+    // Everything that records expects these to exist from the first frame, so only the creation itself is parallel.
+    finishPipelines(true);
+    savePipelineCache();
 }
 
 void Pipeline::Handler::createPipelines(const pipelinePassSet& set) {
-    vk::GraphicsPipelineCreateInfo graphicsCreateInfo;
-    vk::ComputePipelineCreateInfo computeCreateInfo;
-    CreateInfoResources createInfoRes;
-
-    auto it = set.begin();
-    while (it != set.end()) {
-        // Clear out memory
-        graphicsCreateInfo = vk::GraphicsPipelineCreateInfo{};
-        computeCreateInfo = vk::ComputePipelineCreateInfo{};
-        createInfoRes = {};
-
-        auto pipelineType = it->first;
-        auto& pPipeline = getPipeline(it->first);
-
-        while (it != set.end() && it->first == pipelineType) {
-            bool hasBase = false;
-
-            // Get pipeline from map or create a map element
-            pipelineBindDataMapKey key = {pipelineType, it->second};
-            if (pipelineBindDataMap_.count(key) == 0) {
-                pipelineBindDataMap_.insert({key, pPipeline->getBindData(it->second)});
-            }
-
-            const auto& pPipelineBindData = pipelineBindDataMap_.at(key);
-
-            // SHADER
-            {
-                createInfoRes.shaderStageInfos.clear();
-                createInfoRes.specializationMapEntries.clear();
-                createInfoRes.specializationInfo.clear();
-                for (const auto& shaderType : pPipeline->getShaderTypes()) {
-                    shaderHandler().getStagesInfo(shaderType, pPipeline->TYPE, it->second, createInfoRes.shaderStageInfos);
-                }
-            }
-
-            // TODO: This can be simplified.
-            switch (pPipelineBindData->bindPoint) {
-                // GRAPHICS
-                case vk::PipelineBindPoint::eGraphics: {
-                    assert(std::visit(Pass::IsRender{}, it->second));
-                    const auto& pPass = passHandler().renderPassMgr().getPass(std::visit(Pass::GetRender{}, it->second));
-
-                    setBase(pPipelineBindData->pipeline, graphicsCreateInfo, hasBase);
+    assert(!pCreateBatch_);
+    pCreateBatch_ = std::make_unique<CreateBatch>();
+    pCreateBatch_->set = set;
+
+    // Everything but the create calls happens here.
+    for (const auto& [pipelineType, passType] : set) {
+        auto& pPipeline = getPipeline(pipelineType);
+        bool hasBase = false;
+
+        // Get pipeline from map or create a map element
+        pipelineBindDataMapKey key = {pipelineType, passType};
+        if (pipelineBindDataMap_.count(key) == 0) {
+            pipelineBindDataMap_.insert({key, pPipeline->getBindData(passType)});
+        }
 
-                    graphicsCreateInfo.renderPass = pPass->pass;
-                    graphicsCreateInfo.subpass = pPass->getSubpassId(pipelineType);
-                    graphicsCreateInfo.layout = pPipelineBindData->layout;
-                    pPipeline->setInfo(createInfoRes, &graphicsCreateInfo, nullptr);
+        const auto& pPipelineBindData = pipelineBindDataMap_.at(key);
 
-                    // Give the render pass a chance to override default settings
-                    pPass->overridePipelineCreateInfo(pipelineType, createInfoRes);
+        pCreateBatch_->jobs.push_back({key, pPipeline->NAME + " (" + std::visit(Pass::GetTypeString{}, passType) + ")",
+                                       pPipelineBindData->bindPoint, std::make_unique<CreateInfoResources>()});
+        auto& job = pCreateBatch_->jobs.back();
+        auto& createInfoRes = *job.pCreateInfoRes;
 
-                    if (hasAdjacencyTopology(graphicsCreateInfo)) {
-                        pPipelineBindData->usesAdjacency = true;
-                    }
+        // SHADER
+        std::vector<specializationConstants> stagesConstants;
+        for (const auto& shaderType : pPipeline->getShaderTypes()) {
+            shaderHandler().getStagesInfo(shaderType, pPipeline->TYPE, passType, createInfoRes.shaderStageInfos,
+                                          stagesConstants);
+        }
 
-                    // Save the old pipeline for clean up if necessary
-                    if (pPipelineBindData->pipeline) oldPipelines_.push_back({-1, pPipelineBindData->pipeline});
+        // The current pipeline stays around until the new one replaces it, so it can be the base.
+        // TODO: This can be simplified.
+        switch (pPipelineBindData->bindPoint) {
+            // GRAPHICS
+            case vk::PipelineBindPoint::eGraphics: {
+                assert(std::visit(Pass::IsRender{}, passType));
+                const auto& pPass = passHandler().renderPassMgr().getPass(std::visit(Pass::GetRender{}, passType));
 
-                    createPipeline(pPipeline->NAME + " (" + std::visit(Pass::GetTypeString{}, it->second) + ")",
-                                   graphicsCreateInfo, pPipelineBindData->pipeline);
+                setBase(pPipelineBindData->pipeline, job.graphicsCreateInfo, hasBase);
 
-                    setBase(pPipelineBindData->pipeline, graphicsCreateInfo, hasBase);
+                job.graphicsCreateInfo.renderPass = pPass->pass;
+                job.graphicsCreateInfo.subpass = pPass->getSubpassId(pipelineType);
+                job.graphicsCreateInfo.layout = pPipelineBindData->layout;
+                pPipeline->setInfo(createInfoRes, &job.graphicsCreateInfo, nullptr);
 
-                } break;
-                // COMPUTE
-                case vk::PipelineBindPoint::eCompute: {
-                    setBase(pPipelineBindData->pipeline, computeCreateInfo, hasBase);
+                // Give the render pass a chance to override default settings
+                pPass->overridePipelineCreateInfo(pipelineType, createInfoRes);
 
-                    computeCreateInfo.layout = pPipelineBindData->layout;
-                    pPipeline->setInfo(createInfoRes, nullptr, &computeCreateInfo);
+                // Shaders are compiled once per text, so what varies between the pipelines that share them (the light
+                //  array lengths) is specialized here.
+                AddSpecializationConstants(createInfoRes, stagesConstants);
 
-                    // Save the old pipeline for clean up if necessary
-                    if (pPipelineBindData->pipeline) oldPipelines_.push_back({-1, pPipelineBindData->pipeline});
+                if (hasAdjacencyTopology(job.graphicsCreateInfo)) {
+                    pPipelineBindData->usesAdjacency = true;
+                }
+            } break;
+            // COMPUTE
+            case vk::PipelineBindPoint::eCompute: {
+                setBase(pPipelineBindData->pipeline, job.computeCreateInfo, hasBase);
+
+                job.computeCreateInfo.layout = pPipelineBindData->layout;
+                pPipeline->setInfo(createInfoRes, nullptr, &job.computeCreateInfo);
+            } break;
+            default: {
+                assert(false);  // I think the only other types are ray tracing
+            } break;
+        }
 
-                    createPipeline(pPipeline->NAME + " (" + std::visit(Pass::GetTypeString{}, it->second) + ")",
-                                   computeCreateInfo, pPipelineBindData->pipeline);
+        // Anything that waits on the pipeline's status waits for the first one to be made.
+        if (!pPipelineBindData->pipeline) {
+            pendingTypes_.insert(pipelineType);
+            if (pPipeline->status_ == STATUS::READY) pPipeline->status_ = STATUS::PENDING_PIPELINE;
+        }
+    }
 
-                    setBase(pPipelineBindData->pipeline, computeCreateInfo, hasBase);
+    // Pipeline creation is thread safe, including on the same cache, so the batch is spread over every thread.
+    auto* pBatch = pCreateBatch_.get();
+    pCreateBatch_->future = std::async(std::launch::async, [this, pBatch]() {
+        helpers::parallelFor(pBatch->jobs.size(), [this, pBatch](const size_t i) {
+            auto& job = pBatch->jobs[i];
+            if (job.bindPoint == vk::PipelineBindPoint::eGraphics)
+                createPipeline(job.name, job.graphicsCreateInfo, job.pipeline);
+            else
+                createPipeline(job.name, job.computeCreateInfo, job.pipeline);
+        });
+    });
+}
 
-                } break;
-                default: {
-                    assert(false);  // I think the only other types are ray tracing
-                } break;
-            }
+bool Pipeline::Handler::finishPipelines(const bool wait) {
+    assert(pCreateBatch_);
+    if (!wait && pCreateBatch_->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+    pCreateBatch_->future.get();
 
-            ++it;
-        }
+    for (auto& job : pCreateBatch_->jobs) {
+        const auto& pPipelineBindData = pipelineBindDataMap_.at(job.key);
+        // Save the old pipeline for clean up if necessary
+        if (pPipelineBindData->pipeline) oldPipelines_.push_back({-1, pPipelineBindData->pipeline});
+        pPipelineBindData->pipeline = job.pipeline;
     }
+    pendingTypes_.clear();
+    passHandler().updateBindData(pCreateBatch_->set);
+
+    pCreateBatch_ = nullptr;
+    return true;
 }
 
 void Pipeline::Handler::makeShaderInfoMap(Shader::infoMap& map) {
@@ -453,7 +532,7 @@ void Pipeline::Handler::getShaderStages(const std::set<PIPELINE>& pipelineTypes,
                 // looking for.
                 if ((std::visit(Pipeline::IsGraphics{}, pipelineType) && std::visit(Pipeline::IsGraphics{}, type)) ||
                     (std::visit(Pipeline::IsCompute{}, pipelineType) && std::visit(Pipeline::IsCompute{}, type))) {
-                    for (const auto& pair : pPipeline->DESC_SET_STAGE_PAIRS) {
+                    for (const auto& pair : pPipeline->getDescSetStagePairs()) {
                         if (descSetType == pair.first) {
                             stages |= pair.second;
                         }
@@ -465,7 +544,7 @@ void Pipeline::Handler::getShaderStages(const std::set<PIPELINE>& pipelineTypes,
             auto it = pPipelines_.find(pipelineType);
             assert(it != pPipelines_.end());
             bool found = false;
-            for (const auto& pair : it->second->DESC_SET_STAGE_PAIRS) {
+            for (const auto& pair : it->second->getDescSetStagePairs()) {
                 if (pair.first == descSetType) {
                     found = true;
                     stages |= pair.second;
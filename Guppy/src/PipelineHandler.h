@@ -6,7 +6,9 @@
 #ifndef PIPELINE_HANDLER_H
 #define PIPELINE_HANDLER_H
 
+#include <future>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -40,7 +42,11 @@ class Handler : public Game::Handler {
 
     // PIPELINES
     void initPipelines();
+    // Starts making the pipelines for "set" in the background. The bind data keeps its current pipeline until they are
+    //  all done, and pipelines that had none are PENDING_PIPELINE until then.
     void createPipelines(const pipelinePassSet &set);
+    inline bool isCreatingPipelines() const { return pCreateBatch_ != nullptr; }
+    inline bool isPending(const PIPELINE &type) const { return pendingTypes_.count(type) > 0; }
     void createPipeline(const std::string name, vk::GraphicsPipelineCreateInfo &createInfo, vk::Pipeline &pipeline);
     void createPipeline(const std::string name, vk::ComputePipelineCreateInfo &createInfo, vk::Pipeline &pipeline);
     constexpr const auto &getPipelineBindDataMap() const { return pipelineBindDataMap_; }
@@ -67,15 +73,35 @@ class Handler : public Game::Handler {
     void reset() override;
 
     // CACHE
-    vk::PipelineCache cache_;  // TODO: what is this for???
+    vk::PipelineCache cache_;
+    void savePipelineCache();
 
     // PUSH CONSTANT
     uint32_t maxPushConstantsSize_;
 
     // PIPELINES
+    struct CreateJob {
+        pipelineBindDataMapKey key;
+        std::string name;
+        vk::PipelineBindPoint bindPoint;
+        std::unique_ptr<CreateInfoResources> pCreateInfoRes;  // The create infos point in here.
+        vk::GraphicsPipelineCreateInfo graphicsCreateInfo;
+        vk::ComputePipelineCreateInfo computeCreateInfo;
+        vk::Pipeline pipeline;
+    };
+    struct CreateBatch {
+        pipelinePassSet set;
+        std::vector<CreateJob> jobs;
+        std::future<void> future;
+    };
     void createPipelineCache(vk::PipelineCache &cache);
+    // Swaps in the pipelines of the batch in flight if it is done, or once it is if "wait" is true. Returns false if it
+    //  is still going.
+    bool finishPipelines(const bool wait);
     std::map<PIPELINE, std::unique_ptr<Pipeline::Base>> pPipelines_;
     pipelineBindDataMap pipelineBindDataMap_;
+    std::unique_ptr<CreateBatch> pCreateBatch_;
+    std::set<PIPELINE> pendingTypes_;
 
     // CLEAN UP
     std::set<PIPELINE> needsUpdateSet_;
@@ -213,25 +213,25 @@ void RenderPass::Base::record(const uint8_t frameIndex) {
     vk::CommandBufferBeginInfo bufferInfo = {vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
     priCmd.begin(bufferInfo);
 
-    beginPass(priCmd, frameIndex, vk::SubpassContents::eInline);
-    // pPass->beginPass(frameIndex, vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
-    // vk::SubpassContents::eSecondaryCommandBuffers);
-
     auto& secCmd = data.secCmds[frameIndex];
     auto& pScene = handler().sceneHandler().getActiveScene();
 
-    auto it = pipelineBindDataList_.getValues().begin();
-    while (it != pipelineBindDataList_.getValues().end()) {
-        pScene->record(TYPE, (*it)->type, (*it), priCmd, secCmd, frameIndex);
-
-        ++it;
-
-        if (it != pipelineBindDataList_.getValues().end()) {
-            priCmd.nextSubpass(vk::SubpassContents::eInline);
-            // priCmd.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
-        }
+    // RECORD
+    std::vector<ReuseJob> jobs;
+    for (const auto& pPipelineBindData : pipelineBindDataList_.getValues()) {
+        jobs.push_back({pPipelineBindData->type, getSubpassId(pPipelineBindData->type), false, false,
+                        [&, pPipelineBindData](const vk::CommandBuffer& cmd) {
+                            pScene->record(TYPE, pPipelineBindData->type, pPipelineBindData, cmd, secCmd, frameIndex);
+                        }});
     }
+    recordReuse(jobs, frameIndex);
 
+    // EXECUTE
+    beginPass(priCmd, frameIndex, vk::SubpassContents::eSecondaryCommandBuffers);
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (i) priCmd.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
+        executeReuse(jobs[i].pipelineType, frameIndex, priCmd);
+    }
     endPass(priCmd);
 
     // priCmd.end();
@@ -276,10 +276,11 @@ void RenderPass::Base::beginPass(const vk::CommandBuffer& cmd, const uint8_t fra
     const_cast<vk::RenderPassBeginInfo*>(&beginInfo_)->framebuffer = data.framebuffers[frameIndex];
     //// Start a new debug marker region
     // priCmd.debugMarkerBeginEXT("Render x scene", {0.2f, 0.3f, 0.4f, 1.0f});
-    cmd.beginRenderPass(beginInfo_, subpassContents);
-    // Frame commands
+    // Frame commands. These come first because nothing but vkCmdExecuteCommands can go in a subpass that uses
+    // secondary command buffers. The secondary command buffers set their own.
     cmd.setScissor(0, scissors_);
     cmd.setViewport(0, viewports_);
+    cmd.beginRenderPass(beginInfo_, subpassContents);
 }
 
 void RenderPass::Base::endPass(const vk::CommandBuffer& cmd) const {
@@ -500,12 +501,12 @@ void RenderPass::Base::createImageResources() {
 
         images_.push_back({});
 
-        helpers::createImage(ctx.dev, ctx.memProps,
+        helpers::createImage(ctx.dev, *ctx.pMemAllocator,
                              handler().commandHandler().getUniqueQueueFamilies(true, false, true, false),
                              pipelineData_.samples, format_, vk::ImageTiling::eOptimal,
                              vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment,
                              vk::MemoryPropertyFlagBits::eDeviceLocal, extent_.width, extent_.height, 1, 1,
-                             images_.back().image, images_.back().memory, ctx.pAllocator);
+                             images_.back().image, images_.back().allocation, ctx.pAllocator);
 
         vk::ImageSubresourceRange range = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
         helpers::createImageView(ctx.dev, images_.back().image, format_, vk::ImageViewType::e2D, range, images_.back().view,
@@ -531,11 +532,11 @@ void RenderPass::Base::createDepthResource() {
             throw std::runtime_error(("depth format unsupported"));
         }
 
-        helpers::createImage(ctx.dev, ctx.memProps,
+        helpers::createImage(ctx.dev, *ctx.pMemAllocator,
                              handler().commandHandler().getUniqueQueueFamilies(true, false, true, false),
                              pipelineData_.samples, depthFormat_, tiling, vk::ImageUsageFlagBits::eDepthStencilAttachment,
                              vk::MemoryPropertyFlagBits::eDeviceLocal, extent_.width, extent_.height, 1, 1, depth_.image,
-                             depth_.memory, ctx.pAllocator);
+                             depth_.allocation, ctx.pAllocator);
 
         vk::ImageAspectFlags aspectFlags = vk::ImageAspectFlagBits::eDepth;
         if (helpers::hasStencilComponent(depthFormat_)) {
@@ -661,11 +662,11 @@ void RenderPass::Base::destroyTargetResources() {
     auto& ctx = handler().shell().context();
 
     // COLOR
-    for (auto& color : images_) helpers::destroyImageResource(ctx.dev, color, ctx.pAllocator);
+    for (auto& color : images_) helpers::destroyImageResource(ctx.dev, *ctx.pMemAllocator, color, ctx.pAllocator);
     images_.clear();
 
     // DEPTH
-    helpers::destroyImageResource(ctx.dev, depth_, ctx.pAllocator);
+    helpers::destroyImageResource(ctx.dev, *ctx.pMemAllocator, depth_, ctx.pAllocator);
 
     // FRAMEBUFFER
     for (auto& framebuffer : data.framebuffers) ctx.dev.destroyFramebuffer(framebuffer, ctx.pAllocator);
@@ -677,6 +678,9 @@ void RenderPass::Base::destroyTargetResources() {
     // COMMAND
     helpers::destroyCommandBuffers(ctx.dev, handler().commandHandler().graphicsCmdPool(), data.priCmds);
     helpers::destroyCommandBuffers(ctx.dev, handler().commandHandler().graphicsCmdPool(), data.secCmds);
+    for (auto& [pipelineType, reuse] : reuseMap_)
+        helpers::destroyCommandBuffers(ctx.dev, handler().commandHandler().getWorkerCmdPool(reuse.worker), reuse.cmds);
+    reuseMap_.clear();
 
     // SEMAPHORE
     for (auto& semaphore : data.semaphores) ctx.dev.destroySemaphore(semaphore, ctx.pAllocator);
@@ -716,6 +720,66 @@ void RenderPass::Base::updateSubmitResource(SubmitResource& resource, const uint
     resource.commandBufferCount++;
 }
 
+void RenderPass::Base::setDirty() {
+    for (auto& [pipelineType, reuse] : reuseMap_) reuse.isRecorded.assign(reuse.isRecorded.size(), false);
+}
+
+void RenderPass::Base::setDirty(const PIPELINE& pipelineType) {
+    auto it = reuseMap_.find(pipelineType);
+    if (it != reuseMap_.end()) it->second.isRecorded.assign(it->second.isRecorded.size(), false);
+}
+
+void RenderPass::Base::recordReuse(const std::vector<ReuseJob>& jobs, const uint8_t frameIndex) {
+    // The map is only touched here, before any of the workers start.
+    std::vector<Reuse*> pReuses;
+    for (const auto& job : jobs) pReuses.push_back(&getReuse(job.pipelineType, job.mainThread));
+
+    handler().commandHandler().runWorkers([&](const uint32_t worker) {
+        for (size_t i = 0; i < jobs.size(); i++)
+            if (pReuses[i]->worker == worker) recordReuse(*pReuses[i], jobs[i], frameIndex);
+    });
+}
+
+void RenderPass::Base::executeReuse(const PIPELINE& pipelineType, const uint8_t frameIndex,
+                                    const vk::CommandBuffer& priCmd) const {
+    priCmd.executeCommands({reuseMap_.at(pipelineType).cmds[frameIndex]});
+}
+
+RenderPass::Base::Reuse& RenderPass::Base::getReuse(const PIPELINE& pipelineType, const bool mainThread) {
+    auto& reuse = reuseMap_[pipelineType];
+    if (reuse.cmds.empty()) {
+        auto& cmdHandler = handler().commandHandler();
+        // Spread the rest over the workers in the order they show up.
+        reuse.worker = mainThread ? 0 : static_cast<uint32_t>(reuseMap_.size() % cmdHandler.getWorkerCount());
+        reuse.cmds.resize(commandCount_);
+        cmdHandler.createWorkerCmdBuffers(reuse.worker, reuse.cmds.data(), commandCount_);
+        reuse.isRecorded.assign(commandCount_, false);
+    }
+    return reuse;
+}
+
+void RenderPass::Base::recordReuse(Reuse& reuse, const ReuseJob& job, const uint8_t frameIndex) {
+    if (reuse.isRecorded[frameIndex] && !job.forceRecord) return;
+
+    vk::CommandBufferInheritanceInfo inheritInfo = {};
+    inheritInfo.renderPass = pass;
+    inheritInfo.subpass = job.subpass;
+    inheritInfo.framebuffer = data.framebuffers[frameIndex];
+
+    // Each frame has its own command buffer, and the frame fence has been waited on, so no simultaneous use.
+    vk::CommandBufferBeginInfo beginInfo = {vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritInfo};
+
+    auto& cmd = reuse.cmds[frameIndex];
+    cmd.reset({});
+    cmd.begin(beginInfo);
+    cmd.setScissor(0, scissors_);
+    cmd.setViewport(0, viewports_);
+    job.record(cmd);
+    cmd.end();
+
+    reuse.isRecorded[frameIndex] = !job.forceRecord;
+}
+
 uint32_t RenderPass::Base::getSubpassId(const PIPELINE& type) const { return pipelineBindDataList_.getOffset(type); }
 
 void RenderPass::Base::setSubpassOffsets(const std::vector<std::unique_ptr<Base>>& pPasses) {
@@ -733,6 +797,7 @@ void RenderPass::Base::setSubpassOffsets(const std::vector<std::unique_ptr<Base>
 
 void RenderPass::Base::setBindData(const PIPELINE& pipelineType, const std::shared_ptr<Pipeline::BindData>& pBindData) {
     pipelineBindDataList_.insert(pipelineType, pBindData);
+    setDirty(pipelineType);
 }
 
 void RenderPass::Base::destroy() {
@@ -6,6 +6,7 @@
 #ifndef RENDER_PASS_H
 #define RENDER_PASS_H
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -63,6 +64,10 @@ class Base : public Handlee<Pass::Handler> {
 
     virtual void updateSubmitResource(SubmitResource &resource, const uint8_t frameIndex) const;
 
+    // REUSE
+    void setDirty();
+    void setDirty(const PIPELINE &pipelineType);
+
     // SETTINGS
     constexpr const auto &getFormat() const { return format_; }
     constexpr const auto &getDepthFormat() const { return depthFormat_; }
@@ -80,7 +85,7 @@ class Base : public Handlee<Pass::Handler> {
     inline bool hasTargetSwapchain() const { return getTargetId() == SWAPCHAIN_TARGET_ID; }
 
     // SUBPASS
-    uint32_t getSubpassId(const PIPELINE &type) const;
+    virtual uint32_t getSubpassId(const PIPELINE &type) const;
     void setSubpassOffsets(const std::vector<std::unique_ptr<Base>> &pPasses);
 
     constexpr const auto &getDependentTypeOffsetPairs() const { return dependentTypeOffsetPairs_; }
@@ -155,6 +160,26 @@ class Base : public Handlee<Pass::Handler> {
     vk::CommandBufferBeginInfo secCmdBeginInfo_;
     bool secCmdFlag_;
 
+    // REUSE
+    /* Secondary command buffers (one per frame) that are recorded once and then executed every frame until
+     *  "setDirty" is called for their pipeline type, or the target is recreated. A subpass that uses these has to be
+     *  started with vk::SubpassContents::eSecondaryCommandBuffers, and everything in it has to go through them.
+     *  "recordReuse" records whichever of the jobs need it, spread over the command handler's workers, and returns once
+     *  they are all done. Nothing is executed, so the order the secondaries end up in the primary is the order of the
+     *  "executeReuse" calls. A job's "record" can run on any worker unless "mainThread" is set, so it should only read.
+     *  Even a "mainThread" job runs next to the others, so its changes have to go through
+     *  "Command::Handler::afterWorkers" ("RenderPass::Manager::setDirty" already does).
+     */
+    struct ReuseJob {
+        PIPELINE pipelineType;
+        uint32_t subpass;
+        bool forceRecord;  // Record even if the last recording is still good.
+        bool mainThread;   // "record" is not safe to call on a worker thread.
+        std::function<void(const vk::CommandBuffer &)> record;
+    };
+    void recordReuse(const std::vector<ReuseJob> &jobs, const uint8_t frameIndex);
+    void executeReuse(const PIPELINE &pipelineType, const uint8_t frameIndex, const vk::CommandBuffer &priCmd) const;
+
     // ATTACHMENT
     std::vector<ImageResource> images_;
     ImageResource depth_;
@@ -188,6 +213,16 @@ class Base : public Handlee<Pass::Handler> {
 
     void createSemaphores();
     void createAttachmentDebugMarkers();
+
+    // REUSE
+    struct Reuse {
+        std::vector<vk::CommandBuffer> cmds;  // Per frame
+        std::vector<bool> isRecorded;         // Per frame
+        uint32_t worker = 0;                  // The command pool "cmds" came from.
+    };
+    Reuse &getReuse(const PIPELINE &pipelineType, const bool mainThread);
+    void recordReuse(Reuse &reuse, const ReuseJob &job, const uint8_t frameIndex);
+    std::map<PIPELINE, Reuse> reuseMap_;
 };
 
 }  // namespace RenderPass
@@ -66,8 +66,8 @@ const CreateInfo DEFERRED_CREATE_INFO = {
         /**
          * These compute passes have sister graphics passes earlier in the list. There should be some kind of validation, or
          * potentially a data structure change so that this is more explicit. Also, its kind of misleading that these are at
-         * the end of the list when they will always be executed first, but the subpass dependency code is easier to debug
-         * with the indices being accurate for the graphics pass order.
+         * the end of the list when they will always be executed first. The order of the graphics pipelines above is only
+         * draw order now, since they all share the G-buffer subpass.
          */
         COMPUTE::PRTCL_EULER,
         COMPUTE::PRTCL_ATTR,
@@ -95,6 +95,28 @@ const CreateInfo DEFERRED_CREATE_INFO = {
 };
 // clang-format on
 
+/* What these draw changes from frame to frame (particle counts, CDLOD/ocean node selection...), so their G-buffer
+ *  secondary command buffers are recorded every frame instead of reused. Their renderers update themselves while
+ *  recording, so they are also recorded on the main thread.
+ */
+const std::set<PIPELINE> RECORD_EVERY_FRAME = {
+    GRAPHICS::PRTCL_FOUNTAIN_EULER_DEFERRED,
+    GRAPHICS::PRTCL_ATTR_PT_DEFERRED,
+    GRAPHICS::PRTCL_CLOTH_DEFERRED,
+    GRAPHICS::HFF_CLMN_DEFERRED,
+    GRAPHICS::HFF_WF_DEFERRED,
+    GRAPHICS::HFF_OCEAN_DEFERRED,
+    GRAPHICS::PRTCL_FOUNTAIN_DEFERRED,
+#if !(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
+    GRAPHICS::OCEAN_WF_TESS_DEFERRED,
+    GRAPHICS::OCEAN_SURFACE_TESS_DEFERRED,
+#endif
+    GRAPHICS::OCEAN_WF_DEFERRED,
+    GRAPHICS::OCEAN_SURFACE_DEFERRED,
+    GRAPHICS::CDLOD_WF_DEFERRED,
+    GRAPHICS::CDLOD_TEX_DEFERRED,
+};
+
 Base::Base(Pass::Handler& handler, const index&& offset)
     : RenderPass::Base{handler, std::forward<const index>(offset), &DEFERRED_CREATE_INFO},
       inputAttachmentOffset_(0),
@@ -155,84 +177,103 @@ void Base::record(const uint8_t frameIndex) {
             static_cast<Shadow::Default*>(pPass.get())->record(frameIndex, TYPE, pipelineTypes, priCmd);
         }
 
-        beginPass(priCmd, frameIndex, vk::SubpassContents::eInline);
+        // RECORD
+        std::vector<ReuseJob> jobs;
+        for (const auto& pPipelineBindData : pipelineBindDataList_.getValues()) {
+            const auto& pipelineType = pPipelineBindData->type;
+            if (std::visit(Pipeline::IsCompute{}, pipelineType)) continue;
+            if (getSubpassId(pipelineType) != GBUFFER_SUBPASS) continue;
+            const bool everyFrame = RECORD_EVERY_FRAME.count(pipelineType);
+            jobs.push_back({pipelineType, GBUFFER_SUBPASS, everyFrame, everyFrame,
+                            [this, pPipelineBindData, frameIndex](const vk::CommandBuffer& cmd) {
+                                recordGBuffer(pPipelineBindData, cmd, frameIndex);
+                            }});
+        }
+        jobs.push_back({GRAPHICS::DEFERRED_COMBINE, combinePassIndex_, false, false,
+                        [this, frameIndex](const vk::CommandBuffer& cmd) {
+                            const PIPELINE pipelineType = GRAPHICS::DEFERRED_COMBINE;
+                            handler().renderPassMgr().getScreenQuad()->draw(
+                                TYPE, pipelineBindDataList_.getValue(pipelineType),
+                                getDescSetBindDataMap(pipelineType).begin()->second, cmd, frameIndex);
+                        }});
+        recordReuse(jobs, frameIndex);
 
-        auto& pScene = handler().sceneHandler().getActiveScene();
+        beginPass(priCmd, frameIndex, vk::SubpassContents::eSecondaryCommandBuffers);
 
-        for (const auto& pPipelineBindData : pipelineBindDataList_.getValues()) {
-            if (std::visit(Pipeline::IsGraphics{}, pPipelineBindData->type)) {
-                auto graphicsType = std::visit(Pipeline::GetGraphics{}, pPipelineBindData->type);
-                // Push constant
-                switch (graphicsType) {
-                    case GRAPHICS::GEOMETRY_SILHOUETTE_DEFERRED:
-                    case GRAPHICS::TESS_BEZIER_4_DEFERRED:
-                    case GRAPHICS::TESS_PHONG_TRI_COLOR_DEFERRED:
-                    case GRAPHICS::TESS_PHONG_TRI_COLOR_WF_DEFERRED:
-                    case GRAPHICS::DEFERRED_MRT_COLOR:
-                    case GRAPHICS::DEFERRED_MRT_PT:
-                    case GRAPHICS::DEFERRED_MRT_LINE: {
-                        ::Deferred::PushConstant pushConstant = {::Deferred::PASS_FLAG::NONE};
-                        priCmd.pushConstants(pPipelineBindData->layout, pPipelineBindData->pushConstantStages, 0,
-                                             static_cast<uint32_t>(sizeof(::Deferred::PushConstant)), &pushConstant);
-                    } break;
-                    case GRAPHICS::DEFERRED_MRT_WF_COLOR: {
-                        ::Deferred::PushConstant pushConstant = {::Deferred::PASS_FLAG::WIREFRAME};
-                        priCmd.pushConstants(pPipelineBindData->layout, pPipelineBindData->pushConstantStages, 0,
-                                             static_cast<uint32_t>(sizeof(::Deferred::PushConstant)), &pushConstant);
-                    } break;
-                    default:;
-                }
-                // Draw
-                switch (graphicsType) {
-                    case GRAPHICS::DEFERRED_SSAO: {
-                        // This hasn't been tested in a long time. Might work to just let through.
-                        // TODO: this definitely only needs to be recorded once per swapchain creation!!!
-                        assert(doSSAO_ && false);
-                    } break;
-                    case GRAPHICS::PRTCL_FOUNTAIN_EULER_DEFERRED:
-                    case GRAPHICS::PRTCL_ATTR_PT_DEFERRED:
-                    case GRAPHICS::PRTCL_CLOTH_DEFERRED:
-                    case GRAPHICS::HFF_CLMN_DEFERRED:
-                    case GRAPHICS::HFF_WF_DEFERRED:
-                    case GRAPHICS::HFF_OCEAN_DEFERRED:
-                    case GRAPHICS::PRTCL_FOUNTAIN_DEFERRED: {
-                        // PARTICLE GRAPHICS
-                        handler().particleHandler().recordDraw(TYPE, pPipelineBindData, priCmd, frameIndex);
-                        priCmd.nextSubpass(vk::SubpassContents::eInline);
-                    } break;
-#if !(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
-                    case GRAPHICS::OCEAN_WF_TESS_DEFERRED:
-                    case GRAPHICS::OCEAN_SURFACE_TESS_DEFERRED:
-#endif
-                    case GRAPHICS::OCEAN_WF_DEFERRED:
-                    case GRAPHICS::OCEAN_SURFACE_DEFERRED:
-                    case GRAPHICS::CDLOD_WF_DEFERRED:
-                    case GRAPHICS::CDLOD_TEX_DEFERRED: {
-                        // SCENE RENDERERS
-                        handler().sceneHandler().recordRenderer(TYPE, pPipelineBindData, priCmd);
-                        priCmd.nextSubpass(vk::SubpassContents::eInline);
-                    } break;
-                    default: {
-                        // MRT PASSES
-                        auto& secCmd = data.secCmds[frameIndex];
-                        pScene->record(TYPE, pPipelineBindData->type, pPipelineBindData, priCmd, secCmd, frameIndex);
-                        priCmd.nextSubpass(vk::SubpassContents::eInline);
-                    } break;
-                    case GRAPHICS::DEFERRED_COMBINE: {
-                        // TODO: this definitely only needs to be recorded once per swapchain creation!!!
-                        handler().renderPassMgr().getScreenQuad()->draw(
-                            TYPE, pipelineBindDataList_.getValue(pPipelineBindData->type),
-                            getDescSetBindDataMap(pPipelineBindData->type).begin()->second, priCmd, frameIndex);
-                    } break;
-                }
-            }
+        // GBUFFER
+        for (size_t i = 0; i < jobs.size() - 1; i++) executeReuse(jobs[i].pipelineType, frameIndex, priCmd);
+
+        // SSAO
+        if (doSSAO_) {
+            // This hasn't been tested in a long time. Might work to just let through.
+            assert(false);
+            priCmd.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
         }
 
+        // COMBINE
+        priCmd.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
+        executeReuse(jobs.back().pipelineType, frameIndex, priCmd);
+
         endPass(priCmd);
     }
     // data.priCmds[frameIndex].end();
 }
 
+void Base::recordGBuffer(const std::shared_ptr<Pipeline::BindData>& pPipelineBindData, const vk::CommandBuffer& cmd,
+                         const uint8_t frameIndex) {
+    auto graphicsType = std::visit(Pipeline::GetGraphics{}, pPipelineBindData->type);
+    // Push constant
+    switch (graphicsType) {
+        case GRAPHICS::GEOMETRY_SILHOUETTE_DEFERRED:
+        case GRAPHICS::TESS_BEZIER_4_DEFERRED:
+        case GRAPHICS::TESS_PHONG_TRI_COLOR_DEFERRED:
+        case GRAPHICS::TESS_PHONG_TRI_COLOR_WF_DEFERRED:
+        case GRAPHICS::DEFERRED_MRT_COLOR:
+        case GRAPHICS::DEFERRED_MRT_PT:
+        case GRAPHICS::DEFERRED_MRT_LINE: {
+            ::Deferred::PushConstant pushConstant = {::Deferred::PASS_FLAG::NONE};
+            cmd.pushConstants(pPipelineBindData->layout, pPipelineBindData->pushConstantStages, 0,
+                              static_cast<uint32_t>(sizeof(::Deferred::PushConstant)), &pushConstant);
+        } break;
+        case GRAPHICS::DEFERRED_MRT_WF_COLOR: {
+            ::Deferred::PushConstant pushConstant = {::Deferred::PASS_FLAG::WIREFRAME};
+            cmd.pushConstants(pPipelineBindData->layout, pPipelineBindData->pushConstantStages, 0,
+                              static_cast<uint32_t>(sizeof(::Deferred::PushConstant)), &pushConstant);
+        } break;
+        default:;
+    }
+    // Draw
+    switch (graphicsType) {
+        case GRAPHICS::PRTCL_FOUNTAIN_EULER_DEFERRED:
+        case GRAPHICS::PRTCL_ATTR_PT_DEFERRED:
+        case GRAPHICS::PRTCL_CLOTH_DEFERRED:
+        case GRAPHICS::HFF_CLMN_DEFERRED:
+        case GRAPHICS::HFF_WF_DEFERRED:
+        case GRAPHICS::HFF_OCEAN_DEFERRED:
+        case GRAPHICS::PRTCL_FOUNTAIN_DEFERRED: {
+            // PARTICLE GRAPHICS
+            handler().particleHandler().recordDraw(TYPE, pPipelineBindData, cmd, frameIndex);
+        } break;
+#if !(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
+        case GRAPHICS::OCEAN_WF_TESS_DEFERRED:
+        case GRAPHICS::OCEAN_SURFACE_TESS_DEFERRED:
+#endif
+        case GRAPHICS::OCEAN_WF_DEFERRED:
+        case GRAPHICS::OCEAN_SURFACE_DEFERRED:
+        case GRAPHICS::CDLOD_WF_DEFERRED:
+        case GRAPHICS::CDLOD_TEX_DEFERRED: {
+            // SCENE RENDERERS
+            handler().sceneHandler().recordRenderer(TYPE, pPipelineBindData, cmd);
+        } break;
+        default: {
+            // MRT PASSES
+            auto& pScene = handler().sceneHandler().getActiveScene();
+            auto& secCmd = data.secCmds[frameIndex];
+            pScene->record(TYPE, pPipelineBindData->type, pPipelineBindData, cmd, secCmd, frameIndex);
+        } break;
+    }
+}
+
 void Base::update(const std::vector<Descriptor::Base*> pDynamicItems) {
     // Check the mesh status.
     if (handler().renderPassMgr().getScreenQuad()->getStatus() == STATUS::READY) {
@@ -352,31 +393,32 @@ void Base::createAttachments() {
     }
 }
 
+uint32_t Base::getSubpassId(const PIPELINE& type) const {
+    assert(std::visit(Pipeline::IsGraphics{}, type));
+    if (type == PIPELINE{GRAPHICS::DEFERRED_COMBINE}) {
+        assert(combinePassIndex_ > GBUFFER_SUBPASS);
+        return combinePassIndex_;
+    }
+    if (type == PIPELINE{GRAPHICS::DEFERRED_SSAO}) {
+        assert(doSSAO_);
+        return GBUFFER_SUBPASS + 1;
+    }
+    return GBUFFER_SUBPASS;
+}
+
 void Base::createSubpassDescriptions() {
     vk::SubpassDescription subpassDesc;
 
     assert(inputAttachmentOffset_ == 1);  // Swapchain should be in 0
 
-    uint32_t mrtPipelineCount = 0;
-    uint32_t compPipelineCount = 0;
-    for (const auto& pipelineType : pipelineBindDataList_.getKeys()) {
-        if (std::visit(Pipeline::IsCompute{}, pipelineType))
-            compPipelineCount++;
-        else if (pipelineType == PIPELINE{GRAPHICS::DEFERRED_SSAO} && !doSSAO_)
-            continue;
-        else if (pipelineType == PIPELINE{GRAPHICS::DEFERRED_COMBINE})
-            continue;
-        else
-            mrtPipelineCount++;
-    }
-
-    // MRT
+    // GBUFFER
     subpassDesc = vk::SubpassDescription{};
     subpassDesc.colorAttachmentCount = inputAttachmentCount_;
     subpassDesc.pColorAttachments = &resources_.colorAttachments[inputAttachmentOffset_];
     subpassDesc.pResolveAttachments = nullptr;
     subpassDesc.pDepthStencilAttachment = pipelineData_.usesDepth ? &resources_.depthStencilAttachment : nullptr;
-    resources_.subpasses.assign(mrtPipelineCount, subpassDesc);
+    resources_.subpasses.push_back(subpassDesc);
+    assert(resources_.subpasses.size() - 1 == GBUFFER_SUBPASS);
 
     // SSAO
     if (doSSAO_) {
@@ -402,107 +444,82 @@ void Base::createSubpassDescriptions() {
     subpassDesc.pDepthStencilAttachment = nullptr;
     resources_.subpasses.push_back(subpassDesc);
 
-    assert(resources_.subpasses.size() == pipelineBindDataList_.size() - compPipelineCount);
-    combinePassIndex_ = static_cast<uint32_t>(pipelineBindDataList_.size() - 1);
+    combinePassIndex_ = static_cast<uint32_t>(resources_.subpasses.size() - 1);
 }
 
 void Base::createDependencies() {
     // TODO: There might need to be an external pass dependency for the shadow passes.
 
-    vk::SubpassDependency depthDependency = {
-        0,  // srcSubpass
-        0,  // dstSubpass
-        // Both stages might have to access the depth-buffer
-        vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,      // srcStageMask
-        vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,      // dstStageMask
-        vk::AccessFlagBits::eDepthStencilAttachmentWrite,                                                    // srcAccessMask
-        vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead,  // dstAccessMask
-        vk::DependencyFlagBits::eByRegion,  // dependencyFlags
-    };
-    // vk::SubpassDependency colorDependency = {
-    //    0,                                              // srcSubpass
-    //    0,                                              // dstSubpass
-    //    vk::PipelineStageFlagBits::eColorAttachmentOutput,  // srcStageMask
-    //    vk::PipelineStageFlagBits::eColorAttachmentOutput,  // dstStageMask
-    //    vk::AccessFlagBits::eColorAttachmentWrite,           // srcAccessMask
-    //    vk::AccessFlagBits::eColorAttachmentWrite,           // dstAccessMask
-    //    vk::DependencyFlagBits::eByRegion,
-    //};
-
-    uint32_t subpass = 1;
-    for (uint32_t offset = subpass; offset < pipelineBindDataList_.size(); offset++) {
-        if (offset == 0) continue;
-        const auto& pipelineType = pipelineBindDataList_.getKey(subpass);
-        if (std::visit(Pipeline::IsCompute{}, pipelineType)) continue;
-        if (pipelineType == PIPELINE{GRAPHICS::DEFERRED_SSAO} && !doSSAO_) continue;
+    /* The geometry pipelines share the G-buffer subpass, so there are no depth dependencies between them anymore
+     *  (rasterization order covers that). What is left is what the G-buffer subpass as a whole waits on.
+     */
+    bool waitVertexInput = false, waitVertexShader = false, waitFragmentShader = false;
+    for (const auto& pipelineType : pipelineBindDataList_.getKeys()) {
         // TODO: How could this know which external subpass to wait on?
         if (pipelineType == PIPELINE{GRAPHICS::PRTCL_FOUNTAIN_EULER_DEFERRED} ||
             pipelineType == PIPELINE{GRAPHICS::PRTCL_ATTR_PT_DEFERRED} ||
             pipelineType == PIPELINE{GRAPHICS::PRTCL_CLOTH_DEFERRED} ||
             pipelineType == PIPELINE{GRAPHICS::HFF_OCEAN_DEFERRED}) {
-            // Dispatch writes into a storage buffer. Draw consumes that buffer as a vertex buffer.
-            resources_.dependencies.push_back({
-                VK_SUBPASS_EXTERNAL,
-                subpass,
-                vk::PipelineStageFlagBits::eComputeShader,
-                vk::PipelineStageFlagBits::eVertexInput,
-                vk::AccessFlagBits::eShaderWrite,
-                vk::AccessFlagBits::eVertexAttributeRead,
-                vk::DependencyFlagBits::eByRegion,
-            });
-        }
-        if (pipelineType == PIPELINE{GRAPHICS::HFF_CLMN_DEFERRED} ||  //
-            pipelineType == PIPELINE{GRAPHICS::HFF_WF_DEFERRED}) {
-            // Dispatch writes into a storage buffer. Draw consumes that buffer as a shader object.
-            resources_.dependencies.push_back({
-                VK_SUBPASS_EXTERNAL,
-                subpass,
-                vk::PipelineStageFlagBits::eComputeShader,
-                vk::PipelineStageFlagBits::eVertexShader,
-                vk::AccessFlagBits::eShaderWrite,
-                vk::AccessFlagBits::eShaderRead,
-                vk::DependencyFlagBits::eByRegion,
-            });
-        }
-        if (pipelineType == PIPELINE{GRAPHICS::DEFERRED_MRT_COLOR_RFL_RFR} ||
-            pipelineType == PIPELINE{GRAPHICS::DEFERRED_MRT_SKYBOX}) {
-            resources_.dependencies.push_back({
-                VK_SUBPASS_EXTERNAL,
-                subpass,
-                vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                vk::PipelineStageFlagBits::eFragmentShader,
-                vk::AccessFlagBits::eColorAttachmentWrite,
-                vk::AccessFlagBits::eShaderRead,
-                vk::DependencyFlagBits::eByRegion,
-            });
+            waitVertexInput = true;
+        } else if (pipelineType == PIPELINE{GRAPHICS::HFF_CLMN_DEFERRED} ||  //
+                   pipelineType == PIPELINE{GRAPHICS::HFF_WF_DEFERRED}) {
+            waitVertexShader = true;
+        } else if (pipelineType == PIPELINE{GRAPHICS::DEFERRED_MRT_COLOR_RFL_RFR} ||
+                   pipelineType == PIPELINE{GRAPHICS::DEFERRED_MRT_SKYBOX}) {
+            waitFragmentShader = true;
         }
-        depthDependency.srcSubpass = subpass - 1;
-        depthDependency.dstSubpass = subpass;
-        resources_.dependencies.push_back(depthDependency);
-        subpass++;
+    }
+
+    if (waitVertexInput) {
+        // Dispatch writes into a storage buffer. Draw consumes that buffer as a vertex buffer.
+        resources_.dependencies.push_back({
+            VK_SUBPASS_EXTERNAL,
+            GBUFFER_SUBPASS,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eVertexInput,
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eVertexAttributeRead,
+            vk::DependencyFlagBits::eByRegion,
+        });
+    }
+    if (waitVertexShader) {
+        // Dispatch writes into a storage buffer. Draw consumes that buffer as a shader object.
+        resources_.dependencies.push_back({
+            VK_SUBPASS_EXTERNAL,
+            GBUFFER_SUBPASS,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eVertexShader,
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eShaderRead,
+            vk::DependencyFlagBits::eByRegion,
+        });
+    }
+    if (waitFragmentShader) {
+        // The skybox/reflection cube maps are rendered before this pass and sampled by its fragment shaders.
+        resources_.dependencies.push_back({
+            VK_SUBPASS_EXTERNAL,
+            GBUFFER_SUBPASS,
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            vk::PipelineStageFlagBits::eFragmentShader,
+            vk::AccessFlagBits::eColorAttachmentWrite,
+            vk::AccessFlagBits::eShaderRead,
+            vk::DependencyFlagBits::eByRegion,
+        });
     }
 
     if (doSSAO_) {
         assert(false);
     } else {
         // Color input attachment dependency
-        vk::SubpassDependency combineDependency = {
-            0,                                                  // srcSubpass
-            0,                                                  // dstSubpass
+        resources_.dependencies.push_back({
+            GBUFFER_SUBPASS,                                    // srcSubpass
+            combinePassIndex_,                                  // dstSubpass
             vk::PipelineStageFlagBits::eColorAttachmentOutput,  // srcStageMask
             vk::PipelineStageFlagBits::eFragmentShader,         // dstStageMask
             vk::AccessFlagBits::eColorAttachmentWrite,          // srcAccessMask
             vk::AccessFlagBits::eInputAttachmentRead,           // dstAccessMask
             vk::DependencyFlagBits::eByRegion,                  // dependencyFlags
-        };
-
-        combineDependency.dstSubpass = pipelineBindDataList_.getOffset(PIPELINE{GRAPHICS::DEFERRED_COMBINE});
-        for (subpass = 0; subpass < pipelineBindDataList_.size(); subpass++) {
-            const auto& pipelineType = pipelineBindDataList_.getKey(subpass);
-            if (std::visit(Pipeline::IsCompute{}, pipelineType)) continue;
-            combineDependency.srcSubpass = subpass;
-            resources_.dependencies.push_back(combineDependency);
-        }
+        });
     }
 }
 
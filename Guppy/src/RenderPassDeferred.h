@@ -16,8 +16,13 @@ namespace RenderPass {
 struct CreateInfo;
 namespace Deferred {
 
+/* Every geometry pipeline (MRT, particles, scene renderers) draws into the same G-buffer subpass, so the subpass count
+ *  does not change with the pipeline list. Only SSAO and the combine (lighting) step get subpasses of their own.
+ */
 class Base : public RenderPass::Base {
    public:
+    static constexpr uint32_t GBUFFER_SUBPASS = 0;
+
     Base(Pass::Handler& handler, const index&& offset);
 
     void init() override;
@@ -25,6 +30,8 @@ class Base : public RenderPass::Base {
     void update(const std::vector<Descriptor::Base*> pDynamicItems = {}) override;
     void updateSubmitResource(SubmitResource& resource, const uint8_t frameIndex) const override;
 
+    uint32_t getSubpassId(const PIPELINE& type) const override;
+
    private:
     void createAttachments() override;
     void createSubpassDescriptions() override;
@@ -32,6 +39,9 @@ class Base : public RenderPass::Base {
     void updateClearValues() override;
     void createFramebuffers() override;
 
+    void recordGBuffer(const std::shared_ptr<Pipeline::BindData>& pPipelineBindData, const vk::CommandBuffer& cmd,
+                       const uint8_t frameIndex);
+
     uint32_t inputAttachmentOffset_;
     uint32_t inputAttachmentCount_;
     uint32_t combinePassIndex_;
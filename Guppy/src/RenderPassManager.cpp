@@ -25,6 +25,7 @@
 #include "PassHandler.h"
 #include "PipelineHandler.h"
 #include "TextureHandler.h"
+#include "UniformHandler.h"
 
 namespace {
 // clang-format off
@@ -163,6 +164,8 @@ void Manager::frame() {
             pResource->waitSemaphores[pResource->waitSemaphoreCount] = ctx.acquiredBackBuffer.acquireSemaphore;
             pResource->waitDstStageMasks[pResource->waitSemaphoreCount] = ctx.waitDstStageMask;
             pResource->waitSemaphoreCount++;
+            // Staged instance data has to be copied before anything draws with it.
+            handler().meshHandler().updateSubmitResource(*pResource, frameIndex);
         }
 
         // Record the pass and update the resources
@@ -234,6 +237,19 @@ void Manager::addPipelinePassPairs(pipelinePassSet& set) {
     }
 }
 
+void Manager::setDirty() {
+    // A worker would overwrite the flags with its own once it finishes recording, so wait for them.
+    handler().commandHandler().afterWorkers([this]() {
+        for (auto& pPass : pPasses_) pPass->setDirty();
+    });
+}
+
+void Manager::setDirty(const PIPELINE& pipelineType) {
+    handler().commandHandler().afterWorkers([this, pipelineType]() {
+        for (auto& pPass : pPasses_) pPass->setDirty(pipelineType);
+    });
+}
+
 void Manager::createCmds() {
     cmdList_.resize(10);
     for (auto& cmds : cmdList_) {
@@ -312,20 +328,25 @@ void Manager::createSwapchainResources() {
 
 void Manager::acquireBackBuffer() {
     const auto& ctx = handler().shell().context();
-    fences_.clear();
 
-    // TODO: Use the semaphores. This just waits for everything.
-    handler().loadingHandler().getFences(fences_);
-    fences_.push_back(frameFences_[frameIndex_]);
+    /* Loads are submitted ahead of this frame on the same queue, so the frame does not wait on them. Anything that
+     *  should not be used until a load is done is marked ready by its "loadSubmit" callback.
+     */
+    handler().loadingHandler().submit();
 
     // wait for the last submission since we reuse frame data.
-    auto result = ctx.dev.waitForFences(fences_, VK_TRUE, UINT64_MAX);
+    auto result = ctx.dev.waitForFences(1, &frameFences_[frameIndex_], VK_TRUE, UINT64_MAX);
     assert(result == vk::Result::eSuccess);
     result = ctx.dev.resetFences(1, &frameFences_[frameIndex_]);
     assert(result == vk::Result::eSuccess);
+
+    handler().uniformHandler().beginFrame(frameIndex_);
+    handler().descriptorHandler().beginFrame(frameIndex_);
 }
 
 void Manager::submit(const uint8_t submitCount) {
+    handler().uniformHandler().stream().flush(handler().shell().context());
+
     const SubmitResource* pResource;
     vk::SubmitInfo* pInfo;
     for (uint8_t i = 0; i < submitCount; i++) {
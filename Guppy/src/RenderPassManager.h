@@ -64,6 +64,11 @@ class Manager : public Pass::Manager {
     // PIPELINE
     void addPipelinePassPairs(pipelinePassSet& set);
 
+    // REUSE
+    // Makes the passes re-record their reused secondary command buffers (all of them, or the ones for "pipelineType").
+    void setDirty();
+    void setDirty(const PIPELINE& pipelineType);
+
     inline const auto& getFrameFence(const uint8_t frameIndex) const { return frameFences_[frameIndex]; }
 
     const std::unique_ptr<Mesh::Texture>& getScreenQuad();
@@ -77,7 +82,6 @@ class Manager : public Pass::Manager {
 
     // FENCES
     void createFences(vk::FenceCreateFlags flags = vk::FenceCreateFlagBits::eSignaled);
-    std::vector<vk::Fence> fences_;
     std::vector<vk::Fence> frameFences_;
 
     // This should be a unique list of active passes in order of first use.
@@ -11,6 +11,8 @@
 
 #include <Common/Helpers.h>
 
+#include "SamplerBake.h"
+#include "SamplerCombine.h"
 #include "Shell.h"
 
 namespace {
@@ -99,8 +101,12 @@ Sampler::Base::Base(const CreateInfo* pCreateInfo, bool needsData)
       aspect(BAD_ASPECT),
       imageViewType(pCreateInfo->imageViewType),
       image(),
-      memory(),
-      imgInfo{}  //
+      allocation(),
+      mipBias(0),
+      residentMip(0),
+      budgetSize(0),
+      imgInfo{},
+      bindlessIndex(UINT32_MAX)  //
 {
     // Image create info
     imgCreateInfo.flags = pCreateInfo->imageFlags;
@@ -227,13 +233,70 @@ void Sampler::Base::copyData(void*& pData, size_t& offset) const {
     }
 }
 
+void Sampler::Base::makeMipChain() {
+    assert(BYTES_PER_CHANNEL == 1 && pPixels.size() == imgCreateInfo.arrayLayers);
+    const size_t texelSize = static_cast<size_t>(BYTES_PER_CHANNEL) * static_cast<size_t>(NUM_CHANNELS);
+    const size_t layerCount = imgCreateInfo.arrayLayers;
+    // sRGB color channels are averaged in linear space, like a linear blit would. Alpha is always linear.
+    const size_t srgbChannels =
+        Combine::IsSrgb(imgCreateInfo.format) ? std::min(texelSize, static_cast<size_t>(3)) : 0;
+
+    // Level 0 is the decoded image.
+    mipData.resize(imgCreateInfo.mipLevels);
+    mipData[0].bytes.resize(size());
+    void* pData = mipData[0].bytes.data();
+    size_t offset = 0;
+    copyData(pData, offset);
+    pPixels.clear();
+
+    for (uint32_t level = 1; level < imgCreateInfo.mipLevels; level++) {
+        const auto srcExtent = mipExtent(level - 1), dstExtent = mipExtent(level);
+        const size_t srcLayerSize = srcExtent.width * srcExtent.height * texelSize;
+        const size_t dstLayerSize = dstExtent.width * dstExtent.height * texelSize;
+        const auto& src = mipData[level - 1].bytes;
+        auto& dst = mipData[level].bytes;
+        dst.resize(dstLayerSize * layerCount);
+
+        for (size_t layer = 0; layer < layerCount; layer++) {
+            const auto* pSrc = src.data() + (layer * srcLayerSize);
+            auto* pDst = dst.data() + (layer * dstLayerSize);
+            for (uint32_t y = 0; y < dstExtent.height; y++) {
+                // Odd dimensions clamp to the last row/column.
+                const size_t y0 = std::min(y * 2, srcExtent.height - 1);
+                const size_t y1 = std::min(y * 2 + 1, srcExtent.height - 1);
+                for (uint32_t x = 0; x < dstExtent.width; x++) {
+                    const size_t x0 = std::min(x * 2, srcExtent.width - 1);
+                    const size_t x1 = std::min(x * 2 + 1, srcExtent.width - 1);
+                    for (size_t c = 0; c < srgbChannels; c++) {
+                        uint32_t sum = Combine::ToLinear(pSrc[(y0 * srcExtent.width + x0) * texelSize + c]) +
+                                       Combine::ToLinear(pSrc[(y0 * srcExtent.width + x1) * texelSize + c]) +
+                                       Combine::ToLinear(pSrc[(y1 * srcExtent.width + x0) * texelSize + c]) +
+                                       Combine::ToLinear(pSrc[(y1 * srcExtent.width + x1) * texelSize + c]);
+                        pDst[(y * dstExtent.width + x) * texelSize + c] =
+                            Combine::ToSrgb(static_cast<uint16_t>((sum + 2) / 4));
+                    }
+                    for (size_t c = srgbChannels; c < texelSize; c++) {
+                        uint32_t sum = pSrc[(y0 * srcExtent.width + x0) * texelSize + c] +
+                                       pSrc[(y0 * srcExtent.width + x1) * texelSize + c] +
+                                       pSrc[(y1 * srcExtent.width + x0) * texelSize + c] +
+                                       pSrc[(y1 * srcExtent.width + x1) * texelSize + c];
+                        pDst[(y * dstExtent.width + x) * texelSize + c] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+    }
+}
+
 void Sampler::Base::destroy(const Context& ctx) {
     for (auto& [layer, layerResource] : layerResourceMap) {
         if (layerResource.sampler) ctx.dev.destroySampler(layerResource.sampler, ctx.pAllocator);
         ctx.dev.destroyImageView(layerResource.view, ctx.pAllocator);
     }
     ctx.dev.destroyImage(image, ctx.pAllocator);
-    ctx.dev.freeMemory(memory, ctx.pAllocator);
+    ctx.pMemAllocator->free(allocation);
+    mipData.clear();
+    mipBias = residentMip = 0;
 }
 
 // FUNCTIONS
@@ -255,9 +318,13 @@ Sampler::Base Sampler::make(const Shell& shell, const CreateInfo* pCreateInfo, c
             sampler.aspect = static_cast<float>(sampler.imgCreateInfo.extent.width) /
                              static_cast<float>(sampler.imgCreateInfo.extent.height);
         }
+    } else if (Bake::CanBake(pCreateInfo) && Bake::Load(shell, pCreateInfo, sampler)) {
+        // Texture was baked already. Its layers are combined, and its mips are filtered.
+        sampler.aspect = static_cast<float>(sampler.imgCreateInfo.extent.width) /
+                         static_cast<float>(sampler.imgCreateInfo.extent.height);
     } else {
         // Texture has data to load so load it and validate.
-        bool isFirstLayer = true;
+        bool isFirstLayer = true, isFromFile = true;
         int w, h, d, c, req_comp = getReqComp(pCreateInfo->numberOfChannels);
 
         for (auto& layerInfo : pCreateInfo->layersInfo.infos) {
@@ -272,6 +339,7 @@ Sampler::Base Sampler::make(const Shell& shell, const CreateInfo* pCreateInfo, c
 
                 d = 1;  // Depth is always 1 if loading from file ???
             } else {
+                isFromFile = false;
                 w = pCreateInfo->extent.width;
                 h = pCreateInfo->extent.height;
                 d = pCreateInfo->extent.depth;
@@ -322,20 +390,30 @@ Sampler::Base Sampler::make(const Shell& shell, const CreateInfo* pCreateInfo, c
                 validateChannels(shell, sampler, layerInfo.path, c);
                 validateDimensions(shell, sampler, layerInfo.path, w, h);
 
-                // Mix combined data in.
-                vk::DeviceSize size = static_cast<vk::DeviceSize>(sampler.imgCreateInfo.extent.width) *
-                                      static_cast<vk::DeviceSize>(sampler.imgCreateInfo.extent.height);
-                for (vk::DeviceSize i = 0; i < size; i++) {
-                    // combineInfo { path, number of channels, combine offset }
-                    auto offset = (i * sampler.NUM_CHANNELS) + std::get<2>(combineInfo);
-                    auto combineOffset = i * std::get<1>(combineInfo);
-                    std::memcpy(((stbi_uc*)sampler.pPixels.back()) + offset, pCombinePixels + combineOffset,
-                                std::get<1>(combineInfo));
-                }
+                // Mix combined data in. combineInfo { path, number of channels, combine offset }
+                Combine::Channels(static_cast<uint8_t*>(sampler.pPixels.back()), sampler.NUM_CHANNELS,
+                                  std::get<2>(combineInfo), pCombinePixels, std::get<1>(combineInfo),
+                                  {sampler.imgCreateInfo.extent.width, sampler.imgCreateInfo.extent.height});
+                stbi_image_free(pCombinePixels);
+            }
+
+            if (pCreateInfo->premultiplyAlpha) {
+                assert(isFromFile && sampler.NUM_CHANNELS == 4 && sampler.BYTES_PER_CHANNEL == 1);
+                Combine::PremultiplyAlpha(static_cast<uint8_t*>(sampler.pPixels.back()),
+                                          Combine::IsSrgb(sampler.imgCreateInfo.format),
+                                          {sampler.imgCreateInfo.extent.width, sampler.imgCreateInfo.extent.height});
             }
         }
 
         assert(sampler.imgCreateInfo.arrayLayers == sampler.pPixels.size());
+
+        // Build the mip chain here, on the loading thread, so the texture handler can upload it a level at a time.
+        if (isFromFile && sampler.mipmapInfo.stream && sampler.mipmapInfo.generateMipmaps &&
+            sampler.imgCreateInfo.mipLevels > 1 && sampler.imgCreateInfo.extent.depth == 1 &&
+            sampler.BYTES_PER_CHANNEL == 1) {
+            sampler.makeMipChain();
+            if (Bake::CanBake(pCreateInfo)) Bake::Save(shell, pCreateInfo, sampler);
+        }
     }
 
     sampler.determineImageTypes();
@@ -6,11 +6,14 @@
 #ifndef SAMPLER_H
 #define SAMPLER_H
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include <Common/Context.h>
+#include <Common/Helpers.h>
 
 #include "ConstantsAll.h"
 
@@ -18,6 +21,23 @@ class Shell;
 
 namespace Sampler {
 
+// One level of a streamed mip chain. The texels are either owned, or point into a mapped bake container.
+struct MipLevel {
+    inline const uint8_t *data() const { return pFile ? pMapped : bytes.data(); }
+    inline size_t size() const { return pFile ? mappedSize : bytes.size(); }
+    inline void release() {
+        std::vector<uint8_t>().swap(bytes);
+        pFile.reset();
+        pMapped = nullptr;
+        mappedSize = 0;
+    }
+
+    std::vector<uint8_t> bytes;
+    std::shared_ptr<const helpers::MappedFile> pFile;
+    const uint8_t *pMapped = nullptr;
+    size_t mappedSize = 0;
+};
+
 class Base {
    public:  // TODO: use access modifiers
     Base(const CreateInfo *pCreateInfo, bool hasData);
@@ -35,6 +55,17 @@ class Base {
     void copyData(void *&pData, size_t &offset) const;
     inline void cleanup() { pPixels.clear(); }
 
+    // STREAMING
+    void makeMipChain();
+    // Image relative.
+    inline vk::Extent3D mipExtent(const uint32_t level) const {
+        return {std::max(imgCreateInfo.extent.width >> level, 1u),   //
+                std::max(imgCreateInfo.extent.height >> level, 1u),  //
+                1};
+    }
+    inline const MipLevel &mipLevelData(const uint32_t level) const { return mipData[level + mipBias]; }
+    inline bool isResident() const { return residentMip == 0; }
+
     void destroy(const Context &ctx);
 
     // TODO: Get rid of all these creation info members
@@ -54,12 +85,22 @@ class Base {
     vk::ImageViewType imageViewType;
 
     vk::Image image;
-    vk::DeviceMemory memory;
+    Memory::Allocation allocation;
 
     std::vector<void *> pPixels;
 
+    // Box filtered source mip chain (every layer per level) that is kept around until a streamed image is fully
+    // resident. "mipBias" is the number of source levels that were dropped to stay within the texture budget, and
+    // "residentMip" is the finest image level with real data. Levels finer than that are upsampled from it.
+    // "budgetSize" is what the chain was charged against the texture budget, and is given back when it is destroyed.
+    std::vector<MipLevel> mipData;
+    uint32_t mipBias;
+    uint32_t residentMip;
+    vk::DeviceSize budgetSize;
+
     layerResourceMap layerResourceMap;
     ImageInfo imgInfo;
+    uint32_t bindlessIndex;  // Slot in the bindless sampler array, or UINT32_MAX.
 };
 
 // FUNCTIONS
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "SamplerBake.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <Common/Helpers.h>
+
+#include "Sampler.h"
+#include "SamplerCompression.h"
+#include "Shell.h"
+
+namespace {
+
+// The sampler settings, and every source path. "stamp" adds the size/modified time of the sources.
+uint64_t hashSampler(const Sampler::CreateInfo *pCreateInfo, const bool stamp) {
+    const auto what = stamp ? helpers::FILE_HASH::STAMP : helpers::FILE_HASH::PATH;
+    uint64_t h = helpers::FNV_OFFSET_BASIS;
+    const uint32_t settings[] = {
+        Sampler::Bake::VERSION,
+        static_cast<uint32_t>(pCreateInfo->format),
+        static_cast<uint32_t>(pCreateInfo->numberOfChannels),
+        static_cast<uint32_t>(pCreateInfo->bytesPerChannel),
+        static_cast<uint32_t>(pCreateInfo->mipmapCreateInfo.info.usesExtent),
+        pCreateInfo->mipmapCreateInfo.mipLevels,
+        static_cast<uint32_t>(pCreateInfo->compress),
+        static_cast<uint32_t>(pCreateInfo->premultiplyAlpha),
+    };
+    helpers::hash(h, settings, sizeof(settings));
+    for (const auto &layerInfo : pCreateInfo->layersInfo.infos) {
+        helpers::hashFile(h, layerInfo.path, what);
+        for (const auto &combineInfo : layerInfo.combineInfos) {
+            helpers::hashFile(h, std::get<0>(combineInfo), what);
+            const uint32_t combine[] = {static_cast<uint32_t>(std::get<1>(combineInfo)), std::get<2>(combineInfo)};
+            helpers::hash(h, combine, sizeof(combine));
+        }
+    }
+    return h;
+}
+
+}  // namespace
+
+namespace Sampler {
+namespace Bake {
+
+bool CanBake(const CreateInfo *pCreateInfo) {
+    if (pCreateInfo->bytesPerChannel != 1 || !pCreateInfo->mipmapCreateInfo.info.stream ||
+        !pCreateInfo->mipmapCreateInfo.info.generateMipmaps || pCreateInfo->layersInfo.infos.empty())
+        return false;
+    for (const auto &layerInfo : pCreateInfo->layersInfo.infos)
+        if (layerInfo.pPixel != nullptr || layerInfo.path.empty()) return false;
+    return true;
+}
+
+std::string GetPath(const CreateInfo *pCreateInfo) {
+    std::stringstream ss;
+    ss << helpers::normalizePath(pCreateInfo->layersInfo.infos.front().path) << '.' << std::hex
+       << hashSampler(pCreateInfo, false) << EXTENSION;
+    return ss.str();
+}
+
+uint64_t GetSourceStamp(const CreateInfo *pCreateInfo) { return hashSampler(pCreateInfo, true); }
+
+bool Load(const Shell &shell, const CreateInfo *pCreateInfo, Base &sampler) {
+    auto pFile = std::make_shared<const helpers::MappedFile>(GetPath(pCreateInfo));
+    if (pFile->data() == nullptr || pFile->size() < sizeof(Header)) return false;
+
+    Header header = {};
+    std::memcpy(&header, pFile->data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.sourceStamp != GetSourceStamp(pCreateInfo))
+        return false;
+    if (header.layerCount != sampler.imgCreateInfo.arrayLayers || header.bytesPerChannel != sampler.BYTES_PER_CHANNEL ||
+        header.numberOfChannels != sampler.NUM_CHANNELS || header.levelCount == 0 || header.width == 0 ||
+        header.height == 0 || pFile->size() < sizeof(Header) + sizeof(Level) * header.levelCount)
+        return false;
+
+    /* Block-compressed containers are used as is if the device supports the format. Otherwise they are decoded back to
+     *  the sampler's format on the CPU.
+     */
+    const auto format = static_cast<vk::Format>(header.format);
+    bool decode = false;
+    if (Compression::IsBlockCompressed(format)) {
+        decode = !Compression::IsSupported(shell.context(), format);
+    } else if (format != sampler.imgCreateInfo.format || !Compression::IsSupported(shell.context(), format)) {
+        return false;
+    }
+
+    std::vector<Level> levels(header.levelCount);
+    std::memcpy(levels.data(), pFile->data() + sizeof(Header), sizeof(Level) * levels.size());
+    // Nothing is read outside of the mapping, even if the container is truncated.
+    const uint32_t texelSize = header.bytesPerChannel * header.numberOfChannels;
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        const vk::Extent3D extent = {std::max(header.width >> i, 1u), std::max(header.height >> i, 1u), 1};
+        if (levels[i].offset > pFile->size() || levels[i].size > pFile->size() - levels[i].offset ||
+            levels[i].size != Compression::GetLevelSize(format, extent, header.layerCount, texelSize))
+            return false;
+    }
+
+    sampler.imgCreateInfo.extent = {header.width, header.height, 1};
+    sampler.imgCreateInfo.mipLevels = header.levelCount;
+
+    // The levels point straight into the mapping, so the copy into the staging buffer is the only one they take.
+    std::vector<MipLevel> mipData(levels.size());
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        const auto *pLevel = pFile->data() + levels[i].offset;
+        if (decode) {
+            Compression::Decode(format, pLevel, sampler.mipExtent(i), header.layerCount, header.numberOfChannels,
+                                mipData[i].bytes);
+        } else {
+            mipData[i].pFile = pFile;
+            mipData[i].pMapped = pLevel;
+            mipData[i].mappedSize = static_cast<size_t>(levels[i].size);
+        }
+    }
+
+    if (!decode) sampler.imgCreateInfo.format = format;
+    sampler.mipData = std::move(mipData);
+    return true;
+}
+
+namespace {
+
+// Everything "Save" writes.
+bool writeBake(std::ofstream &file, const CreateInfo *pCreateInfo, const Base &sampler) {
+    // Compress if the sampler allows it, and there is a block format for its channels.
+    auto format = sampler.imgCreateInfo.format;
+    std::vector<MipLevel> blocks;
+    if (pCreateInfo->compress) {
+        const auto &finest = sampler.mipData.front();
+        auto compressedFormat = Compression::Choose(format, sampler.NUM_CHANNELS, finest.data(), finest.size());
+        if (compressedFormat != format) {
+            format = compressedFormat;
+            blocks.resize(sampler.mipData.size());
+            for (uint32_t i = 0; i < blocks.size(); i++) {
+                Compression::Encode(format, sampler.mipData[i].data(), sampler.mipExtent(i),
+                                    sampler.imgCreateInfo.arrayLayers, sampler.NUM_CHANNELS, blocks[i].bytes);
+            }
+        }
+    }
+    const auto &levelData = blocks.empty() ? sampler.mipData : blocks;
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sourceStamp = 0;  // Written last, so a partially written file never matches.
+    header.format = static_cast<uint32_t>(format);
+    header.width = sampler.imgCreateInfo.extent.width;
+    header.height = sampler.imgCreateInfo.extent.height;
+    header.layerCount = sampler.imgCreateInfo.arrayLayers;
+    header.levelCount = static_cast<uint32_t>(sampler.mipData.size());
+    header.bytesPerChannel = sampler.BYTES_PER_CHANNEL;
+    header.numberOfChannels = sampler.NUM_CHANNELS;
+
+    std::vector<Level> levels(levelData.size());
+    uint64_t offset = sizeof(Header) + sizeof(Level) * levels.size();
+    for (size_t i = 0; i < levels.size(); i++) {
+        offset = ((offset + 15) / 16) * 16;
+        levels[i] = {offset, levelData[i].size()};
+        offset += levels[i].size;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(levels.data()), sizeof(Level) * levels.size());
+    for (size_t i = 0; i < levels.size(); i++) {
+        file.seekp(static_cast<std::streamoff>(levels[i].offset));
+        file.write(reinterpret_cast<const char *>(levelData[i].data()), levelData[i].size());
+    }
+
+    header.sourceStamp = GetSourceStamp(pCreateInfo);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    return true;
+}
+
+}  // namespace
+
+bool Save(const Shell &shell, const CreateInfo *pCreateInfo, const Base &sampler) {
+    assert(!sampler.mipData.empty() && sampler.mipBias == 0);
+    const auto path = GetPath(pCreateInfo);
+    bool saved =
+        helpers::writeFileAtomic(path, [&](std::ofstream &file) { return writeBake(file, pCreateInfo, sampler); });
+    if (!saved) {
+        std::string msg = "\nCould not write baked sampler \"" + path + "\".\n";
+        shell.log(Shell::LogPriority::LOG_WARN, msg.c_str());
+    }
+    return saved;
+}
+
+}  // namespace Bake
+}  // namespace Sampler
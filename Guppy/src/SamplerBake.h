@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef SAMPLER_BAKE_H
+#define SAMPLER_BAKE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "SamplerConstants.h"
+
+class Shell;
+
+namespace Sampler {
+
+class Base;
+
+/* Baked samplers are cached next to the first layer's source file in a small container with the final texel data for
+ *  every mip level. The file name has a hash of the sampler settings and source paths, so samplers that share a first
+ *  layer get their own container. The layers are already combined, and the chain is already filtered, so loading one
+ *  maps the file, and "Sampler::Base::mipData" points into the mapping. The streaming upload path copies each level
+ *  from there into its staging buffer, which is the only copy the texels take. Containers are replaced by renaming
+ *  over them, so a mapping is never written to. A sampler is baked the first time it is decoded from source, and
+ *  running with "-bake" loads every texture and exits, which bakes everything ahead of time. The container is thrown
+ *  out, and rebaked, if any of the sources change.
+ *
+ *  Layout (little-endian, like every device this runs on):
+ *      Header
+ *      Level[levelCount]   { offset, size } of every level, finest first. A level holds every layer back to back.
+ *      texel data          16 byte aligned per level.
+ */
+namespace Bake {
+
+constexpr std::string_view EXTENSION = ".gtex";
+constexpr char MAGIC[4] = {'G', 'T', 'E', 'X'};
+constexpr uint32_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceStamp;
+    uint32_t format;  // vk::Format
+    uint32_t width;
+    uint32_t height;
+    uint32_t layerCount;
+    uint32_t levelCount;
+    uint32_t bytesPerChannel;
+    uint32_t numberOfChannels;
+    uint32_t padding;
+};
+
+struct Level {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Only 8-bit samplers loaded from file that stream their mips are baked.
+bool CanBake(const CreateInfo *pCreateInfo);
+// "<first layer path>.<settings hash>.gtex"
+std::string GetPath(const CreateInfo *pCreateInfo);
+// Hash of the sampler settings, and the path/size/modified time of every source file.
+uint64_t GetSourceStamp(const CreateInfo *pCreateInfo);
+
+// Returns false if there is no usable container for the sampler. The caller should decode from source instead.
+bool Load(const Shell &shell, const CreateInfo *pCreateInfo, Base &sampler);
+bool Save(const Shell &shell, const CreateInfo *pCreateInfo, const Base &sampler);
+
+}  // namespace Bake
+}  // namespace Sampler
+
+#endif  // !SAMPLER_BAKE_H
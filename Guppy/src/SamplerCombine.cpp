@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "SamplerCombine.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <Common/Helpers.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAMPLER_COMBINE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t LINEAR_MAX = 4095;
+
+// 8-bit sRGB to 12-bit linear, and back.
+struct SrgbTables {
+    SrgbTables() {
+        for (uint32_t i = 0; i < toLinear.size(); i++) {
+            const auto c = static_cast<float>(i) / 255.0f;
+            const auto l = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            toLinear[i] = static_cast<uint16_t>(std::lround(l * LINEAR_MAX));
+        }
+        for (uint32_t i = 0; i < toSrgb.size(); i++) {
+            const auto l = static_cast<float>(i) / LINEAR_MAX;
+            const auto c = l <= 0.0031308f ? l * 12.92f : (1.055f * std::pow(l, 1.0f / 2.4f)) - 0.055f;
+            toSrgb[i] = static_cast<uint8_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+        }
+    }
+    std::array<uint16_t, 256> toLinear;
+    std::array<uint8_t, LINEAR_MAX + 1> toSrgb;
+};
+
+const SrgbTables &srgbTables() {
+    static const SrgbTables tables;
+    return tables;
+}
+
+// Rounded x / 255 for x <= 255 * 255.
+inline uint32_t div255(const uint32_t x) { return (x + 128 + ((x + 128) >> 8)) >> 8; }
+
+// Calls "func(rowBegin, rowEnd)" for every tile.
+template <typename TFunc>
+void forEachTile(const vk::Extent2D &extent, TFunc &&func) {
+    const auto tileCount = (extent.height + Sampler::Combine::TILE_ROWS - 1) / Sampler::Combine::TILE_ROWS;
+    const auto texelCount = static_cast<size_t>(extent.width) * extent.height;
+    if (tileCount < 2 || texelCount < Sampler::Combine::PARALLEL_MIN_TEXELS) {
+        func(0u, extent.height);
+        return;
+    }
+
+    helpers::parallelFor(tileCount, [&](const size_t tile) {
+        const auto rowBegin = static_cast<uint32_t>(tile) * Sampler::Combine::TILE_ROWS;
+        func(rowBegin, std::min(extent.height, rowBegin + Sampler::Combine::TILE_ROWS));
+    });
+}
+
+template <uint32_t DST, uint32_t SRC>
+void channels(uint8_t *pDst, const uint32_t dstOffset, const uint8_t *pSrc, const size_t texelCount) {
+    pDst += dstOffset;
+    for (size_t i = 0; i < texelCount; i++) {
+        for (uint32_t c = 0; c < SRC; c++) pDst[i * DST + c] = pSrc[i * SRC + c];
+    }
+}
+
+// Returns the number of texels done. The rest is left for the generic loop.
+size_t channelsFast(uint8_t *pDst, const uint32_t dstChannels, const uint32_t dstOffset, const uint8_t *pSrc,
+                    const uint32_t srcChannels, const size_t texelCount) {
+#ifdef SAMPLER_COMBINE_SSE2
+    if (dstChannels != 4 || srcChannels > 2) return 0;
+
+    // Widen the source channels to one 32-bit lane per texel, shift them into place, and blend.
+    const auto shift = _mm_cvtsi32_si128(static_cast<int>(dstOffset * 8));
+    const auto srcMask = srcChannels == 1 ? 0xFFu : 0xFFFFu;
+    const auto keep = _mm_set1_epi32(static_cast<int>(~(srcMask << (dstOffset * 8))));
+    const auto zero = _mm_setzero_si128();
+    auto blend = [&](uint8_t *p, __m128i lanes) {
+        const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        lanes = _mm_sll_epi32(lanes, shift);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_or_si128(_mm_and_si128(d, keep), lanes));
+    };
+
+    size_t i = 0;
+    if (srcChannels == 1) {
+        for (; i + 16 <= texelCount; i += 16) {
+            const auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc + i));
+            const auto lo = _mm_unpacklo_epi8(s, zero), hi = _mm_unpackhi_epi8(s, zero);
+            blend(pDst + (i * 4) + 0, _mm_unpacklo_epi16(lo, zero));
+            blend(pDst + (i * 4) + 16, _mm_unpackhi_epi16(lo, zero));
+            blend(pDst + (i * 4) + 32, _mm_unpacklo_epi16(hi, zero));
+            blend(pDst + (i * 4) + 48, _mm_unpackhi_epi16(hi, zero));
+        }
+    } else {
+        for (; i + 8 <= texelCount; i += 8) {
+            const auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc + (i * 2)));
+            blend(pDst + (i * 4) + 0, _mm_unpacklo_epi16(s, zero));
+            blend(pDst + (i * 4) + 16, _mm_unpackhi_epi16(s, zero));
+        }
+    }
+    return i;
+#else
+    return 0;
+#endif
+}
+
+void channelsRows(uint8_t *pDst, const uint32_t dstChannels, const uint32_t dstOffset, const uint8_t *pSrc,
+                  const uint32_t srcChannels, const size_t texelCount) {
+    const auto done = channelsFast(pDst, dstChannels, dstOffset, pSrc, srcChannels, texelCount);
+    pDst += done * dstChannels;
+    pSrc += done * srcChannels;
+    const auto count = texelCount - done;
+    if (dstChannels == 4) {
+        switch (srcChannels) {
+            case 1: return channels<4, 1>(pDst, dstOffset, pSrc, count);
+            case 2: return channels<4, 2>(pDst, dstOffset, pSrc, count);
+            case 3: return channels<4, 3>(pDst, dstOffset, pSrc, count);
+            default: break;
+        }
+    }
+    Sampler::Combine::ChannelsScalar(pDst, dstChannels, dstOffset, pSrc, srcChannels, count);
+}
+
+void premultiplyRows(uint8_t *pData, const bool isSrgb, const size_t texelCount) {
+    size_t i = 0;
+#ifdef SAMPLER_COMBINE_SSE2
+    if (!isSrgb) {
+        // Two texels per 16-bit half. Alpha multiplies itself by 255, so it comes out unchanged.
+        const auto zero = _mm_setzero_si128();
+        const auto colorMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+        const auto alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+        const auto round = _mm_set1_epi16(128);
+        auto multiply = [&](__m128i v) {
+            auto a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            a = _mm_or_si128(_mm_and_si128(a, colorMask), alphaOne);
+            auto x = _mm_add_epi16(_mm_mullo_epi16(v, a), round);
+            return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        };
+        for (; i + 4 <= texelCount; i += 4) {
+            auto *p = reinterpret_cast<__m128i *>(pData + (i * 4));
+            const auto v = _mm_loadu_si128(p);
+            const auto lo = multiply(_mm_unpacklo_epi8(v, zero)), hi = multiply(_mm_unpackhi_epi8(v, zero));
+            _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    Sampler::Combine::PremultiplyAlphaScalar(pData + (i * 4), isSrgb, texelCount - i);
+}
+
+}  // namespace
+
+namespace Sampler {
+namespace Combine {
+
+bool IsSrgb(const vk::Format format) {
+    switch (format) {
+        case vk::Format::eR8Srgb:
+        case vk::Format::eR8G8Srgb:
+        case vk::Format::eR8G8B8Srgb:
+        case vk::Format::eB8G8R8Srgb:
+        case vk::Format::eR8G8B8A8Srgb:
+        case vk::Format::eB8G8R8A8Srgb:
+        case vk::Format::eA8B8G8R8SrgbPack32:
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint16_t ToLinear(const uint8_t c) { return srgbTables().toLinear[c]; }
+
+uint8_t ToSrgb(const uint16_t l) {
+    assert(l <= LINEAR_MAX);
+    return srgbTables().toSrgb[l];
+}
+
+void Channels(uint8_t *pDst, const uint32_t dstChannels, const uint32_t dstOffset, const uint8_t *pSrc,
+              const uint32_t srcChannels, const vk::Extent2D &extent) {
+    assert(dstOffset + srcChannels <= dstChannels);
+    const size_t rowTexels = extent.width;
+
+#ifndef NDEBUG
+    // Run the first tile through the scalar path to check the fast path against.
+    const auto checkTexels = rowTexels * std::min(extent.height, TILE_ROWS);
+    std::vector<uint8_t> expected(pDst, pDst + (checkTexels * dstChannels));
+    ChannelsScalar(expected.data(), dstChannels, dstOffset, pSrc, srcChannels, checkTexels);
+#endif
+
+    forEachTile(extent, [&](const uint32_t rowBegin, const uint32_t rowEnd) {
+        const auto first = rowBegin * rowTexels;
+        channelsRows(pDst + (first * dstChannels), dstChannels, dstOffset, pSrc + (first * srcChannels), srcChannels,
+                     (rowEnd - rowBegin) * rowTexels);
+    });
+
+    assert(std::memcmp(expected.data(), pDst, expected.size()) == 0 && "Fast channel combine differs from scalar");
+}
+
+void ChannelsScalar(uint8_t *pDst, const uint32_t dstChannels, const uint32_t dstOffset, const uint8_t *pSrc,
+                    const uint32_t srcChannels, const size_t texelCount) {
+    for (size_t i = 0; i < texelCount; i++)
+        std::memcpy(pDst + (i * dstChannels) + dstOffset, pSrc + (i * srcChannels), srcChannels);
+}
+
+void PremultiplyAlpha(uint8_t *pData, const bool isSrgb, const vk::Extent2D &extent) {
+    const size_t rowTexels = extent.width;
+    if (isSrgb) srgbTables();  // Build the tables before the workers need them.
+
+#ifndef NDEBUG
+    const auto checkTexels = rowTexels * std::min(extent.height, TILE_ROWS);
+    std::vector<uint8_t> expected(pData, pData + (checkTexels * 4));
+    PremultiplyAlphaScalar(expected.data(), isSrgb, checkTexels);
+#endif
+
+    forEachTile(extent, [&](const uint32_t rowBegin, const uint32_t rowEnd) {
+        premultiplyRows(pData + (rowBegin * rowTexels * 4), isSrgb, (rowEnd - rowBegin) * rowTexels);
+    });
+
+    assert(std::memcmp(expected.data(), pData, expected.size()) == 0 && "Fast premultiply differs from scalar");
+}
+
+void PremultiplyAlphaScalar(uint8_t *pData, const bool isSrgb, const size_t texelCount) {
+    if (isSrgb) {
+        const auto &tables = srgbTables();
+        for (size_t i = 0; i < texelCount; i++) {
+            auto *p = pData + (i * 4);
+            for (uint32_t c = 0; c < 3; c++) p[c] = tables.toSrgb[(tables.toLinear[p[c]] * p[3] + 127) / 255];
+        }
+    } else {
+        for (size_t i = 0; i < texelCount; i++) {
+            auto *p = pData + (i * 4);
+            for (uint32_t c = 0; c < 3; c++) p[c] = static_cast<uint8_t>(div255(p[c] * p[3]));
+        }
+    }
+}
+
+}  // namespace Combine
+}  // namespace Sampler
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef SAMPLER_COMBINE_H
+#define SAMPLER_COMBINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+
+/* Per-texel transforms for decoded 8-bit sampler data. The work is split into row tiles that run in parallel, and the
+ *  inner loops are vectorized (SSE2 where available, otherwise loops the compiler can vectorize). sRGB data goes through
+ *  lookup tables instead. Each transform has a scalar version that the fast path is checked against in debug builds.
+ */
+namespace Sampler {
+namespace Combine {
+
+// Rows per tile handed to a worker.
+constexpr uint32_t TILE_ROWS = 64;
+// Images with fewer texels than this are done on the calling thread.
+constexpr size_t PARALLEL_MIN_TEXELS = 256 * 256;
+
+bool IsSrgb(const vk::Format format);
+// 8-bit sRGB to 12-bit linear, and back. The same tables as the sRGB transforms.
+uint16_t ToLinear(const uint8_t c);
+uint8_t ToSrgb(const uint16_t l);
+
+// Copy every texel of "pSrc" ("srcChannels" channels) into "pDst" ("dstChannels" channels) starting at channel
+//  "dstOffset". The other channels of "pDst" are left alone.
+void Channels(uint8_t *pDst, const uint32_t dstChannels, const uint32_t dstOffset, const uint8_t *pSrc,
+              const uint32_t srcChannels, const vk::Extent2D &extent);
+void ChannelsScalar(uint8_t *pDst, const uint32_t dstChannels, const uint32_t dstOffset, const uint8_t *pSrc,
+                    const uint32_t srcChannels, const size_t texelCount);
+
+// Multiply the color channels of 4 channel texels by alpha. sRGB data is multiplied in linear space.
+void PremultiplyAlpha(uint8_t *pData, const bool isSrgb, const vk::Extent2D &extent);
+void PremultiplyAlphaScalar(uint8_t *pData, const bool isSrgb, const size_t texelCount);
+
+}  // namespace Combine
+}  // namespace Sampler
+
+#endif  // !SAMPLER_COMBINE_H
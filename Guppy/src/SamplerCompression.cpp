@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "SamplerCompression.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+using BlockTexels = uint8_t[16][4];
+
+inline uint32_t blockCount(const uint32_t dimension) {
+    return (dimension + Sampler::Compression::BLOCK_DIMENSION - 1) / Sampler::Compression::BLOCK_DIMENSION;
+}
+
+// Edge blocks repeat the last row/column. Missing channels are 0, except alpha which is opaque.
+void fetchBlock(const uint8_t *pLayer, const vk::Extent3D &extent, const uint32_t channelCount, const uint32_t bx,
+                const uint32_t by, BlockTexels &texels) {
+    for (uint32_t y = 0; y < 4; y++) {
+        const auto sy = std::min(by * 4 + y, extent.height - 1);
+        for (uint32_t x = 0; x < 4; x++) {
+            const auto sx = std::min(bx * 4 + x, extent.width - 1);
+            const auto *p = pLayer + ((static_cast<size_t>(sy) * extent.width) + sx) * channelCount;
+            for (uint32_t c = 0; c < 4; c++) texels[y * 4 + x][c] = c < channelCount ? p[c] : (c == 3 ? 255 : 0);
+        }
+    }
+}
+
+void storeBlock(const BlockTexels &texels, const vk::Extent3D &extent, const uint32_t channelCount, const uint32_t bx,
+                const uint32_t by, uint8_t *pLayer) {
+    for (uint32_t y = 0; y < 4 && by * 4 + y < extent.height; y++) {
+        for (uint32_t x = 0; x < 4 && bx * 4 + x < extent.width; x++) {
+            auto *p = pLayer + ((static_cast<size_t>(by * 4 + y) * extent.width) + (bx * 4 + x)) * channelCount;
+            for (uint32_t c = 0; c < channelCount; c++) p[c] = texels[y * 4 + x][c];
+        }
+    }
+}
+
+inline uint16_t to565(const uint8_t *c) {
+    return static_cast<uint16_t>(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+inline void from565(const uint16_t v, uint8_t *c) {
+    const uint8_t r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    c[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+    c[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+    c[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+    c[3] = 255;
+}
+
+// BC1 switches to three colors (and black/transparent) when c0 <= c1. The color block in BC2/3 never does.
+void colorPalette(const uint16_t c0, const uint16_t c1, const bool isBc1, uint8_t (&palette)[4][4]) {
+    from565(c0, palette[0]);
+    from565(c1, palette[1]);
+    if (c0 > c1 || !isBc1) {
+        for (uint32_t c = 0; c < 3; c++) {
+            palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+        }
+        palette[2][3] = palette[3][3] = 255;
+    } else {
+        for (uint32_t c = 0; c < 3; c++) {
+            palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+}
+
+void alphaPalette(const uint8_t a0, const uint8_t a1, uint8_t (&palette)[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (uint32_t i = 1; i < 7; i++) palette[1 + i] = static_cast<uint8_t>(((7 - i) * a0 + i * a1) / 7);
+    } else {
+        for (uint32_t i = 1; i < 5; i++) palette[1 + i] = static_cast<uint8_t>(((5 - i) * a0 + i * a1) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+// BC1 style color block (8 bytes). Always uses the four color mode.
+void encodeColor(const BlockTexels &texels, uint8_t *pDst) {
+    uint8_t lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0};
+    for (const auto &texel : texels) {
+        for (uint32_t c = 0; c < 3; c++) {
+            lo[c] = std::min(lo[c], texel[c]);
+            hi[c] = std::max(hi[c], texel[c]);
+        }
+    }
+    // Inset the box a little so the end points aren't wasted on outliers.
+    for (uint32_t c = 0; c < 3; c++) {
+        const uint8_t inset = static_cast<uint8_t>((hi[c] - lo[c]) >> 4);
+        lo[c] += inset;
+        hi[c] -= inset;
+    }
+
+    auto c0 = to565(hi), c1 = to565(lo);
+    if (c0 < c1) std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        uint8_t palette[4][4];
+        colorPalette(c0, c1, false, palette);
+        for (uint32_t i = 0; i < 16; i++) {
+            uint32_t best = 0, bestDistance = UINT32_MAX;
+            for (uint32_t p = 0; p < 4; p++) {
+                uint32_t distance = 0;
+                for (uint32_t c = 0; c < 3; c++) {
+                    const int32_t d = static_cast<int32_t>(texels[i][c]) - static_cast<int32_t>(palette[p][c]);
+                    distance += static_cast<uint32_t>(d * d);
+                }
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= best << (2 * i);
+        }
+    }
+
+    pDst[0] = static_cast<uint8_t>(c0 & 0xFF);
+    pDst[1] = static_cast<uint8_t>(c0 >> 8);
+    pDst[2] = static_cast<uint8_t>(c1 & 0xFF);
+    pDst[3] = static_cast<uint8_t>(c1 >> 8);
+    for (uint32_t b = 0; b < 4; b++) pDst[4 + b] = static_cast<uint8_t>((indices >> (8 * b)) & 0xFF);
+}
+
+void decodeColor(const uint8_t *pSrc, const bool isBc1, const bool hasAlpha, BlockTexels &texels) {
+    const uint16_t c0 = static_cast<uint16_t>(pSrc[0] | (pSrc[1] << 8));
+    const uint16_t c1 = static_cast<uint16_t>(pSrc[2] | (pSrc[3] << 8));
+    const uint32_t indices = pSrc[4] | (pSrc[5] << 8) | (pSrc[6] << 16) | (static_cast<uint32_t>(pSrc[7]) << 24);
+    uint8_t palette[4][4];
+    colorPalette(c0, c1, isBc1, palette);
+    for (uint32_t i = 0; i < 16; i++) {
+        const auto &entry = palette[(indices >> (2 * i)) & 3];
+        for (uint32_t c = 0; c < 3; c++) texels[i][c] = entry[c];
+        if (hasAlpha) texels[i][3] = entry[3];
+    }
+}
+
+// BC4 style single channel block (8 bytes). Always uses the eight value mode.
+void encodeChannel(const BlockTexels &texels, const uint32_t channel, uint8_t *pDst) {
+    uint8_t lo = 255, hi = 0;
+    for (const auto &texel : texels) {
+        lo = std::min(lo, texel[channel]);
+        hi = std::max(hi, texel[channel]);
+    }
+
+    uint64_t indices = 0;
+    if (hi != lo) {
+        uint8_t palette[8];
+        alphaPalette(hi, lo, palette);
+        for (uint32_t i = 0; i < 16; i++) {
+            uint64_t best = 0;
+            int32_t bestDistance = INT32_MAX;
+            for (uint32_t p = 0; p < 8; p++) {
+                const int32_t distance = std::abs(static_cast<int32_t>(texels[i][channel]) - palette[p]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= best << (3 * i);
+        }
+    }
+
+    pDst[0] = hi;
+    pDst[1] = lo;
+    for (uint32_t b = 0; b < 6; b++) pDst[2 + b] = static_cast<uint8_t>((indices >> (8 * b)) & 0xFF);
+}
+
+void decodeChannel(const uint8_t *pSrc, const uint32_t channel, BlockTexels &texels) {
+    uint64_t indices = 0;
+    for (uint32_t b = 0; b < 6; b++) indices |= static_cast<uint64_t>(pSrc[2 + b]) << (8 * b);
+    uint8_t palette[8];
+    alphaPalette(pSrc[0], pSrc[1], palette);
+    for (uint32_t i = 0; i < 16; i++) texels[i][channel] = palette[(indices >> (3 * i)) & 7];
+}
+
+}  // namespace
+
+namespace Sampler {
+namespace Compression {
+
+bool IsBlockCompressed(const vk::Format format) { return GetBlockSize(format) != 0; }
+
+uint32_t GetBlockSize(const vk::Format format) {
+    switch (format) {
+        case vk::Format::eBc1RgbUnormBlock:
+        case vk::Format::eBc1RgbSrgbBlock:
+        case vk::Format::eBc1RgbaUnormBlock:
+        case vk::Format::eBc1RgbaSrgbBlock:
+        case vk::Format::eBc4UnormBlock:
+            return 8;
+        case vk::Format::eBc3UnormBlock:
+        case vk::Format::eBc3SrgbBlock:
+        case vk::Format::eBc5UnormBlock:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+vk::DeviceSize GetLevelSize(const vk::Format format, const vk::Extent3D &extent, const uint32_t layerCount,
+                            const uint32_t texelSize) {
+    const auto blockSize = GetBlockSize(format);
+    if (blockSize) {
+        return static_cast<vk::DeviceSize>(blockCount(extent.width)) * blockCount(extent.height) * blockSize *
+               layerCount;
+    }
+    assert(texelSize);
+    return static_cast<vk::DeviceSize>(extent.width) * extent.height * extent.depth * texelSize * layerCount;
+}
+
+bool IsSupported(const Context &ctx, const vk::Format format) {
+    if (IsBlockCompressed(format) && !ctx.textureCompressionBCEnabled) return false;
+    auto props = ctx.physicalDev.getFormatProperties(format);
+    return (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage) &&
+           (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eTransferSrc) &&
+           (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eTransferDst);
+}
+
+vk::Format Choose(const vk::Format format, const uint32_t channelCount, const uint8_t *pData, const size_t size) {
+    const bool isSrgb = format == vk::Format::eR8G8B8A8Srgb || format == vk::Format::eB8G8R8A8Srgb;
+    switch (channelCount) {
+        // There are no sRGB BC4/BC5 formats.
+        case 1:
+            return isSrgb ? format : vk::Format::eBc4UnormBlock;
+        case 2:
+            return isSrgb ? format : vk::Format::eBc5UnormBlock;
+        case 3:
+            return isSrgb ? vk::Format::eBc1RgbSrgbBlock : vk::Format::eBc1RgbUnormBlock;
+        case 4: {
+            // Only pay for the alpha block if something isn't opaque.
+            bool isOpaque = true;
+            for (size_t i = 3; i < size && isOpaque; i += 4) isOpaque = pData[i] == 255;
+            if (isOpaque) return isSrgb ? vk::Format::eBc1RgbSrgbBlock : vk::Format::eBc1RgbUnormBlock;
+            return isSrgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+        }
+        default:
+            return format;
+    }
+}
+
+void Encode(const vk::Format format, const uint8_t *pSrc, const vk::Extent3D &extent, const uint32_t layerCount,
+            const uint32_t channelCount, std::vector<uint8_t> &dst) {
+    assert(IsBlockCompressed(format));
+    const auto blockSize = GetBlockSize(format);
+    const size_t srcLayerSize = static_cast<size_t>(extent.width) * extent.height * channelCount;
+    dst.resize(static_cast<size_t>(GetLevelSize(format, extent, layerCount)));
+
+    auto *pDst = dst.data();
+    BlockTexels texels;
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        const auto *pLayer = pSrc + (layer * srcLayerSize);
+        for (uint32_t by = 0; by < blockCount(extent.height); by++) {
+            for (uint32_t bx = 0; bx < blockCount(extent.width); bx++) {
+                fetchBlock(pLayer, extent, channelCount, bx, by, texels);
+                switch (format) {
+                    case vk::Format::eBc3UnormBlock:
+                    case vk::Format::eBc3SrgbBlock:
+                        encodeChannel(texels, 3, pDst);
+                        encodeColor(texels, pDst + 8);
+                        break;
+                    case vk::Format::eBc4UnormBlock:
+                        encodeChannel(texels, 0, pDst);
+                        break;
+                    case vk::Format::eBc5UnormBlock:
+                        encodeChannel(texels, 0, pDst);
+                        encodeChannel(texels, 1, pDst + 8);
+                        break;
+                    default:
+                        encodeColor(texels, pDst);
+                        break;
+                }
+                pDst += blockSize;
+            }
+        }
+    }
+}
+
+void Decode(const vk::Format format, const uint8_t *pSrc, const vk::Extent3D &extent, const uint32_t layerCount,
+            const uint32_t channelCount, std::vector<uint8_t> &dst) {
+    assert(IsBlockCompressed(format));
+    const auto blockSize = GetBlockSize(format);
+    const size_t dstLayerSize = static_cast<size_t>(extent.width) * extent.height * channelCount;
+    dst.resize(dstLayerSize * layerCount);
+
+    BlockTexels texels = {};
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        auto *pLayer = dst.data() + (layer * dstLayerSize);
+        for (uint32_t by = 0; by < blockCount(extent.height); by++) {
+            for (uint32_t bx = 0; bx < blockCount(extent.width); bx++) {
+                for (auto &texel : texels) {
+                    texel[0] = texel[1] = texel[2] = 0;
+                    texel[3] = 255;
+                }
+                switch (format) {
+                    case vk::Format::eBc1RgbaUnormBlock:
+                    case vk::Format::eBc1RgbaSrgbBlock:
+                        decodeColor(pSrc, true, true, texels);
+                        break;
+                    case vk::Format::eBc3UnormBlock:
+                    case vk::Format::eBc3SrgbBlock:
+                        decodeChannel(pSrc, 3, texels);
+                        decodeColor(pSrc + 8, false, false, texels);
+                        break;
+                    case vk::Format::eBc4UnormBlock:
+                        decodeChannel(pSrc, 0, texels);
+                        break;
+                    case vk::Format::eBc5UnormBlock:
+                        decodeChannel(pSrc, 0, texels);
+                        decodeChannel(pSrc + 8, 1, texels);
+                        break;
+                    default:
+                        decodeColor(pSrc, true, false, texels);
+                        break;
+                }
+                storeBlock(texels, extent, channelCount, bx, by, pLayer);
+                pSrc += blockSize;
+            }
+        }
+    }
+}
+
+}  // namespace Compression
+}  // namespace Sampler
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef SAMPLER_COMPRESSION_H
+#define SAMPLER_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include <Common/Context.h>
+
+/* Block compression for baked samplers. The format is picked from the sampler's channel layout:
+ *      1 channel               -> BC4
+ *      2 channels              -> BC5
+ *      3/4 channels, opaque    -> BC1
+ *      4 channels              -> BC3 (combined data like normal + height ends up in the BC4 style alpha block)
+ *  Only these formats are recognized, and every one of them can be encoded and decoded.
+ *
+ *  The encoder is a simple bounding box fit. It is meant for baking, not for quality.
+ */
+namespace Sampler {
+namespace Compression {
+
+constexpr uint32_t BLOCK_DIMENSION = 4;
+
+bool IsBlockCompressed(const vk::Format format);
+// Bytes per 4x4 block.
+uint32_t GetBlockSize(const vk::Format format);
+// Size of a mip level with every layer. Works for uncompressed formats if "texelSize" is set.
+vk::DeviceSize GetLevelSize(const vk::Format format, const vk::Extent3D &extent, const uint32_t layerCount,
+                            const uint32_t texelSize = 0);
+// Sampled with optimal tiling, and can be a transfer source and destination.
+bool IsSupported(const Context &ctx, const vk::Format format);
+// Returns "format" if there is no block format for the layout. "pData" is the finest level of the source.
+vk::Format Choose(const vk::Format format, const uint32_t channelCount, const uint8_t *pData, const size_t size);
+
+// "pSrc" is "layerCount" layers of 8-bit texels with "channelCount" channels.
+void Encode(const vk::Format format, const uint8_t *pSrc, const vk::Extent3D &extent, const uint32_t layerCount,
+            const uint32_t channelCount, std::vector<uint8_t> &dst);
+// Inverse of "Encode". Writes 8-bit texels with "channelCount" channels.
+void Decode(const vk::Format format, const uint8_t *pSrc, const vk::Extent3D &extent, const uint32_t layerCount,
+            const uint32_t channelCount, std::vector<uint8_t> &dst);
+
+}  // namespace Compression
+}  // namespace Sampler
+
+#endif  // !SAMPLER_COMPRESSION_H
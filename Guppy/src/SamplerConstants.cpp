@@ -45,10 +45,20 @@ const std::string MYBRICK_HGHT_TEX_PATH = MYBRICK_PATH + "mybrick-height.png";
 
 namespace Sampler {
 
+namespace {
+
+// Color only samplers can take lossy block compression.
+CreateInfo MakeCompressed(CreateInfo createInfo) {
+    createInfo.compress = true;
+    return createInfo;
+}
+
+}  // namespace
+
 // CREATE INFOS
 
 // STATUE
-const CreateInfo STATUE_CREATE_INFO = {
+const CreateInfo STATUE_CREATE_INFO = MakeCompressed({
     "Statue Color Sampler",
     {{{Sampler::USAGE::COLOR, STATUE_TEX_PATH}}},
     // vk::ImageViewType::e2D,
@@ -57,77 +67,77 @@ const CreateInfo STATUE_CREATE_INFO = {
     {},
     {},
     SAMPLER::CLAMP_TO_BORDER,
-};
+});
 
 // VULKAN LOGO
-const CreateInfo VULKAN_CREATE_INFO = {
+const CreateInfo VULKAN_CREATE_INFO = MakeCompressed({
     "Vulkan Color Sampler",
     {{{Sampler::USAGE::COLOR, VULKAN_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // HARDWOOD
-const CreateInfo HARDWOOD_CREATE_INFO = {
+const CreateInfo HARDWOOD_CREATE_INFO = MakeCompressed({
     "Hardwood Color Sampler",
     {{{Sampler::USAGE::COLOR, HARDWOOD_FLOOR_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // NEON BLUE TUX GUPPY
-const CreateInfo NEON_BLUE_TUX_GUPPY_CREATE_INFO = {
+const CreateInfo NEON_BLUE_TUX_GUPPY_CREATE_INFO = MakeCompressed({
     "Neon Blue Tux Guppy Color Sampler",
     {{{Sampler::USAGE::COLOR, NEON_BLUE_TUX_GUPPY_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // BLUEWATER
-const CreateInfo BLUEWATER_CREATE_INFO = {
+const CreateInfo BLUEWATER_CREATE_INFO = MakeCompressed({
     "Bluewater Color Sampler",
     {{{Sampler::USAGE::COLOR, BLUEWATER_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // FIRE
-const CreateInfo FIRE_CREATE_INFO = {
+const CreateInfo FIRE_CREATE_INFO = MakeCompressed({
     "Fire Color Sampler",
     {{{Sampler::USAGE::COLOR, FIRE_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // SMOKE
-const CreateInfo SMOKE_CREATE_INFO = {
+const CreateInfo SMOKE_CREATE_INFO = MakeCompressed({
     "Smoke Color Sampler",
     {{{Sampler::USAGE::COLOR, SMOKE_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // STAR
-const CreateInfo STAR_CREATE_INFO = {
+const CreateInfo STAR_CREATE_INFO = MakeCompressed({
     "Star Color Sampler",
     {{{Sampler::USAGE::COLOR, STAR_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // FABRIC BROWN
-const CreateInfo FABRIC_BROWN_CREATE_INFO = {
+const CreateInfo FABRIC_BROWN_CREATE_INFO = MakeCompressed({
     "Fabric Brown Color Sampler",
     {{{Sampler::USAGE::COLOR, FABRIC_BROWN_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // BRIGHT MOON
-const CreateInfo BRIGHT_MOON_CREATE_INFO = {
+const CreateInfo BRIGHT_MOON_CREATE_INFO = MakeCompressed({
     "Bright Moon Color Sampler",
     {{{Sampler::USAGE::COLOR, BRIGHT_MOON_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // CIRCLES
-const CreateInfo CIRCLES_CREATE_INFO = {
+const CreateInfo CIRCLES_CREATE_INFO = MakeCompressed({
     "Bright Moon Color Sampler",
     {{{Sampler::USAGE::COLOR, CIRCLES_TEX_PATH}}},
     vk::ImageViewType::e2DArray,
-};
+});
 
 // MEDIEVAL HOUSE
 const CreateInfo MEDIEVAL_HOUSE_CREATE_INFO = {
@@ -151,11 +161,11 @@ const CreateInfo WOOD_CREATE_INFO = {
 };
 
 // MYBRICK
-const CreateInfo MYBRICK_COLOR_CREATE_INFO = {
+const CreateInfo MYBRICK_COLOR_CREATE_INFO = MakeCompressed({
     "Mybrick Color Sampler",
     {{{Sampler::USAGE::COLOR, MYBRICK_DIFF_TEX_PATH}}},
     vk::ImageViewType{},
-};
+});
 const CreateInfo MYBRICK_NORMAL_CREATE_INFO = {
     "Mybrick Normal Sampler",
     {{
@@ -96,6 +96,9 @@ struct SwapchainInfo {
 struct MipmapInfo {
     bool generateMipmaps = true;
     bool usesExtent = true;
+    // Upload a coarse tail first, and stream the finer levels in afterwards (see Texture::Handler::stream). Only
+    // used for 8-bit images loaded from file that generate mipmaps.
+    bool stream = true;
 };
 
 struct MipmapCreateInfo {
@@ -119,6 +122,11 @@ struct CreateInfo {
     CHANNELS numberOfChannels = CHANNELS::_4;
     uint8_t bytesPerChannel = 1;
     vk::ImageTiling tiling = vk::ImageTiling::eOptimal;
+    // Bake to a block-compressed format (see Sampler::Compression). Only for color. Normal, height, and other data maps
+    // lose too much.
+    bool compress = false;
+    // Multiply color by alpha after the layers are combined. Only for 8-bit 4 channel files.
+    bool premultiplyAlpha = false;
 };
 
 constexpr uint32_t IMAGE_ARRAY_LAYERS_ALL = UINT32_MAX;
@@ -10,10 +10,12 @@
 
 #include "Face.h"
 #include "RenderPass.h"
+#include "RenderPassManager.h"
 #include "Shell.h"
 // HANDLERS
 #include "MeshHandler.h"
 #include "ModelHandler.h"
+#include "PassHandler.h"
 #include "PipelineHandler.h"
 #include "SceneHandler.h"
 #include "SelectionManager.h"
@@ -58,6 +60,7 @@ void Scene::Base::addMeshIndex(const MESH type, const Mesh::index offset) {
             exit(EXIT_FAILURE);
         }
     }
+    handler().passHandler().renderPassMgr().setDirty();
 }
 
 void Scene::Base::addModelIndex(const Model::index offset) {
@@ -67,6 +70,7 @@ void Scene::Base::addModelIndex(const Model::index offset) {
     }
     assert(modelOffsets_.count(offset) == 0);
     modelOffsets_.insert(offset);
+    handler().passHandler().renderPassMgr().setDirty();
 }
 
 void Scene::Base::record(const RENDER_PASS& passType, const PIPELINE& pipelineType,
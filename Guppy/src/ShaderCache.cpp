@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#include "ShaderCache.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <Common/Helpers.h>
+
+#include "Constants.h"
+#include "ShaderConstants.h"
+#include "Shell.h"
+#include "util.hpp"
+
+namespace {
+
+uint64_t getChecksum(const std::vector<unsigned int> &spv) {
+    uint64_t h = helpers::FNV_OFFSET_BASIS;
+    helpers::hash(h, spv.data(), sizeof(unsigned int) * spv.size());
+    return h;
+}
+
+}  // namespace
+
+namespace Shader {
+namespace Cache {
+
+std::string GetPath() {
+    auto dirname = BASE_DIRNAME;
+    if (!dirname.empty() && dirname.back() == '/') dirname.pop_back();
+    return ROOT_PATH + dirname + std::string(EXTENSION);
+}
+
+uint64_t GetCompilerStamp() {
+    uint64_t h = helpers::FNV_OFFSET_BASIS;
+    const uint32_t values[] = {VERSION, static_cast<uint32_t>(sizeof(unsigned int))};
+    helpers::hash(h, values, sizeof(values));
+    const auto compiler = GLSLtoSPVVersion();
+    helpers::hash(h, compiler.data(), compiler.size());
+    return h;
+}
+
+uint64_t GetKey(const vk::ShaderStageFlagBits stage, const std::vector<std::string> &texts) {
+    uint64_t h = helpers::FNV_OFFSET_BASIS;
+    const auto stageValue = static_cast<uint32_t>(stage);
+    helpers::hash(h, &stageValue, sizeof(stageValue));
+    for (const auto &text : texts) {
+        // The length keeps the boundaries between the texts in the hash.
+        const auto length = static_cast<uint64_t>(text.size());
+        helpers::hash(h, &length, sizeof(length));
+        helpers::hash(h, text.data(), text.size());
+    }
+    return h;
+}
+
+bool Load(const Shell &shell, Data &data) {
+    data.entries.clear();
+    data.dirty = false;
+
+    std::ifstream file(GetPath(), std::ios::binary);
+    if (!file.is_open()) return false;
+
+    Header header = {};
+    if (!helpers::readValue(file, header)) return false;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.compilerStamp != GetCompilerStamp())
+        return false;
+
+    std::vector<Record> records(header.entryCount);
+    if (!file.read(reinterpret_cast<char *>(records.data()), sizeof(Record) * records.size())) return false;
+
+    file.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(file.tellg());
+
+    for (const auto &record : records) {
+        if (record.wordCount == 0 || record.offset + (sizeof(unsigned int) * record.wordCount) > fileSize) break;
+
+        Entry entry = {static_cast<vk::ShaderStageFlagBits>(record.stage), std::vector<unsigned int>(record.wordCount),
+                       false};
+        if (!file.seekg(static_cast<std::streamoff>(record.offset)) ||
+            !file.read(reinterpret_cast<char *>(entry.spv.data()), sizeof(unsigned int) * entry.spv.size()) ||
+            entry.spv.front() != SPIRV_MAGIC || getChecksum(entry.spv) != record.checksum)
+            break;
+
+        data.entries.emplace(record.key, std::move(entry));
+    }
+
+    if (data.entries.size() != records.size()) {
+        shell.log(Shell::LogPriority::LOG_WARN, ("\nShader cache \"" + GetPath() + "\" is corrupt.\n").c_str());
+        data.entries.clear();
+        return false;
+    }
+    return true;
+}
+
+const std::vector<unsigned int> *Find(Data &data, const uint64_t key, const vk::ShaderStageFlagBits stage) {
+    auto it = data.entries.find(key);
+    if (it == data.entries.end() || it->second.stage != stage) return nullptr;
+    it->second.used = true;
+    return &it->second.spv;
+}
+
+void Insert(Data &data, const uint64_t key, const vk::ShaderStageFlagBits stage, const std::vector<unsigned int> &spv) {
+    data.entries[key] = {stage, spv, true};
+    data.dirty = true;
+}
+
+void Prune(Data &data) {
+    for (auto it = data.entries.begin(); it != data.entries.end();) {
+        if (!it->second.used) {
+            it = data.entries.erase(it);
+            data.dirty = true;
+        } else {
+            it->second.used = false;
+            ++it;
+        }
+    }
+}
+
+namespace {
+
+// Everything "Save" writes.
+bool writeCache(std::ofstream &file, const Data &data) {
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.compilerStamp = 0;  // Written last, so a partially written file never matches.
+    header.entryCount = static_cast<uint32_t>(data.entries.size());
+    helpers::writeValue(file, header);
+
+    std::vector<Record> records;
+    records.reserve(data.entries.size());
+    uint64_t offset = sizeof(Header) + (sizeof(Record) * data.entries.size());
+    auto align = [](const uint64_t offset) { return ((offset + 15) / 16) * 16; };
+    for (const auto &[key, entry] : data.entries) {
+        records.push_back({});
+        auto &record = records.back();
+        record.key = key;
+        record.offset = align(offset);
+        record.checksum = getChecksum(entry.spv);
+        record.wordCount = static_cast<uint32_t>(entry.spv.size());
+        record.stage = static_cast<uint32_t>(entry.stage);
+        offset = record.offset + (sizeof(unsigned int) * record.wordCount);
+    }
+    file.write(reinterpret_cast<const char *>(records.data()), sizeof(Record) * records.size());
+
+    size_t i = 0;
+    for (const auto &keyValue : data.entries) {
+        file.seekp(static_cast<std::streamoff>(records[i].offset));
+        file.write(reinterpret_cast<const char *>(keyValue.second.spv.data()),
+                   sizeof(unsigned int) * records[i++].wordCount);
+    }
+
+    header.compilerStamp = GetCompilerStamp();
+    file.seekp(0);
+    helpers::writeValue(file, header);
+    return true;
+}
+
+}  // namespace
+
+bool Save(const Shell &shell, Data &data) {
+    if (!data.dirty) return true;
+
+    const auto path = GetPath();
+    data.dirty = !helpers::writeFileAtomic(path, [&data](std::ofstream &file) { return writeCache(file, data); });
+    if (data.dirty) {
+        std::string msg = "\nCould not write shader cache \"" + path + "\".\n";
+        shell.log(Shell::LogPriority::LOG_WARN, msg.c_str());
+    }
+    return !data.dirty;
+}
+
+}  // namespace Cache
+}  // namespace Shader
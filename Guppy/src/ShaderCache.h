@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class Shell;
+
+namespace Shader {
+
+/* The SPIR-V made for every shader module is cached in a single container next to the shader directory (not in it, so
+ *  writing it never wakes up the directory listener). Entries are keyed by a hash of the stage and the GLSL that was
+ *  actually compiled: the main shader and each of its link shaders after all the text replacement, so anything that
+ *  changes the output (a source or link file, a descriptor slot, a light count...) is a different key. The whole
+ *  container is thrown out if it was made by a different compiler.
+ *
+ *  Layout (little-endian, like every device this runs on):
+ *      Header
+ *      Record[entryCount]  { key, offset, checksum, wordCount, stage } of every entry.
+ *      SPIR-V words        16 byte aligned per entry.
+ */
+namespace Cache {
+
+constexpr std::string_view EXTENSION = ".gspv";
+constexpr char MAGIC[4] = {'G', 'S', 'P', 'V'};
+// Bump this if anything GLSLtoSPV does that is not in the compiler stamp changes (resource limits, messages...).
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t compilerStamp;
+    uint32_t entryCount;
+    uint32_t padding;
+};
+
+struct Record {
+    uint64_t key;
+    uint64_t offset;
+    uint64_t checksum;  // Of the words.
+    uint32_t wordCount;
+    uint32_t stage;  // vk::ShaderStageFlagBits
+};
+
+struct Entry {
+    vk::ShaderStageFlagBits stage;
+    std::vector<unsigned int> spv;
+    bool used;
+};
+
+struct Data {
+    std::unordered_map<uint64_t, Entry> entries;
+    bool dirty = false;
+};
+
+std::string GetPath();
+// Hash of VERSION and GLSLtoSPVVersion().
+uint64_t GetCompilerStamp();
+// Hash of the stage and the texts handed to GLSLtoSPV, in order.
+uint64_t GetKey(const vk::ShaderStageFlagBits stage, const std::vector<std::string> &texts);
+
+// Returns false if there is no usable container. "data" is left empty in that case, and everything gets compiled.
+bool Load(const Shell &shell, Data &data);
+// Returns nullptr if "key" is not cached. Found entries are marked used.
+const std::vector<unsigned int> *Find(Data &data, const uint64_t key, const vk::ShaderStageFlagBits stage);
+void Insert(Data &data, const uint64_t key, const vk::ShaderStageFlagBits stage, const std::vector<unsigned int> &spv);
+// Drops every entry that was not used or inserted since the last prune.
+void Prune(Data &data);
+// Only writes the container if something changed.
+bool Save(const Shell &shell, Data &data);
+
+}  // namespace Cache
+}  // namespace Shader
+
+#endif  // !SHADER_CACHE_H
@@ -19,14 +19,18 @@ void Shader::Handler::init() {
 
     pipelineHandler().makeShaderInfoMap(infoMap_);
 
+    Cache::Load(shell(), spvCache_);
     init_glslang();
 
-    for (auto& keyValue : infoMap_) {
-        bool needsUpdate = make(keyValue, true, true);
-        assert(!needsUpdate);
-    }
+    std::vector<infoMapKeyValue*> pKeyValues;
+    for (auto& keyValue : infoMap_) pKeyValues.push_back(&keyValue);
+    auto needsUpdateTypes = make(pKeyValues, true, true);
+    assert(needsUpdateTypes.empty());
 
     finalize_glslang();
+    // Everything that is still relevant was just used, so this is where stale SPIR-V gets thrown out.
+    Cache::Prune(spvCache_);
+    Cache::Save(shell(), spvCache_);
 
     if (clearTextsAfterLoad) {
         shaderTexts_.clear();
@@ -50,61 +54,117 @@ void Shader::Handler::reset() {
 #include <sstream>
 #endif
 
-bool Shader::Handler::make(infoMapKeyValue& keyValue, bool doAssert, bool isInit) {
-    auto& stageInfo = keyValue.second.second;
-    if (isInit && stageInfo.module) return false;
+std::vector<SHADER> Shader::Handler::make(const std::vector<infoMapKeyValue*>& pKeyValues, bool doAssert, bool isInit) {
+    struct Job {
+        infoMapKeyValue* pKeyValue;
+        std::vector<std::string> texts;
+        uint64_t key;
+        const std::vector<unsigned int>* pSpv;
+        std::vector<unsigned int> spv;
+        std::string log;
+        bool success;
+        size_t compileJob;  // The job with the same key that does the compiling.
+    };
+    std::vector<Job> jobs;
+    std::vector<size_t> compileJobs;
+    // Variants that come out to the same text only get compiled once.
+    std::map<uint64_t, size_t> compileKeys;
+
+    // Everything that touches the handlers, or the text and SPIR-V caches, stays on this thread.
+    for (auto* pKeyValue : pKeyValues) {
+        if (isInit && pKeyValue->second.second.module) continue;
+
+        const auto& createInfo = ALL.at(std::get<0>(pKeyValue->first));
+        if (!isInit) {
+            shell().log(Shell::LogPriority::LOG_INFO,
+                        ("Recompiling shader: \"" + std::string(createInfo.fileName) + "\"").c_str());
+        }
 
-    const auto& createInfo = ALL.at(std::get<0>(keyValue.first));
-    if (!isInit) {
-        shell().log(Shell::LogPriority::LOG_INFO,
-                    ("Recompiling shader: \"" + std::string(createInfo.fileName) + "\"").c_str());
+        // if (std::get<0>(pKeyValue->first) == SHADER::OCEAN_VERT)  //
+        //    auto pause = true;
+        jobs.push_back({pKeyValue, loadText(*pKeyValue, createInfo.replaceMap)});
+        auto& job = jobs.back();
+        job.key = Cache::GetKey(createInfo.stage, job.texts);
+        job.pSpv = Cache::Find(spvCache_, job.key, createInfo.stage);
+        job.success = job.pSpv != nullptr;
+        job.compileJob = jobs.size() - 1;
+        if (job.pSpv == nullptr) {
+            auto it = compileKeys.insert({job.key, jobs.size() - 1});
+            job.compileJob = it.first->second;
+            if (!it.second) continue;
+
+            if (std::get<0>(pKeyValue->first) == SHADER::TEX_FRAG)  //
+                auto pause = true;
+#if PRINT_NAME_ON_COMPILE
+            shell().log(Shell::LogPriority::LOG_INFO,
+                        ("Compiling shader: " + std::string(createInfo.fileName)).c_str());
+#endif
+            compileJobs.push_back(jobs.size() - 1);
+        }
     }
 
-    // if (std::get<0>(keyValue.first) == SHADER::OCEAN_VERT)  //
-    //    auto pause = true;
-    auto stringTexts = loadText(keyValue, createInfo.replaceMap);
+    // Each module is independent, so they all compile at once. glslang was already initialized for the process by the
+    //  caller, and the compile logs are kept with the job instead of printed so they come out in order below.
+    helpers::parallelFor(compileJobs.size(), [&](const size_t i) {
+        auto& job = jobs[compileJobs[i]];
+        // I can't figure out how else to do this atm.
+        std::vector<const char*> texts;
+        for (auto& s : job.texts) texts.push_back(s.c_str());
+        const auto stage = ALL.at(std::get<0>(job.pKeyValue->first)).stage;
+        job.success = GLSLtoSPV(static_cast<VkShaderStageFlagBits>(stage), texts, job.spv, &job.log);
+    });
 
-    // I can't figure out how else to do this atm.
-    std::vector<const char*> texts;
-    for (auto& s : stringTexts) texts.push_back(s.c_str());
+    std::vector<SHADER> needsUpdateTypes;
+    for (auto& job : jobs) {
+        auto& stageInfo = job.pKeyValue->second.second;
+        const auto& createInfo = ALL.at(std::get<0>(job.pKeyValue->first));
+
+        if (job.pSpv == nullptr && job.compileJob != static_cast<size_t>(&job - jobs.data())) {
+            // A variant with the same text. It was compiled, and cached, by an earlier job.
+            const auto& compileJob = jobs[job.compileJob];
+            job.success = compileJob.success;
+            if (job.success) job.pSpv = compileJob.pSpv;
+        }
 
-    std::vector<unsigned int> spv;
-    if (std::get<0>(keyValue.first) == SHADER::TEX_FRAG)  //
-        auto pause = true;
-#if PRINT_NAME_ON_COMPILE
-    shell().log(Shell::LogPriority::LOG_INFO, ("Compiling shader: " + std::string(createInfo.fileName)).c_str());
-#endif
-    bool success = GLSLtoSPV(static_cast<VkShaderStageFlagBits>(createInfo.stage), texts, spv);
+        // Skip or assert on fail
+        if (!job.success) {
+            if (!job.log.empty()) shell().log(Shell::LogPriority::LOG_ERR, job.log.c_str());
+            shell().log(Shell::LogPriority::LOG_ERR,
+                        ("Error compiling shader: " + std::string(createInfo.fileName)).c_str());
+            if (doAssert) {
+                assert(job.success);
+            }
+            continue;
+        }
 
-    // Return or assert on fail
-    if (!success) {
-        shell().log(Shell::LogPriority::LOG_ERR, ("Error compiling shader: " + std::string(createInfo.fileName)).c_str());
-        if (doAssert) {
-            assert(success);
+        if (job.pSpv == nullptr) {
+            Cache::Insert(spvCache_, job.key, createInfo.stage, job.spv);
+            job.pSpv = &job.spv;
         }
-        return false;
-    }
 
-    vk::ShaderModuleCreateInfo moduleInfo = {};
-    moduleInfo.codeSize = spv.size() * sizeof(unsigned int);
-    moduleInfo.pCode = spv.data();
+        vk::ShaderModuleCreateInfo moduleInfo = {};
+        moduleInfo.codeSize = job.pSpv->size() * sizeof(unsigned int);
+        moduleInfo.pCode = job.pSpv->data();
 
-    // Store old module for clean up if necessary
-    bool needsUpdate = stageInfo.module;
-    if (needsUpdate) oldModules_.push_back(std::move(stageInfo.module));
+        // Store old module for clean up if necessary
+        if (stageInfo.module) {
+            oldModules_.push_back(std::move(stageInfo.module));
+            needsUpdateTypes.push_back(std::get<0>(job.pKeyValue->first));
+        }
 
-    stageInfo = vk::PipelineShaderStageCreateInfo{};
-    stageInfo.stage = createInfo.stage;
-    stageInfo.pName = "main";
-    stageInfo.module = shell().context().dev.createShaderModule(moduleInfo, shell().context().pAllocator);
+        stageInfo = vk::PipelineShaderStageCreateInfo{};
+        stageInfo.stage = createInfo.stage;
+        stageInfo.pName = "main";
+        stageInfo.module = shell().context().dev.createShaderModule(moduleInfo, shell().context().pAllocator);
 #if PRINT_NAME_ON_CREATE
-    std::stringstream ss;
-    ss << "Creating shader module: " << createInfo.fileName << " 0x" << stageInfo.module;
-    shell().log(Shell::LogPriority::LOG_INFO, ss.str().c_str());
+        std::stringstream ss;
+        ss << "Creating shader module: " << createInfo.fileName << " 0x" << stageInfo.module;
+        shell().log(Shell::LogPriority::LOG_INFO, ss.str().c_str());
 #endif
-    // shell().context().dbg.setMarkerName(stageInfo.module, createInfo.name.c_str());
+        // shell().context().dbg.setMarkerName(stageInfo.module, createInfo.name.c_str());
+    }
 
-    return needsUpdate;
+    return needsUpdateTypes;
 }
 
 std::vector<std::string> Shader::Handler::loadText(const infoMapKeyValue& keyValue,
@@ -122,7 +182,6 @@ std::vector<std::string> Shader::Handler::loadText(const infoMapKeyValue& keyVal
     textReplaceDescSet(keyValue.second.first, texts.back());
     uniformHandler().textReplaceShader(keyValue.second.first, Shader::ALL.at(std::get<0>(keyValue.first)).fileName,
                                        texts.back());
-    textReplacePipeline(std::get<1>(keyValue.first), texts.back());
 
     // link shader text
     for (const auto& linkShaderType : createInfo.linkTypes) {
@@ -136,7 +195,6 @@ std::vector<std::string> Shader::Handler::loadText(const infoMapKeyValue& keyVal
         textReplaceDescSet(keyValue.second.first, texts.back());
         uniformHandler().textReplaceShader(keyValue.second.first, Shader::LINK_ALL.at(linkShaderType).fileName,
                                            texts.back());
-        textReplacePipeline(std::get<1>(keyValue.first), texts.back());
     }
     return texts;
 }
@@ -153,33 +211,9 @@ void Shader::Handler::textReplaceDescSet(const Descriptor::Set::textReplaceTuple
     }
 }
 
-void Shader::Handler::textReplacePipeline(const PIPELINE pipelineType, std::string& text) const {
-    if (!std::visit(Pipeline::IsCompute{}, pipelineType)) return;
-    {  // LOCAL SIZE
-        const auto localSize =
-            static_cast<const Pipeline::Compute*>(pipelineHandler().getPipeline(pipelineType).get())->getLocalSize();
-        auto replaceInfo = helpers::getMacroReplaceInfo(Pipeline::LOCAL_SIZE_MACRO_ID_PREFIX, text);
-        for (auto& info : replaceInfo) {
-            switch (std::get<0>(info).back()) {
-                case 'X':
-                    helpers::macroReplace(info, localSize.x, text);
-                    break;
-                case 'Y':
-                    helpers::macroReplace(info, localSize.y, text);
-                    break;
-                case 'Z':
-                    helpers::macroReplace(info, localSize.z, text);
-                    break;
-                default:
-                    assert(false && "Unhandled case");
-                    break;
-            }
-        }
-    }
-}
-
 void Shader::Handler::getStagesInfo(const SHADER& shaderType, const PIPELINE& pipelineType, const PASS& passType,
-                                    std::vector<vk::PipelineShaderStageCreateInfo>& stagesInfo) const {
+                                    std::vector<vk::PipelineShaderStageCreateInfo>& stagesInfo,
+                                    std::vector<Pipeline::specializationConstants>& stagesConstants) const {
     auto it1 = infoMap_.begin();
     auto it2 = infoMap_.end();
     // Look for a specific stage info
@@ -189,6 +223,8 @@ void Shader::Handler::getStagesInfo(const SHADER& shaderType, const PIPELINE& pi
         if (it2 == infoMap_.end()) it2 = it1;  // Save the spot where the relevant info begins
         if (std::get<2>(it1->first).find(passType) != std::get<2>(it1->first).end()) {
             stagesInfo.push_back(it1->second.second);
+            stagesConstants.push_back({});
+            uniformHandler().getArrayCountConstants(it1->second.first, stagesConstants.back());
             return;
         };
     }
@@ -200,6 +236,8 @@ void Shader::Handler::getStagesInfo(const SHADER& shaderType, const PIPELINE& pi
         if (std::get<1>(it1->first) != pipelineType) continue;
         if (std::get<2>(it1->first) == Uniform::PASS_ALL_SET) {
             stagesInfo.push_back(it1->second.second);
+            stagesConstants.push_back({});
+            uniformHandler().getArrayCountConstants(it1->second.first, stagesConstants.back());
             return;
         };
     }
@@ -215,17 +253,13 @@ vk::ShaderStageFlags Shader::Handler::getStageFlags(const std::set<SHADER>& shad
 void Shader::Handler::recompileShader(std::string fileName) {
     init_glslang();
 
-    std::vector<SHADER> needsUpdateTypes;
+    std::vector<infoMapKeyValue*> pKeyValues;
 
     // Check for main shader
     for (const auto& [shaderType, createInfo] : ALL) {
         if (createInfo.fileName == fileName) {
             for (auto& stageInfoKeyValue : infoMap_) {
-                if (std::get<0>(stageInfoKeyValue.first) == shaderType) {
-                    if (make(stageInfoKeyValue, settings().assertOnRecompileShader, false)) {
-                        needsUpdateTypes.push_back(shaderType);
-                    }
-                }
+                if (std::get<0>(stageInfoKeyValue.first) == shaderType) pKeyValues.push_back(&stageInfoKeyValue);
             }
         }
     }
@@ -238,20 +272,19 @@ void Shader::Handler::recompileShader(std::string fileName) {
             getShaderTypes(linkShaderType, shaderTypes);
             for (auto& stageInfoKeyValue : infoMap_) {
                 for (const auto& shaderType : shaderTypes) {
-                    if (std::get<0>(stageInfoKeyValue.first) == shaderType) {
-                        if (make(stageInfoKeyValue, settings().assertOnRecompileShader, false)) {
-                            needsUpdateTypes.push_back(shaderType);
-                        }
-                    }
+                    if (std::get<0>(stageInfoKeyValue.first) == shaderType) pKeyValues.push_back(&stageInfoKeyValue);
                 }
             }
         }
     }
 
+    auto needsUpdateTypes = make(pKeyValues, settings().assertOnRecompileShader, false);
+
     // Notify pipeline handler
     if (needsUpdateTypes.size()) pipelineHandler().needsUpdate(needsUpdateTypes);
 
     finalize_glslang();
+    Cache::Save(shell(), spvCache_);
 
     if (clearTextsAfterLoad) {
         shaderTexts_.clear();
@@ -268,6 +301,8 @@ void Shader::Handler::getShaderTypes(const SHADER_LINK& linkType, std::vector<SH
 }
 
 void Shader::Handler::cleanup() {
+    // Pipelines being made in the background might still be using the old modules.
+    if (pipelineHandler().isCreatingPipelines()) return;
     for (auto& module : oldModules_)  //
         shell().context().dev.destroyShaderModule(module, shell().context().pAllocator);
     oldModules_.clear();
@@ -14,6 +14,7 @@
 
 #include "ConstantsAll.h"
 #include "Game.h"
+#include "ShaderCache.h"
 
 namespace Shader {
 
@@ -24,8 +25,10 @@ class Handler : public Game::Handler {
     void init() override;
     inline void destroy() override { reset(); }
 
+    // Also adds the constants the stage is specialized with to "stagesConstants", one entry per stage info.
     void getStagesInfo(const SHADER &shaderType, const PIPELINE &pipelineType, const PASS &passType,
-                       std::vector<vk::PipelineShaderStageCreateInfo> &stagesInfo) const;
+                       std::vector<vk::PipelineShaderStageCreateInfo> &stagesInfo,
+                       std::vector<Pipeline::specializationConstants> &stagesConstants) const;
     vk::ShaderStageFlags getStageFlags(const std::set<SHADER> &shaderTypes) const;
 
     void recompileShader(std::string);
@@ -35,10 +38,11 @@ class Handler : public Game::Handler {
    private:
     void reset() override;
 
-    bool make(infoMapKeyValue &keyValue, bool doAssert, bool isInit);
+    // Compiles whatever is not in the SPIR-V cache in parallel, then makes the modules in order. Returns the types
+    //  whose modules were replaced.
+    std::vector<SHADER> make(const std::vector<infoMapKeyValue *> &pKeyValues, bool doAssert, bool isInit);
     std::vector<std::string> loadText(const infoMapKeyValue &keyValue, const std::map<std::string, std::string> &replaceMap);
     void textReplaceDescSet(const Descriptor::Set::textReplaceTuples &replaceTuples, std::string &text) const;
-    void textReplacePipeline(const PIPELINE pipelineType, std::string &text) const;
 
     // SHADERS
     void getShaderTypes(const SHADER_LINK &linkType, std::vector<SHADER> &types);
@@ -48,6 +52,7 @@ class Handler : public Game::Handler {
     std::map<SHADER_LINK, std::string> shaderLinkTexts_;
 
     infoMap infoMap_;
+    Cache::Data spvCache_;
 
     std::queue<PIPELINE> updateQueue_;
     std::vector<vk::ShaderModule> oldModules_;
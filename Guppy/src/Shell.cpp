@@ -52,6 +52,8 @@ Shell::Shell(Game &game, Handlers &&handlers)
           {VK_EXT_DEBUG_MARKER_EXTENSION_NAME, false, settings_.tryDebugMarkers},
           {VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME, false, false},
           {VK_EXT_TRANSFORM_FEEDBACK_EXTENSION_NAME, false, false},
+          {VK_KHR_MAINTENANCE3_EXTENSION_NAME, false, settings_.tryBindless},
+          {VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, false, settings_.tryBindless},
       },
       currentTime_(0.0),
       elapsedTime_(0.0),
@@ -219,6 +221,7 @@ void Shell::destroyContext() {
     game_.onDetachShell();
     destroyBackBuffers();
 
+    if (ctx_.pMemAllocator) log(LogPriority::LOG_INFO, ctx_.pMemAllocator->getStatsString().c_str());
     ctx_.destroyDevice();
 }
 
@@ -589,6 +592,40 @@ void Shell::enumeratePhysicalDevices(uint32_t physicalDevCount) {
                         }
                     }
 
+                } else if (strcmp(extInfo.name, (char *)VK_KHR_MAINTENANCE3_EXTENSION_NAME) == 0) {
+                    // Descriptor indexing depends on it.
+                    if (extInfo.tryToEnabled) {
+                        props.phyDevExtInfos.back().valid = true;
+                        continue;
+                    }
+
+                } else if (strcmp(extInfo.name, (char *)VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0) {
+                    if (extInfo.tryToEnabled && VULKAN_HPP_DEFAULT_DISPATCHER.vkGetPhysicalDeviceFeatures2) {
+                        // Check features
+                        using featuresEXT = vk::PhysicalDeviceDescriptorIndexingFeaturesEXT;
+                        using propertiesEXT = vk::PhysicalDeviceDescriptorIndexingPropertiesEXT;
+                        auto features = props.device.getFeatures2<vk::PhysicalDeviceFeatures2, featuresEXT>();
+                        auto properties = props.device.getProperties2<vk::PhysicalDeviceProperties2, propertiesEXT>();
+                        props.featDescIndexing = features.get<featuresEXT>();
+                        props.featDescIndexing.pNext = nullptr;
+                        props.propsDescIndexing = properties.get<propertiesEXT>();
+                        props.propsDescIndexing.pNext = nullptr;
+                        // Same as the features that Context::createDevice enables.
+                        const auto &core = features.get<vk::PhysicalDeviceFeatures2>().features;
+                        const auto &feat = props.featDescIndexing;
+                        if (core.shaderSampledImageArrayDynamicIndexing &&
+                            core.shaderStorageBufferArrayDynamicIndexing &&
+                            feat.shaderSampledImageArrayNonUniformIndexing &&
+                            feat.shaderStorageBufferArrayNonUniformIndexing &&
+                            feat.descriptorBindingSampledImageUpdateAfterBind &&
+                            feat.descriptorBindingStorageBufferUpdateAfterBind &&
+                            feat.descriptorBindingUpdateUnusedWhilePending && feat.descriptorBindingPartiallyBound &&
+                            feat.runtimeDescriptorArray) {
+                            props.phyDevExtInfos.back().valid = true;
+                            continue;
+                        }
+                    }
+
                 } else {
                     assert(false && "Unhandled physical device extension");
                     exit(EXIT_FAILURE);
@@ -629,6 +666,7 @@ void Shell::pickPhysicalDevice() {
             deviceExtensionInfo_ = props.phyDevExtInfos;
 
             // Flags
+            bool maintenance3Enabled = false;
             for (const auto &extInfo : deviceExtensionInfo_) {
                 if (strcmp(extInfo.name, (char *)VK_EXT_DEBUG_MARKER_EXTENSION_NAME) == 0)
                     ctx_.debugMarkersEnabled = extInfo.valid;
@@ -636,7 +674,14 @@ void Shell::pickPhysicalDevice() {
                     ctx_.vertexAttributeDivisorEnabled = extInfo.valid;
                 if (strcmp(extInfo.name, (char *)VK_EXT_TRANSFORM_FEEDBACK_EXTENSION_NAME) == 0)
                     ctx_.transformFeedbackEnabled = extInfo.valid;
+                if (strcmp(extInfo.name, (char *)VK_KHR_MAINTENANCE3_EXTENSION_NAME) == 0)
+                    maintenance3Enabled = extInfo.valid;
+                if (strcmp(extInfo.name, (char *)VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0)
+                    ctx_.bindlessEnabled = extInfo.valid;
             }
+            ctx_.bindlessEnabled &= maintenance3Enabled;
+            if (settings_.tryBindless && !ctx_.bindlessEnabled)  //
+                log(LogPriority::LOG_WARN, "cannot enable bindless descriptors (descriptor indexing)");
 
             break;
         }
@@ -762,6 +807,10 @@ void Shell::determineDeviceFeatureSupport(const Context::PhysicalDevicePropertie
     ctx_.imageCubeArrayEnabled = props.features.imageCubeArray && settings_.tryImageCubeArray;
     if (settings_.tryImageCubeArray && !ctx_.imageCubeArrayEnabled)  //
         log(LogPriority::LOG_WARN, "cannot enable image cube arrays");
+    // BC texture compression
+    ctx_.textureCompressionBCEnabled = props.features.textureCompressionBC && settings_.tryTextureCompressionBC;
+    if (settings_.tryTextureCompressionBC && !ctx_.textureCompressionBCEnabled)  //
+        log(LogPriority::LOG_WARN, "cannot enable BC texture compression (baked textures will be decoded on the CPU)");
 }
 
 void Shell::determineSampleCount(const Context::PhysicalDeviceProperties &props) {
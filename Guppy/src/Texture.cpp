@@ -18,6 +18,7 @@ Texture::Base::Base(const uint32_t&& offset, const CreateInfo* pCreateInfo)
       flags(0),
       usesSwapchain(false),
       aspect(BAD_ASPECT),
+      priority(0.0f),
       pLdgRes(nullptr) {}
 
 void Texture::Base::destroy(const Context& ctx) {
@@ -27,6 +27,12 @@ class Base {
 
     void destroy(const Context &ctx);
 
+    inline bool isResident() const {
+        for (const auto &sampler : samplers)
+            if (!sampler.isResident()) return false;
+        return true;
+    }
+
     const DESCRIPTOR DESCRIPTOR_TYPE;  // TODO: this should probably be detemined by the pipeline/set
     const bool HAS_DATA;
     const std::string NAME;
@@ -37,6 +43,7 @@ class Base {
     FlagBits flags;  // TODO: Still needed?
     bool usesSwapchain;
     float aspect;  // TODO: Set per sampler passing a dynamic list to shaders?
+    float priority;  // Rough screen-space size. Only used to order mip streaming.
     std::unique_ptr<LoadingResource> pLdgRes;
 
     std::vector<Sampler::Base> samplers;
@@ -27,6 +27,15 @@ struct CreateInfo {
     DESCRIPTOR descriptorType = COMBINED_SAMPLER::DONT_CARE;
 };
 
+// STREAMING
+
+// Streamed textures start with every level at or below this dimension resident.
+constexpr uint32_t STREAM_COARSE_DIMENSION = 64;
+// Device memory streamed textures are allowed to take up. A texture that doesn't fit drops its finest levels.
+constexpr vk::DeviceSize STREAM_BUDGET = 256 * 1024 * 1024;
+// Limit on refinement uploads per tick.
+constexpr vk::DeviceSize STREAM_BYTES_PER_TICK = 8 * 1024 * 1024;
+
 // CREATE INFOS
 
 constexpr std::string_view STATUE_ID = "Statue Texture";
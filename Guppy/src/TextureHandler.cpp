@@ -6,6 +6,8 @@
 #include "TextureHandler.h"
 
 #include <algorithm>
+#include <cfloat>
+#include <cstring>
 #include <future>
 #include <stb_image.h>
 #include <variant>
@@ -14,6 +16,7 @@
 #include "Deferred.h"
 #include "FFT.h"
 #include "Ocean.h"
+#include "SamplerCompression.h"
 #include "ScreenSpace.h"
 #include "Shadow.h"
 #include "Shell.h"
@@ -22,10 +25,13 @@
 #include "DescriptorHandler.h"
 #include "LoadingHandler.h"
 #include "MaterialHandler.h"
+#include "MeshHandler.h"
 #include "ShaderHandler.h"
+#include "UniformHandler.h"
 
 Texture::Handler::Handler(Game* pGame)
     : Game::Handler(pGame),  //
+      streamedBytes_(0),
       perFramebufferSuffix_("(.*) #(\\d+)$") {}
 
 void Texture::Handler::init() {
@@ -116,11 +122,11 @@ void Texture::Handler::reset() {
         }
     }
     pTextures_.clear();
+    streamedBytes_ = 0;
     // BUFFER VIEWS
     for (auto& bv : bufferViews_) {
         ctx.dev.destroyBufferView(bv.view, ctx.pAllocator);
-        ctx.dev.destroyBuffer(bv.buffRes.buffer, ctx.pAllocator);
-        ctx.dev.freeMemory(bv.buffRes.memory, ctx.pAllocator);
+        ctx.destroyBuffer(bv.buffRes);
     }
     bufferViews_.clear();
 }
@@ -189,21 +195,21 @@ void Texture::Handler::makeBufferView(const std::string_view& id, const vk::Form
     bufferViews_.push_back({id});
     bufferViews_.back().pLdgRes = loadingHandler().createLoadingResources();
 
-    BufferResource stgRes = {};
-    ctx.createBuffer(bufferViews_.back().pLdgRes->transferCmd,
+    ctx.createBuffer(*bufferViews_.back().pLdgRes,
                      vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer, size,
-                     std::string(id) + " uniform texel buffer", stgRes, bufferViews_.back().buffRes, pData);
-    bufferViews_.back().pLdgRes->stgResources.push_back(stgRes);
+                     std::string(id) + " uniform texel buffer", bufferViews_.back().buffRes, pData);
 
-    loadingHandler().loadSubmit(std::move(bufferViews_.back().pLdgRes));
+    // The vector can grow before the loading commands are done, so find the view again by id.
+    loadingHandler().loadSubmit(std::move(bufferViews_.back().pLdgRes), [this, id = std::string(id)]() {
+        for (auto& bv : bufferViews_)
+            if (bv.id == id) bv.status = STATUS::READY;
+    });
 
     vk::BufferViewCreateInfo createInfo = {};
     createInfo.format = format;
     createInfo.range = size;
     createInfo.buffer = bufferViews_.back().buffRes.buffer;
     bufferViews_.back().view = ctx.dev.createBufferView(createInfo, ctx.pAllocator);
-
-    bufferViews_.back().status = STATUS::READY;
 }
 
 const std::shared_ptr<Texture::Base> Texture::Handler::getTexture(const std::string_view& textureId) const {
@@ -318,9 +324,29 @@ void Texture::Handler::createTexture(std::shared_ptr<Texture::Base> pTexture, bo
     // Create the texture on the device
     for (auto& sampler : pTexture->samplers) makeTexture(pTexture, sampler);
 
-    if (stageResources) loadingHandler().loadSubmit(std::move(pTexture->pLdgRes));
+    // Staged textures are not ready until the device is done with the loading commands.
+    if (stageResources)
+        loadingHandler().loadSubmit(std::move(pTexture->pLdgRes), [this, pTexture]() { setReady(pTexture); });
+    else
+        setReady(pTexture);
+}
+
+void Texture::Handler::setReady(std::shared_ptr<Texture::Base> pTexture) {
     pTexture->status = STATUS::READY;
 
+    // Material textures also go in the bindless sampler array. A remade texture gets a new slot.
+    if (descriptorHandler().bindless().isEnabled() &&
+        std::visit(Descriptor::IsCombinedSamplerMaterial{}, pTexture->DESCRIPTOR_TYPE)) {
+        for (auto& sampler : pTexture->samplers) {
+            if (sampler.bindlessIndex != Descriptor::Bindless::INVALID_INDEX)
+                descriptorHandler().releaseBindless(Descriptor::Bindless::ARRAY::SAMPLER, sampler.bindlessIndex);
+            sampler.bindlessIndex =
+                descriptorHandler().addBindless(sampler.imgInfo.descInfoMap.at(Sampler::IMAGE_ARRAY_LAYERS_ALL));
+            if (sampler.bindlessIndex == Descriptor::Bindless::INVALID_INDEX)
+                shell().log(Shell::LogPriority::LOG_WARN, ("Bindless sampler array is full: " + sampler.NAME).c_str());
+        }
+    }
+
     // Notify any materials to update their data
     materialHandler().updateTexture(pTexture);
 }
@@ -334,7 +360,13 @@ void Texture::Handler::makeTexture(std::shared_ptr<Texture::Base>& pTexture, Sam
         createImage(sampler, pTexture->pLdgRes);
     }
 
-    if (sampler.mipmapInfo.generateMipmaps && sampler.imgCreateInfo.mipLevels > 1) {
+    if (!sampler.mipData.empty()) {
+        // Only the coarse tail was uploaded in "createImage". Fill the rest of the chain from it until "stream" gets
+        // to the finer levels.
+        fillFinerMips(pTexture->pLdgRes->graphicsCmd, sampler, sampler.residentMip,
+                      sampler.imgCreateInfo.mipLevels - sampler.residentMip);
+        if (sampler.isResident()) sampler.mipData.clear();
+    } else if (sampler.mipmapInfo.generateMipmaps && sampler.imgCreateInfo.mipLevels > 1) {
         generateMipmaps(sampler, pTexture->pLdgRes);
     } else if (pTexture->pLdgRes == nullptr) {
         if (!std::visit(Descriptor::IsInputAttachment{}, pTexture->DESCRIPTOR_TYPE)) {
@@ -385,14 +417,17 @@ void Texture::Handler::makeTexture(std::shared_ptr<Texture::Base>& pTexture, Sam
 void Texture::Handler::createImage(Sampler::Base& sampler, std::unique_ptr<LoadingResource>& pLdgRes) {
     // Loading data only settings for image
     if (pLdgRes != nullptr) {
-        assert(sampler.imgCreateInfo.arrayLayers == sampler.pPixels.size());
+        if (sampler.mipData.empty())
+            assert(sampler.imgCreateInfo.arrayLayers == sampler.pPixels.size());
+        else
+            applyBudget(sampler);
         sampler.imgCreateInfo.usage |= vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
     } else {
         assert(sampler.pPixels.empty());
     }
 
-    // Using CmdBufHandler::getUniqueQueueFamilies(true, false, true) here might not be wise... To work
-    // right it relies on the the two command buffers being created with the same data.
+    // The image is exclusive (see Sampler::Base), so these are ignored. Loaded images are handed from the transfer
+    // queue to the graphics queue with an ownership transfer instead.
     auto queueFamilyIndices = commandHandler().getUniqueQueueFamilies(true, false, true, false);
     sampler.imgCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
     sampler.imgCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
@@ -427,33 +462,67 @@ void Texture::Handler::createImage(Sampler::Base& sampler, std::unique_ptr<Loadi
     }
 
     // Allocate memory
-    helpers::createImageMemory(shell().context().dev, shell().context().memProps, memFlags, sampler.image, sampler.memory,
-                               shell().context().pAllocator);
+    helpers::createImageMemory(*shell().context().pMemAllocator, memFlags, sampler.image, sampler.allocation,
+                               sampler.imgCreateInfo.tiling);
 
     // If loading data create a staging buffer, and copy/transition the data to the image.
     if (pLdgRes != nullptr) {
         BufferResource stgRes = {};
-        vk::DeviceSize memorySize = sampler.size();
-        auto memReqsSize =
-            helpers::createBuffer(shell().context().dev, memorySize, vk::BufferUsageFlagBits::eTransferSrc,
-                                  vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                                  shell().context().memProps, stgRes.buffer, stgRes.memory, shell().context().pAllocator);
+        std::vector<vk::BufferImageCopy> regions;
+        vk::DeviceSize memorySize = 0;
+        if (sampler.mipData.empty()) {
+            memorySize = sampler.size();
+        } else {
+            // Streamed images only upload the coarse tail here. Each level is a region with every layer.
+            for (uint32_t level = sampler.residentMip; level < sampler.imgCreateInfo.mipLevels; level++) {
+                memorySize = ((memorySize + 15) / 16) * 16;
+                vk::BufferImageCopy region = {};
+                region.bufferOffset = memorySize;
+                region.imageSubresource = {vk::ImageAspectFlagBits::eColor, level, 0,
+                                           sampler.imgCreateInfo.arrayLayers};
+                region.imageExtent = sampler.mipExtent(level);
+                regions.push_back(region);
+                memorySize += sampler.mipLevelData(level).size();
+            }
+        }
+        helpers::createBuffer(shell().context().dev, *shell().context().pMemAllocator, memorySize,
+                              vk::BufferUsageFlagBits::eTransferSrc,
+                              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                              stgRes.buffer, stgRes.allocation, shell().context().pAllocator, true);
 
-        void* pData = shell().context().dev.mapMemory(stgRes.memory, 0, memReqsSize);
+        void* pData = stgRes.allocation.pMappedData;
         size_t offset = 0;
         // Copy data to memory
-        sampler.copyData(pData, offset);
-
-        shell().context().dev.unmapMemory(stgRes.memory);
+        if (sampler.mipData.empty()) {
+            sampler.copyData(pData, offset);
+        } else {
+            for (const auto& region : regions) {
+                const auto& data = sampler.mipLevelData(region.imageSubresource.mipLevel);
+                std::memcpy(static_cast<uint8_t*>(pData) + region.bufferOffset, data.data(), data.size());
+            }
+        }
 
         helpers::transitionImageLayout(pLdgRes->transferCmd, sampler.image, sampler.imgCreateInfo.format,
                                        vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
                                        vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
                                        sampler.imgCreateInfo.mipLevels, sampler.imgCreateInfo.arrayLayers);
 
-        helpers::copyBufferToImage(pLdgRes->graphicsCmd, sampler.imgCreateInfo.extent.width,
-                                   sampler.imgCreateInfo.extent.height, sampler.imgCreateInfo.arrayLayers, stgRes.buffer,
-                                   sampler.image);
+        if (regions.empty()) {
+            helpers::copyBufferToImage(pLdgRes->transferCmd, sampler.imgCreateInfo.extent.width,
+                                       sampler.imgCreateInfo.extent.height, sampler.imgCreateInfo.arrayLayers,
+                                       stgRes.buffer, sampler.image);
+        } else {
+            pLdgRes->transferCmd.copyBufferToImage(stgRes.buffer, sampler.image, vk::ImageLayout::eTransferDstOptimal,
+                                                   regions);
+        }
+
+        // Hand the image over to the graphics queue for mipmaps, and the final transition.
+        if (pLdgRes->shouldWait) {
+            helpers::transferImageOwnership(pLdgRes->transferCmd, pLdgRes->graphicsCmd, sampler.image,
+                                            vk::ImageLayout::eTransferDstOptimal, commandHandler().transferIndex(),
+                                            commandHandler().graphicsIndex(), sampler.imgCreateInfo.mipLevels,
+                                            sampler.imgCreateInfo.arrayLayers);
+        }
 
         pLdgRes->stgResources.push_back(stgRes);
     }
@@ -486,8 +555,8 @@ void Texture::Handler::createDepthImage(Sampler::Base& sampler, std::unique_ptr<
     sampler.image = shell().context().dev.createImage(sampler.imgCreateInfo, shell().context().pAllocator);
 
     // Allocate memory
-    helpers::createImageMemory(shell().context().dev, shell().context().memProps, vk::MemoryPropertyFlagBits::eDeviceLocal,
-                               sampler.image, sampler.memory, shell().context().pAllocator);
+    helpers::createImageMemory(*shell().context().pMemAllocator, vk::MemoryPropertyFlagBits::eDeviceLocal, sampler.image,
+                               sampler.allocation, sampler.imgCreateInfo.tiling);
 }
 
 void Texture::Handler::generateMipmaps(Sampler::Base& sampler, std::unique_ptr<LoadingResource>& pLdgRes) {
@@ -613,6 +682,205 @@ void Texture::Handler::createDescInfo(std::shared_ptr<Texture::Base>& pTexture,
     sampler.imgInfo.image = sampler.image;
 }
 
+void Texture::Handler::applyBudget(Sampler::Base& sampler) {
+    const auto levelCount = static_cast<uint32_t>(sampler.mipData.size());
+    assert(sampler.mipBias == 0 && levelCount == sampler.imgCreateInfo.mipLevels);
+
+    // Everything at or below the coarse dimension is always resident.
+    uint32_t coarseMip = 0;
+    while (coarseMip + 1 < levelCount) {
+        const auto extent = sampler.mipExtent(coarseMip);
+        if (std::max(extent.width, extent.height) <= STREAM_COARSE_DIMENSION) break;
+        coarseMip++;
+    }
+
+    // Drop the finest levels until the chain fits in what is left of the budget.
+    auto chainSize = [&sampler](uint32_t firstLevel) {
+        vk::DeviceSize size = 0;
+        for (auto level = firstLevel; level < sampler.mipData.size(); level++) size += sampler.mipData[level].size();
+        return size;
+    };
+    uint32_t bias = 0;
+    while (bias < coarseMip && streamedBytes_ + chainSize(bias) > STREAM_BUDGET) bias++;
+    if (bias) {
+        std::string msg = "\nTexture budget exceeded. Sampler \"" + sampler.NAME + "\" dropped " +
+                          std::to_string(bias) + " mip level(s).\n";
+        shell().log(Shell::LogPriority::LOG_WARN, msg.c_str());
+        for (uint32_t level = 0; level < bias; level++) sampler.mipData[level].release();
+    }
+    sampler.budgetSize = chainSize(bias);
+    streamedBytes_ += sampler.budgetSize;
+
+    sampler.imgCreateInfo.extent = sampler.mipExtent(bias);
+    sampler.imgCreateInfo.mipLevels = levelCount - bias;
+    sampler.mipBias = bias;
+    // Block-compressed levels can't be blitted into, so there is no upsampled placeholder and they skip streaming. The
+    // whole chain (past the bias) is uploaded up front, and they are small enough for that.
+    sampler.residentMip = Sampler::Compression::IsBlockCompressed(sampler.imgCreateInfo.format) ? 0 : coarseMip - bias;
+}
+
+void Texture::Handler::destroyTexture(Texture::Base& texture) {
+    // Give the budget back, so textures made after this one aren't held to what is left of it.
+    for (auto& sampler : texture.samplers) {
+        assert(streamedBytes_ >= sampler.budgetSize);
+        streamedBytes_ -= sampler.budgetSize;
+        sampler.budgetSize = 0;
+        // A pending frame could still be indexing the slot, so it is only retired here.
+        if (sampler.bindlessIndex != Descriptor::Bindless::INVALID_INDEX) {
+            descriptorHandler().releaseBindless(Descriptor::Bindless::ARRAY::SAMPLER, sampler.bindlessIndex);
+            sampler.bindlessIndex = Descriptor::Bindless::INVALID_INDEX;
+        }
+    }
+    texture.destroy(shell().context());
+}
+
+void Texture::Handler::updatePriorities() {
+    for (auto& pTexture : pTextures_) pTexture->priority = 0.0f;
+
+    // Approximate the screen-space size of everything drawn with a texture by the angle its bounding sphere takes up.
+    const auto eye = uniformHandler().getMainCamera().getPosition();
+    for (const auto& pMesh : meshHandler().getTextureMeshes()) {
+        if (pMesh->getStatus() != STATUS::READY || !pMesh->getMaterial()->hasTexture()) continue;
+        auto& pTexture = pMesh->getMaterial()->getTexture();
+        for (uint32_t i = 0; i < pMesh->getInstanceCount(); i++) {
+            const auto bbmm = pMesh->getBoundingBoxMinMax(true, i);
+            const glm::vec3 min = {bbmm.xMin, bbmm.yMin, bbmm.zMin}, max = {bbmm.xMax, bbmm.yMax, bbmm.zMax};
+            const auto radius = glm::length(max - min) * 0.5f;
+            const auto distance = std::max(glm::distance((min + max) * 0.5f, eye), FLT_EPSILON);
+            pTexture->priority = std::max(pTexture->priority, radius / distance);
+        }
+    }
+}
+
+void Texture::Handler::stream() {
+    std::vector<std::shared_ptr<Texture::Base>> pStreaming;
+    for (auto& pTexture : pTextures_)
+        if (pTexture->status == STATUS::READY && !pTexture->isResident()) pStreaming.push_back(pTexture);
+    if (pStreaming.empty()) return;
+
+    updatePriorities();
+    std::stable_sort(pStreaming.begin(), pStreaming.end(),
+                     [](const auto& a, const auto& b) { return a->priority > b->priority; });
+
+    // Refine the largest textures on screen by one level each until the upload limit is hit.
+    vk::DeviceSize bytes = 0;
+    for (auto& pTexture : pStreaming) {
+        if (bytes >= STREAM_BYTES_PER_TICK) break;
+        pTexture->pLdgRes = loadingHandler().createLoadingResources();
+        for (auto& sampler : pTexture->samplers) {
+            if (sampler.isResident()) continue;
+            const auto level = sampler.residentMip - 1;
+            bytes += sampler.mipLevelData(level).size();
+            uploadMip(sampler, level, pTexture->pLdgRes);
+            sampler.residentMip = level;
+            if (sampler.isResident()) sampler.mipData.clear();
+        }
+        // Nothing to wait for. The refinement is recorded on the graphics queue ahead of the frames that sample it.
+        loadingHandler().loadSubmit(std::move(pTexture->pLdgRes));
+    }
+}
+
+void Texture::Handler::uploadMip(Sampler::Base& sampler, const uint32_t level,
+                                 std::unique_ptr<LoadingResource>& pLdgRes) {
+    const auto& ctx = shell().context();
+    const auto& data = sampler.mipLevelData(level);
+
+    BufferResource stgRes = {};
+    helpers::createBuffer(ctx.dev, *ctx.pMemAllocator, data.size(), vk::BufferUsageFlagBits::eTransferSrc,
+                          vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                          stgRes.buffer, stgRes.allocation, ctx.pAllocator, true);
+    std::memcpy(stgRes.allocation.pMappedData, data.data(), data.size());
+
+    /* The image is owned by the graphics queue once it is created, so refinements are recorded there instead of
+     *  handing it back and forth. Levels [0, level] only hold upsampled data at this point, and might still be read by
+     *  frames in flight.
+     */
+    vk::ImageMemoryBarrier barrier = {};
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = sampler.image;
+    barrier.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, level + 1, 0, sampler.imgCreateInfo.arrayLayers};
+    pLdgRes->graphicsCmd.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer,
+                                         {}, {}, {}, {barrier});
+
+    vk::BufferImageCopy region = {};
+    region.imageSubresource = {vk::ImageAspectFlagBits::eColor, level, 0, sampler.imgCreateInfo.arrayLayers};
+    region.imageExtent = sampler.mipExtent(level);
+    pLdgRes->graphicsCmd.copyBufferToImage(stgRes.buffer, sampler.image, vk::ImageLayout::eTransferDstOptimal,
+                                           {region});
+
+    fillFinerMips(pLdgRes->graphicsCmd, sampler, level, 1);
+
+    pLdgRes->stgResources.push_back(stgRes);
+}
+
+void Texture::Handler::fillFinerMips(const vk::CommandBuffer& cmd, const Sampler::Base& sampler, const uint32_t level,
+                                     const uint32_t levelCount) {
+    // Levels [0, level + levelCount) are expected to be in eTransferDstOptimal. "level" holds real data, and is
+    // blitted into every finer level. Everything ends up in eShaderReadOnlyOptimal.
+    assert(levelCount > 0 && level + levelCount <= sampler.imgCreateInfo.mipLevels);
+
+    vk::ImageMemoryBarrier barrier = {};
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = sampler.image;
+    barrier.subresourceRange = {vk::ImageAspectFlagBits::eColor, level, 1, 0, sampler.imgCreateInfo.arrayLayers};
+
+    std::vector<vk::ImageMemoryBarrier> finalBarriers;
+    if (level > 0) {
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                            {barrier});
+
+        const auto srcExtent = sampler.mipExtent(level);
+        for (uint32_t i = 0; i < level; i++) {
+            const auto dstExtent = sampler.mipExtent(i);
+            vk::ImageBlit blit = {};
+            blit.srcOffsets[1] = vk::Offset3D{static_cast<int32_t>(srcExtent.width),
+                                              static_cast<int32_t>(srcExtent.height), 1};
+            blit.srcSubresource = {vk::ImageAspectFlagBits::eColor, level, 0, sampler.imgCreateInfo.arrayLayers};
+            blit.dstOffsets[1] = vk::Offset3D{static_cast<int32_t>(dstExtent.width),
+                                              static_cast<int32_t>(dstExtent.height), 1};
+            blit.dstSubresource = {vk::ImageAspectFlagBits::eColor, i, 0, sampler.imgCreateInfo.arrayLayers};
+            cmd.blitImage(sampler.image, vk::ImageLayout::eTransferSrcOptimal, sampler.image,
+                          vk::ImageLayout::eTransferDstOptimal, 1, &blit, vk::Filter::eLinear);
+        }
+
+        // source
+        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        finalBarriers.push_back(barrier);
+        // finer
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = level;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        finalBarriers.push_back(barrier);
+        // coarser
+        barrier.subresourceRange.baseMipLevel = level + 1;
+        barrier.subresourceRange.levelCount = levelCount - 1;
+    } else {
+        barrier.subresourceRange.levelCount = levelCount;
+    }
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    if (barrier.subresourceRange.levelCount) finalBarriers.push_back(barrier);
+
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {},
+                        finalBarriers);
+}
+
 void Texture::Handler::attachSwapchain() {
     // Update swapchain dependent textures
     std::vector<std::string> updateList;
@@ -672,7 +940,7 @@ void Texture::Handler::detachSwapchain() {
         if (pTexture->usesSwapchain) {
             for (auto& sampler : pTexture->samplers) {
                 if (sampler.swpchnInfo.usesSwapchain()) {
-                    pTexture->destroy(shell().context());
+                    destroyTexture(*pTexture);
                 }
             }
         }
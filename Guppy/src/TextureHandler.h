@@ -23,7 +23,10 @@ class Handler : public Game::Handler {
     Handler(Game* pGame);
 
     void init() override;
-    inline void tick() override { update(); };
+    inline void tick() override {
+        update();
+        stream();
+    };
     inline void destroy() override { reset(); }
 
     // Note: pCreateInfo will be copied because of asynchronous loading, so all
@@ -37,6 +40,7 @@ class Handler : public Game::Handler {
     const std::shared_ptr<Texture::Base> getTexture(const std::string_view& name, const uint8_t frameIndex) const;
     const BufferView::Base* getBufferView(const std::string_view& id) const;
     inline uint32_t getCount() { return static_cast<uint32_t>(pTextures_.size()); }
+    inline bool isLoading() const { return !texFutures_.empty(); }
 
     // TODO: should these be public? Moved these for render to sampler.
     void createSampler(const Context& ctx, const Sampler::Base& sampler, Sampler::LayerResource& layerResource);
@@ -60,6 +64,7 @@ class Handler : public Game::Handler {
     void load(std::shared_ptr<Texture::Base>& pTexture, const CreateInfo* pCreateInfo);
 
     void createTexture(std::shared_ptr<Texture::Base> pTexture, bool stageResources = true);
+    void setReady(std::shared_ptr<Texture::Base> pTexture);
     void makeTexture(std::shared_ptr<Texture::Base>& pTexture, Sampler::Base& texSampler);
     void createImage(Sampler::Base& sampler, std::unique_ptr<LoadingResource>& pLdgRes);
     void createDepthImage(Sampler::Base& sampler, std::unique_ptr<LoadingResource>& pLdgRes);
@@ -67,11 +72,22 @@ class Handler : public Game::Handler {
     void createImageView(const Context& ctx, const Sampler::Base& sampler, const uint32_t baseArrayLayer,
                          const uint32_t layerCount, Sampler::LayerResource& layerResource);
 
+    // STREAMING
+    void applyBudget(Sampler::Base& sampler);
+    void destroyTexture(Texture::Base& texture);
+    void updatePriorities();
+    void stream();
+    void uploadMip(Sampler::Base& sampler, const uint32_t level, std::unique_ptr<LoadingResource>& pLdgRes);
+    void fillFinerMips(const vk::CommandBuffer& cmd, const Sampler::Base& sampler, const uint32_t level,
+                       const uint32_t levelCount);
+
     std::vector<std::shared_ptr<Texture::Base>> pTextures_;
     std::vector<std::future<std::shared_ptr<Texture::Base>>> texFutures_;
 
     std::vector<BufferView::Base> bufferViews_;
 
+    vk::DeviceSize streamedBytes_;
+
     // REGEX
     std::regex perFramebufferSuffix_;
 };
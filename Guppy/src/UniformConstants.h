@@ -32,6 +32,18 @@ extern const offsets DEFAULT_SINGLE_SET;
 extern const offsets DEFAULT_ALL_SET;
 extern const std::set<PASS> PASS_ALL_SET;
 
+/* Light arrays are declared in the shaders at a capacity instead of their exact length, so pipelines whose light
+ *  counts round up to the same capacity share one compiled shader. The exact length is passed as a specialization
+ *  constant that the shader uses as its loop bound, and the descriptors past it repeat the last light so every
+ *  element of the binding stays valid.
+ */
+constexpr uint32_t ARRAY_CAPACITY_STEP = 4;
+constexpr uint32_t GetArrayCapacity(const uint32_t count) {
+    return ((count + ARRAY_CAPACITY_STEP - 1) / ARRAY_CAPACITY_STEP) * ARRAY_CAPACITY_STEP;
+}
+// Descriptor types declared at a capacity, and the constant_id of their length in the shaders.
+extern const std::map<DESCRIPTOR, uint32_t> ARRAY_COUNT_CONSTANT_IDS;
+
 }  // namespace Uniform
 
 #endif  //! UNIFORM_CONSTANTS_H
\ No newline at end of file
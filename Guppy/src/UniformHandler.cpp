@@ -92,6 +92,8 @@ Uniform::Handler::Handler(Game* pGame)
           UniformDynamic::Ocean::SimulationDraw::Manager  //
           {"Ocean Simulation Draw Data", UNIFORM_DYNAMIC::OCEAN_DRAW, 6, true, "_UD_OCN_DRAW"},
       },
+      stream_{"Uniform Stream", STREAM_FRAME_SIZE,
+              vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer},
       activeCameraOffset_(BAD_OFFSET),
       mainCameraOffset_(BAD_OFFSET),
       debugCameraOffset_(BAD_OFFSET),
@@ -170,6 +172,15 @@ void Uniform::Handler::init() {
     assert(count == managers_.size() + managersDynamic_.size());
     // clang-format on
 
+    stream_.init(shell().context());
+    {
+        // The descriptor covers one copy at offset 0 of the stream. Draws pass the offset of their copy when binding.
+        Buffer::Info info = {};
+        info.bufferInfo = stream_.getDescriptorInfo(sizeof(UniformDynamic::Cdlod::Grid::DATA));
+        info.count = 1;
+        pCdlodGrid_ = std::make_unique<UniformDynamic::Cdlod::Grid::Base>(std::move(info));
+    }
+
     createCameras();
     createLights();
     createMiscellaneous();
@@ -203,12 +214,25 @@ void Uniform::Handler::reset() {
     ocnSimDrawMgr().destroy(shell().context());   ++count;
     assert(count == managers_.size() + managersDynamic_.size());
     // clang-format on
+
+    pCdlodGrid_.reset();
+    stream_.destroy(shell().context());
+}
+
+void Uniform::Handler::beginFrame(const uint32_t frameIndex) {
+    // The frame fence for "frameIndex" has been waited on, so its part of the stream can be reused.
+    stream_.beginFrame(frameIndex);
 }
 
 void Uniform::Handler::frame() {
     const auto frameIndex = passHandler().renderPassMgr().getFrameIndex();
     const auto& playerInfo = shell().inputHandler().getInfo().players[0];
 
+    // Collect the per-frame updates below, and copy them all at once at the end.
+    for (auto& manager : managers_) std::visit(BeginBatch{}, manager);
+    for (auto& manager : managers_) std::visit(UpdateFrame{shell().context().dev, frameIndex}, manager);
+    for (auto& manager : managersDynamic_) std::visit(UpdateFrame{shell().context().dev, frameIndex}, manager);
+
     // ACTIVE CAMERA
     auto& camera = getActiveCamera();
     float movementFactor = 10.0f;
@@ -310,6 +334,8 @@ void Uniform::Handler::frame() {
             }
         }
     }
+
+    for (auto& manager : managers_) std::visit(EndBatch{}, manager);
 }
 
 void Uniform::Handler::createCameras() {
@@ -627,13 +653,14 @@ void Uniform::Handler::moveToDebugCamera() {
 }
 
 uint32_t Uniform::Handler::getDescriptorCount(const DESCRIPTOR& descType, const Uniform::offsets& offsets) {
-    return getDescriptorCount(getItems(descType), offsets);
+    return getDescriptorCount(descType, getItems(descType), offsets);
 }
 
-uint32_t Uniform::Handler::getDescriptorCount(const std::vector<ItemPointer<Descriptor::Base>>& pItems,
+uint32_t Uniform::Handler::getDescriptorCount(const DESCRIPTOR& descType,
+                                              const std::vector<ItemPointer<Descriptor::Base>>& pItems,
                                               const Uniform::offsets& offsets) const {
-    auto resolvedOffsets = getBindingOffsets(pItems, offsets);
-    return static_cast<uint32_t>(resolvedOffsets.size());
+    auto count = static_cast<uint32_t>(getBindingOffsets(pItems, offsets).size());
+    return ARRAY_COUNT_CONSTANT_IDS.count(descType) ? GetArrayCapacity(count) : count;
 }
 
 std::set<uint32_t> Uniform::Handler::getBindingOffsets(const std::vector<ItemPointer<Descriptor::Base>>& pItems,
@@ -665,8 +692,8 @@ void Uniform::Handler::getWriteInfos(const DESCRIPTOR& descType, const Uniform::
     // Check for enough uniforms for highest offset
     assert(*std::prev(resolvedOffsets.end()) < pItems.size());
 
-    setResInfo.descCount = static_cast<uint32_t>(resolvedOffsets.size());
-    setResInfo.bufferInfos.resize(resolvedOffsets.size() * setResInfo.uniqueDataSets);
+    setResInfo.descCount = getDescriptorCount(descType, pItems, offsets);
+    setResInfo.bufferInfos.resize(setResInfo.descCount * setResInfo.uniqueDataSets);
 
     // Set the buffer infos
     uint32_t i = 0;
@@ -675,6 +702,25 @@ void Uniform::Handler::getWriteInfos(const DESCRIPTOR& descType, const Uniform::
         if (sMsg.size()) shell().log(Shell::LogPriority::LOG_WARN, sMsg.c_str());
         pItems[offset]->setDescriptorInfo(setResInfo, i++);
     }
+    // Fill the rest of an array's capacity with the last item. The shader never reads past the specialized count.
+    while (i < setResInfo.descCount) pItems[*resolvedOffsets.rbegin()]->setDescriptorInfo(setResInfo, i++);
+}
+
+void Uniform::Handler::getArrayCountConstants(const Descriptor::Set::textReplaceTuples& replaceTuples,
+                                              Pipeline::specializationConstants& constants) const {
+    for (const auto& manager : managers_) {
+        const auto& descType = std::visit(GetType{}, manager);
+        auto itConstantId = ARRAY_COUNT_CONSTANT_IDS.find(descType);
+        if (itConstantId == ARRAY_COUNT_CONSTANT_IDS.end()) continue;
+        for (const auto& tuple : replaceTuples) {
+            auto search = std::get<2>(tuple).map().find(descType);
+            if (search == std::get<2>(tuple).map().end()) continue;
+            const auto& pItems = std::visit(GetItems{}, manager);
+            auto count = static_cast<uint32_t>(getBindingOffsets(pItems, search->second).size());
+            constants.push_back({itConstantId->second, count});
+            break;
+        }
+    }
 }
 
 void Uniform::Handler::textReplaceShader(const Descriptor::Set::textReplaceTuples& replaceTuples,
@@ -693,7 +739,7 @@ void Uniform::Handler::textReplaceShader(const Descriptor::Set::textReplaceTuple
                     for (const auto& tuple : replaceTuples) {
                         auto search = std::get<2>(tuple).map().find(descType);
                         if (search != std::get<2>(tuple).map().end()) {
-                            itemCount = static_cast<int>(getDescriptorCount(pItems, search->second));
+                            itemCount = static_cast<int>(getDescriptorCount(descType, pItems, search->second));
                         }
                     }
                     if (itemCount == -1) {
@@ -23,6 +23,7 @@
 #include "Cdlod.h"
 #include "ConstantsAll.h"
 #include "Deferred.h"
+#include "BufferRing.h"
 #include "Descriptor.h"
 #include "DescriptorManager.h"
 #include "Game.h"
@@ -41,6 +42,9 @@
 
 namespace Uniform {
 
+// Size of each frame's region in the transient uniform stream.
+constexpr vk::DeviceSize STREAM_FRAME_SIZE = 256 * 1024;
+
 // MANAGER
 
 template <class TBase>
@@ -145,6 +149,9 @@ class Handler : public Game::Handler {
         UniformDynamic::Ocean::SimulationDraw::Manager       //
         >;
     std::array<ManagerDynamic, 3> managersDynamic_;
+    // TRANSIENT
+    Buffer::Ring stream_;
+    std::unique_ptr<UniformDynamic::Cdlod::Grid::Base> pCdlodGrid_;
 
     std::vector<std::unique_ptr<Descriptor::Base>>& getItems(const DESCRIPTOR& type);
 
@@ -190,6 +197,9 @@ class Handler : public Game::Handler {
     // SHADER
     void textReplaceShader(const Descriptor::Set::textReplaceTuples& replaceTuples, const std::string_view& fileName,
                            std::string& text) const;
+    // Exact lengths of the arrays declared at a capacity (see Uniform::ARRAY_COUNT_CONSTANT_IDS).
+    void getArrayCountConstants(const Descriptor::Set::textReplaceTuples& replaceTuples,
+                                Pipeline::specializationConstants& constants) const;
 
     template <typename T>
     inline T& getUniform(const DESCRIPTOR& type, const index& index) {
@@ -210,10 +220,20 @@ class Handler : public Game::Handler {
     // DESCRIPTOR
     inline const auto& getOffsetsMgr() const { return offsetsManager_; }
 
+    /* TRANSIENT
+     *  Per-draw data that only lives for a frame can be written here instead of creating a long lived item in one of
+     *  the managers (or squeezing it into push constants). Bind a dynamic descriptor with "stream().getDescriptorInfo"
+     *  and pass "stream().getDynamicOffset(range)" when binding the set. Only valid for work submitted with the
+     *  render pass manager's frame fence. The CDLOD grid data is streamed through "getCdlodGrid".
+     */
+    inline auto& stream() { return stream_; }
+    inline auto& getCdlodGrid() { return *pCdlodGrid_; }
+    void beginFrame(const uint32_t frameIndex);
+
    private:
     void reset() override;
 
-    uint32_t getDescriptorCount(const std::vector<ItemPointer<Descriptor::Base>>& pItems,
+    uint32_t getDescriptorCount(const DESCRIPTOR& descType, const std::vector<ItemPointer<Descriptor::Base>>& pItems,
                                 const Uniform::offsets& offsets) const;
     std::set<uint32_t> getBindingOffsets(const std::vector<ItemPointer<Descriptor::Base>>& pItems,
                                          const Uniform::offsets& offsets) const;
@@ -247,6 +267,29 @@ class Handler : public Game::Handler {
         }
     };
 
+    struct BeginBatch {
+        template <typename TManager>
+        void operator()(TManager& manager) const {
+            manager.beginBatch();
+        }
+    };
+
+    struct UpdateFrame {
+        const vk::Device& dev;
+        const uint32_t frameIndex;
+        template <typename TManager>
+        void operator()(TManager& manager) const {
+            manager.updateFrame(dev, frameIndex);
+        }
+    };
+
+    struct EndBatch {
+        template <typename TManager>
+        void operator()(TManager& manager) const {
+            manager.endBatch();
+        }
+    };
+
     index activeCameraOffset_ = 0;
     index mainCameraOffset_ = 0;
     index debugCameraOffset_ = 0;
@@ -13,6 +13,12 @@ const offsets DEFAULT_SINGLE_SET = {0};
 const offsets DEFAULT_ALL_SET = {UINT32_MAX};
 const std::set<PASS> PASS_ALL_SET = {PASS{RENDER_PASS::ALL_ENUM}};
 
+const std::map<DESCRIPTOR, uint32_t> ARRAY_COUNT_CONSTANT_IDS = {
+    {UNIFORM::LIGHT_POSITIONAL_DEFAULT, 110},
+    {UNIFORM::LIGHT_SPOT_DEFAULT, 111},
+    {UNIFORM::LIGHT_POSITIONAL_PBR, 112},
+};
+
 // DEFAULT MAP
 const std::map<DESCRIPTOR, offsets> DEFAULT_OFFSETS_MAP = {
     // UNIFORM
@@ -7,6 +7,7 @@
 #define VERTEX_H
 
 #include <array>
+#include <cmath>
 #include <glm/glm.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
@@ -60,6 +61,21 @@ class Complete {
              const glm::vec3 &t, const glm::vec3 &b)
         : position(p), normal(n), smoothingGroupId(sgi), color(c), texCoord(tc), tangent(t), binormal(b){};
 
+    /* The hashers below hash positions (and normals) snapped to a grid much coarser than the epsilon the equality
+     *  predicates use, so vertices that weld hash the same unless they straddle a cell boundary. Used by Vertex::Map.
+     */
+    static constexpr float HASH_GRID_SCALE = 1.0e4f;
+    static inline uint64_t hashGrid(const glm::vec3 &v, uint64_t h = 0) {
+        for (glm::length_t i = 0; i < 3; i++) {
+            h ^= static_cast<uint64_t>(static_cast<int64_t>(std::floor(v[i] * HASH_GRID_SCALE)));
+            // splitmix64 finalizer
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+            h ^= h >> 31;
+        }
+        return h;
+    }
+
     struct hash_vertex_complete_smoothing {
         bool operator()(const Vertex::Complete &a, const Vertex::Complete &b) const {
             return                                                                   //
@@ -67,7 +83,7 @@ class Complete {
                 a.smoothingGroupId == b.smoothingGroupId;
         }
         size_t operator()(const Vertex::Complete &vertex) const {
-            return ((std::hash<glm::vec3>()(vertex.position) ^ (std::hash<int>()(vertex.smoothingGroupId) << 1)) >> 1);
+            return static_cast<size_t>(hashGrid(vertex.position, vertex.smoothingGroupId));
         }
     };
 
@@ -78,7 +94,7 @@ class Complete {
                 glm::all(glm::epsilonEqual(a.normal, b.normal, FLT_EPSILON));
         }
         size_t operator()(const Vertex::Complete &vertex) const {
-            return ((std::hash<glm::vec3>()(vertex.position) ^ (std::hash<glm::vec3>()(vertex.normal) << 1)) >> 1);
+            return static_cast<size_t>(hashGrid(vertex.normal, hashGrid(vertex.position)));
         }
     };
 
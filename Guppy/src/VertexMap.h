@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+#ifndef VERTEX_MAP_H
+#define VERTEX_MAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <Common/Types.h>
+
+#include "Vertex.h"
+
+namespace Vertex {
+
+/* Open addressing replacement for the unordered_multimap that Face::indexVertices welds vertices with. "TWeld" is one
+ *  of the Vertex::Complete hashers, which provide both the hash and the equality predicate. Every distinct vertex is a
+ *  key in flat storage, and the (mesh offset, vertex index) values for a key are chained through another flat array,
+ *  so nothing is allocated per insert once the map has been reserved. Slots are probed linearly, and the table is kept
+ *  at most half full.
+ */
+template <typename TWeld>
+class Map {
+   public:
+    using Weld = TWeld;
+    using Value = std::pair<size_t, IndexBufferType>;  // mesh offset, vertex index
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    // Every face adds at most 3 vertices, so "vertexCount" can just be the face count * 3.
+    void reserve(const size_t vertexCount) {
+        keys_.reserve(vertexCount);
+        values_.reserve(vertexCount);
+        size_t capacity = 16;
+        while (capacity < vertexCount * 2) capacity *= 2;
+        if (capacity > slots_.size()) rehash(capacity);
+    }
+
+    void clear() {
+        keys_.clear();
+        values_.clear();
+        std::fill(slots_.begin(), slots_.end(), NOT_FOUND);
+    }
+
+    inline bool empty() const { return keys_.empty(); }
+
+    // Returns the key for "vertex", or NOT_FOUND.
+    uint32_t find(const Complete &vertex) const {
+        if (slots_.empty()) return NOT_FOUND;
+        const auto hash = TWeld()(vertex);
+        for (size_t slot = hash & (slots_.size() - 1);; slot = (slot + 1) & (slots_.size() - 1)) {
+            const auto key = slots_[slot];
+            if (key == NOT_FOUND) return NOT_FOUND;
+            if (keys_[key].hash == hash && TWeld()(keys_[key].vertex, vertex)) return key;
+        }
+    }
+
+    // Calls "func(value)" for every value of "key" in the order they were inserted.
+    template <typename TFunc>
+    void forEach(const uint32_t key, TFunc &&func) const {
+        for (auto value = keys_[key].head; value != NOT_FOUND; value = values_[value].next) func(values_[value].value);
+    }
+
+    void insert(const Complete &vertex, const Value &value) {
+        auto key = find(vertex);
+        if (key == NOT_FOUND) {
+            if ((keys_.size() + 1) * 2 > slots_.size()) rehash(slots_.empty() ? 16 : slots_.size() * 2);
+            key = static_cast<uint32_t>(keys_.size());
+            keys_.push_back({vertex, TWeld()(vertex), NOT_FOUND, NOT_FOUND});
+            place(key);
+        }
+
+        const auto index = static_cast<uint32_t>(values_.size());
+        values_.push_back({value, NOT_FOUND});
+        auto &k = keys_[key];
+        if (k.tail == NOT_FOUND)
+            k.head = index;
+        else
+            values_[k.tail].next = index;
+        k.tail = index;
+    }
+
+   private:
+    struct Key {
+        Complete vertex;
+        size_t hash;
+        uint32_t head, tail;
+    };
+    struct Link {
+        Value value;
+        uint32_t next;
+    };
+
+    void place(const uint32_t key) {
+        auto slot = keys_[key].hash & (slots_.size() - 1);
+        while (slots_[slot] != NOT_FOUND) slot = (slot + 1) & (slots_.size() - 1);
+        slots_[slot] = key;
+    }
+
+    void rehash(const size_t capacity) {
+        slots_.assign(capacity, NOT_FOUND);
+        for (uint32_t key = 0; key < keys_.size(); key++) place(key);
+    }
+
+    std::vector<Key> keys_;
+    std::vector<Link> values_;
+    std::vector<uint32_t> slots_;  // Power of two.
+};
+
+}  // namespace Vertex
+
+#endif  // !VERTEX_MAP_H
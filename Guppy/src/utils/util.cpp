@@ -52,8 +52,10 @@ void init_glslang() {}
 
 void finalize_glslang() {}
 
+std::string GLSLtoSPVVersion() { return "MoltenVKGLSLToSPIRVConverter"; }
+
 bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *> pShaders,
-               std::vector<unsigned int> &spirv) {
+               std::vector<unsigned int> &spirv, std::string *pLog) {
     MVKGLSLConversionShaderStage shaderStage;
     switch (shaderType) {
         case VK_SHADER_STAGE_VERTEX_BIT:
@@ -88,6 +90,7 @@ bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *>
     if (wasConverted) {
         spirv = glslConverter.getSPIRV();
     } else {
+        if (pLog != nullptr) *pLog += glslConverter.getResultLog();
         // std::cout << std::endl << glslConverter.getResultLog() << std::endl;
     }
     return wasConverted;
@@ -245,6 +248,17 @@ void finalize_glslang() {
 #endif
 }
 
+std::string GLSLtoSPVVersion() {
+#ifndef __ANDROID__
+    std::string spirvVersion;
+    glslang::GetSpirvVersion(spirvVersion);
+    return std::string("glslang ") + glslang::GetGlslVersionString() + " " + spirvVersion + " " +
+           std::to_string(glslang::GetSpirvGeneratorVersion());
+#else
+    return "shaderc";
+#endif
+}
+
 #ifdef __ANDROID__
 // Android specific helper functions for shaderc.
 struct shader_type_mapping {
@@ -275,7 +289,15 @@ shaderc_shader_kind MapShadercType(VkShaderStageFlagBits vkShader) {
 // Return value of false means an error was encountered.
 //
 bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *> pShaderStrings,
-               std::vector<unsigned int> &spirv) {
+               std::vector<unsigned int> &spirv, std::string *pLog) {
+    auto log = [pLog](const char *pMessage) {
+        if (pLog != nullptr) {
+            *pLog += pMessage;
+            *pLog += "\n";
+        } else {
+            puts(pMessage);
+        }
+    };
 #ifndef __ANDROID__
     EShLanguage stage = FindLanguage(shaderType);
 
@@ -291,8 +313,8 @@ bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *>
         shaders.back()->setStrings(&s, 1);
 
         if (!shaders.back()->parse(&DefaultTBuiltInResource, 100, false, messages)) {
-            puts(shaders.back()->getInfoLog());
-            puts(shaders.back()->getInfoDebugLog());
+            log(shaders.back()->getInfoLog());
+            log(shaders.back()->getInfoDebugLog());
             return false;  // something didn't work
         }
         program.addShader(shaders.back().get());
@@ -303,8 +325,8 @@ bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *>
     //
 
     if (!program.link(messages)) {
-        puts(program.getInfoLog());
-        puts(program.getInfoDebugLog());
+        log(program.getInfoLog());
+        log(program.getInfoDebugLog());
         fflush(stdout);
         return false;
     }
@@ -317,6 +339,7 @@ bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *>
         compiler.CompileGlslToSpv(pshader, strlen(pshader), MapShadercType(shader_type), "shader");
     if (module.GetCompilationStatus() != shaderc_compilation_status_success) {
         LOGE("Error: Id=%d, Msg=%s", module.GetCompilationStatus(), module.GetErrorMessage().c_str());
+        log(module.GetErrorMessage().c_str());
         return false;
     }
     spirv.assign(module.cbegin(), module.cend());
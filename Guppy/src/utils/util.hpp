@@ -23,6 +23,7 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <string>
 #include <vector>
 
 #ifdef _WIN32
@@ -35,8 +36,13 @@
 
 #include <vulkan/vulkan.h>
 
-bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *> pShaders, std::vector<unsigned int> &spirv);
+// Safe to call from more than one thread at a time between init_glslang and finalize_glslang. If "pLog" is not null the
+//  compiler output goes there instead of stdout.
+bool GLSLtoSPV(const VkShaderStageFlagBits shaderType, std::vector<const char *> pShaders,
+               std::vector<unsigned int> &spirv, std::string *pLog = nullptr);
 void init_glslang();
 void finalize_glslang();
+// Identifies the compiler GLSLtoSPV uses, so that the SPIR-V it made can be cached.
+std::string GLSLtoSPVVersion();
 
 #endif  // !UTIL_H
@@ -6,8 +6,6 @@
 #version 450
 
 #define _DS_OCEAN 0
-#define _LS_X 1
-#define _LS_Y 1
 
 #define complexMul(a, b) vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x)
 
@@ -29,7 +27,7 @@ layout(set=_DS_OCEAN, binding=2, rgba32f) uniform image2DArray imgDisp;
 layout(set=_DS_OCEAN, binding=3) uniform isamplerBuffer bitRevOffsetsN;
 layout(set=_DS_OCEAN, binding=4) uniform isamplerBuffer bitRevOffsetsM;
 // IN
-layout(local_size_x=_LS_X, local_size_y=_LS_Y) in;
+layout(local_size_x_id=100, local_size_y_id=101) in;  // Pipeline::LOCAL_SIZE_*_CONSTANT_ID
 
 const int LAYER_WAVE            = 0;
 const int LAYER_FOURIER         = 1;
@@ -6,7 +6,6 @@
 #version 450
 
 #define _DS_OCEAN 0
-#define _LS_X 1
 
 #define complexMul(a, b) vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x)
 
@@ -26,7 +25,7 @@ layout(set=_DS_OCEAN, binding=0) uniform SimulationDispatch {
 layout(set=_DS_OCEAN, binding=2, rgba32f) uniform image2DArray imgDisp;
 layout(set=_DS_OCEAN, binding=5) uniform samplerBuffer sampTwiddle;
 // IN
-layout(local_size_x=_LS_X) in;
+layout(local_size_x_id=100) in;  // Pipeline::LOCAL_SIZE_X_CONSTANT_ID
 
 const float PI = 3.14159265358979323846;
 const int LAYER_HEIGHT          = 0;
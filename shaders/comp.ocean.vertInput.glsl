@@ -6,8 +6,6 @@
 #version 450
 
 #define _DS_OCEAN 0
-#define _LS_X 1
-#define _LS_Y 1
 
 // BINDINGS
 layout(set=_DS_OCEAN, binding=0) uniform SimulationDraw {
@@ -21,7 +19,7 @@ layout(set=_DS_OCEAN, binding=0) uniform SimulationDraw {
 layout(set=_DS_OCEAN, binding=2, rgba32f) uniform image2DArray imgDisp;
 layout(set=_DS_OCEAN, binding=6, rgba32f) uniform writeonly image2DArray imgVertInput;
 // IN
-layout(local_size_x=_LS_X, local_size_y=_LS_Y) in;
+layout(local_size_x_id=100, local_size_y_id=101) in;  // Pipeline::LOCAL_SIZE_*_CONSTANT_ID
 
 // Dispersion relation image layers
 const int DISP_LAYER_HEIGHT          = 0;
@@ -31,14 +29,16 @@ const int DISP_LAYER_DIFFERENTIAL    = 2;
 const int INPUT_LAYER_POSITION       = 0;
 const int INPUT_LAYER_NORMAL         = 1;
 
-#define DEBUG 0
+// Writes a flat grid instead. A specialization constant, so turning it on does not need another compile.
+layout(constant_id=0) const bool DEBUG = false;
 
 void main() {
-#if DEBUG
-    const ivec2 pix = ivec2(gl_GlobalInvocationID.xy);
-    imageStore(imgVertInput, ivec3(pix, INPUT_LAYER_POSITION), vec4(pix.x, 0, pix.y, 1));
-#else
     const ivec2 pix = ivec2(gl_GlobalInvocationID.xy);
+    if (DEBUG) {
+        imageStore(imgVertInput, ivec3(pix, INPUT_LAYER_POSITION), vec4(pix.x, 0, pix.y, 1));
+        return;
+    }
+
     const bool flipSign = ((pix.x + pix.y) & 1) > 0;
 
     // Differential
@@ -61,5 +61,4 @@ void main() {
 
     imageStore(imgVertInput, ivec3(pix, INPUT_LAYER_POSITION), vec4(position, 1));
     imageStore(imgVertInput, ivec3(pix, INPUT_LAYER_NORMAL),   vec4(normal, 0));
-#endif
 }
\ No newline at end of file
@@ -48,6 +48,8 @@ layout(set=_DS_UNI_DFR_COMB, binding=1) uniform LightDefaultPositional {
     vec3 L;         // Diffuse and specular light intensity
     // rem 4
 } lgtPos[_U_LGT_DEF_POS];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=110) const int LGT_DEF_POS_COUNT = _U_LGT_DEF_POS;
 
 vec3 blinnPhongPositional(
     vec3 pos,
@@ -61,7 +63,7 @@ vec3 blinnPhongPositional(
 
     vec3 color = vec3(0.0);
 
-    for (int i = 0; i < lgtPos.length(); i++) {
+    for (int i = 0; i < LGT_DEF_POS_COUNT; i++) {
         if ((lgtPos[i].flags & LIGHT_SHOW) > 0) {
 
             vec3 Ka = pow((lgtPos[i].La * amb), vec3(i+1));
@@ -99,6 +101,8 @@ layout(set=_DS_UNI_DFR_COMB, binding=2) uniform LightDefaultSpot {
     vec3 direction;
     // rem 4
 } lgtSpot[_U_LGT_DEF_SPT];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=111) const int LGT_DEF_SPT_COUNT = _U_LGT_DEF_SPT;
 
 vec3 blinnPhongSpot(
     vec3 pos,
@@ -112,7 +116,7 @@ vec3 blinnPhongSpot(
 
     vec3 color = vec3(0.0);
 
-    for (int i = 0; i < lgtSpot.length(); i++) {
+    for (int i = 0; i < LGT_DEF_SPT_COUNT; i++) {
         if ((lgtSpot[i].flags & LIGHT_SHOW) > 0) {
 
             vec3 s = normalize(lgtSpot[i].position - pos);
@@ -196,7 +200,7 @@ vec3 blinnPhongPositionalShadow(
 
     vec3 color = vec3(0.0);
 
-    for (int i = 0; i < lgtPos.length(); i++) {
+    for (int i = 0; i < LGT_DEF_POS_COUNT; i++) {
         if ((lgtPos[i].flags & LIGHT_SHOW) > 0) {
             if (i > 0) {
                 // color += vec3(1, 0, 0);
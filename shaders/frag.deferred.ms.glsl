@@ -104,6 +104,8 @@ layout(set=_DS_UNI_DFR_COMB, binding=3) uniform LightDefaultPositional {
     vec3 L;         // Diffuse and specular light intensity
     // rem 4
 } lgtPos[_U_LGT_DEF_POS];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=110) const int LGT_DEF_POS_COUNT = _U_LGT_DEF_POS;
 vec3 blinnPhongPositional(
     vec3 pos,
     vec3 norm,
@@ -116,7 +118,7 @@ vec3 blinnPhongPositional(
 
     vec3 color = vec3(0.0);
 
-    for (int i = 0; i < lgtPos.length(); i++) {
+    for (int i = 0; i < LGT_DEF_POS_COUNT; i++) {
         if ((lgtPos[i].flags & LIGHT_SHOW) > 0) {
 
             vec3 Ka = pow((lgtPos[i].La * amb), vec3(i+1));
@@ -27,7 +27,8 @@ layout(set=_DS_CDLOD, binding=0) uniform CdlodQuadTree {
 
 // layout(set=_DS_CDLOD, binding=3, rgba32f) uniform readonly image2DArray heightMap;
 
-layout(push_constant) uniform PushBlock {
+// Streamed per draw. Each draw binds the set with the dynamic offset of its copy.
+layout(set=_DS_CDLOD, binding=1) uniform CdlodGrid {
     vec4 data0;  // gridDim:         .x (dimension), .y (dimension/2), .z (2/dimension)
                  //                  .w (LODLevel)
     vec4 data1;  // morph constants: .x (start), .y (1/(end-start)), .z (end/(end-start))
@@ -35,11 +36,11 @@ layout(push_constant) uniform PushBlock {
     vec4 data2;  // quadOffset:      .x (aabb.minX), .y (aabb.minY)
                  // quadScale:       .z (aabb.sizeX), .w (aabb.sizeY)
     vec4 data3;  // dbg camera:      .x (wpos.x), .y (wpos.y), .z (wpos.z)
-} pc;
+} grid;
 
-#define QUAD_OFFSET_V4 vec4(pc.data2.x, pc.data2.y, pc.data1.w, 0.0)
+#define QUAD_OFFSET_V4 vec4(grid.data2.x, grid.data2.y, grid.data1.w, 0.0)
 // I believe the zw components are always multiplied by 0 but I'll just make it the same as it was. CH
-#define QUAD_SCALE_V4  vec4(pc.data2.z, pc.data2.w, pc.data0.w, 0.0)
+#define QUAD_SCALE_V4  vec4(grid.data2.z, grid.data2.w, grid.data0.w, 0.0)
 
 // IN
 layout(location=0) in vec3 inPosition;
@@ -92,7 +93,7 @@ vec4 getBaseVertexPos( vec4 inPos )
 vec2 morphVertex( vec4 inPos, vec2 vertex, float morphLerpK )
 {
     // vec2 fracPart = (frac( inPos.xy * vec2(g_gridDim.y, g_gridDim.y) ) * vec2(g_gridDim.z, g_gridDim.z) ) * g_quadScale.xy;
-    vec2 fracPart = (fract( inPos.xy * vec2(pc.data0.y, pc.data0.y) ) * vec2(pc.data0.z, pc.data0.z) ) * pc.data2.zw;
+    vec2 fracPart = (fract( inPos.xy * vec2(grid.data0.y, grid.data0.y) ) * vec2(grid.data0.z, grid.data0.z) ) * grid.data2.zw;
     return vertex.xy - fracPart * morphLerpK;
 }
 
@@ -153,7 +154,7 @@ void ProcessCDLODVertex(
     vec4 vertex     = getBaseVertexPos( inPos );
 
     // const float LODLevel = g_quadScale.z;
-    const float LODLevel = pc.data0.w;
+    const float LODLevel = grid.data0.w;
 
     // could use mipmaps for performance reasons but that will need some additional shader logic for morphing between levels, code
     // changes and making sure that hardware supports it, so I'll leave that for some other time
@@ -177,12 +178,12 @@ void ProcessCDLODVertex(
     outUnmorphedWorldPos.w = 1;
 
     // swizzle to convert to z-up left-handed coordinate system
-    vec3 camPos       = (pc.data3.w == 1.0) ? pc.data3.xzy : camera.worldPosition.xzy;
+    vec3 camPos       = (grid.data3.w == 1.0) ? grid.data3.xzy : camera.worldPosition.xzy;
     // float eyeDist     = distance( vertex, g_cameraPos );
     float eyeDist     = distance( vertex, vec4(camPos, 1.0) );
 
     // float morphLerpK  = 1.0f - clamp( g_morphConsts.z - eyeDist * g_morphConsts.w, 0.0, 1.0 );
-    float morphLerpK  = 1.0f - clamp( pc.data1.z - eyeDist * pc.data1.y, 0.0, 1.0 );
+    float morphLerpK  = 1.0f - clamp( grid.data1.z - eyeDist * grid.data1.y, 0.0, 1.0 );
 
     vertex.xy         = morphVertex( inPos, vertex.xy, morphLerpK );
 
@@ -6,6 +6,11 @@
 #version 450
 
 #define _DS_UNI_DEF 0
+#define _DS_BINDLESS -1
+
+#if _DS_BINDLESS > -1
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
 
 // FLAGS
 const uint PER_MATERIAL_COLOR       = 0x00000001u;
@@ -22,6 +27,33 @@ const uint IS_MESH                  = 0x00010000u;
 //  TYPE MASK
 const uint TEX_HEIGHT           = 0x000F0000u;
 
+#if _DS_BINDLESS > -1
+// Descriptor::Bindless::PushConstant
+layout(push_constant) uniform BindlessPushConstant {
+    uint samplerIndex;
+    uint bufferIndex;
+    uint item;
+    uint padding;
+} bindless;
+
+// Same layout as the uniform block below (nothing in it packs differently for std430).
+layout(set=_DS_BINDLESS, binding=1) readonly buffer MaterialDefault {
+    vec3 color;
+    float opacity;
+    uint flags;
+    uint texFlags;
+    float xRepeat;
+    float yRepeat;
+    vec3 Ka;
+    float shininess;
+    vec3 Ks;
+    float eta;
+    float reflectionFactor;
+} materials[];
+#define material materials[bindless.bufferIndex]
+
+uint getBindlessSamplerIndex() { return bindless.samplerIndex; }
+#else
 layout(set=_DS_UNI_DEF, binding=1) uniform MaterialDefault {
     vec3 color;             // Diffuse color for dielectrics, f0 for metallic
     float opacity;          // Overall opacity
@@ -39,6 +71,7 @@ layout(set=_DS_UNI_DEF, binding=1) uniform MaterialDefault {
     // 4
     float reflectionFactor; // Percentage of reflected light
 } material;
+#endif
 
 vec3  getMaterialAmbient()          { return material.Ka; }
 vec3  getMaterialColor()            { return material.color; }
@@ -31,6 +31,8 @@ layout(set=_DS_UNI_PBR, binding=2) uniform LightPBRPositional {
     vec3 L;         // Diffuse and specular light intensity
     // rem 4
 } lgtPos[_U_LGT_PBR_POS];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=112) const int LGT_PBR_POS_COUNT = _U_LGT_PBR_POS;
 #endif
 
 // IN
@@ -135,7 +137,7 @@ vec3 pbrShade() {
     v = normalize(transform(vec3(0.0) - inPosition));
 
 #if _U_LGT_PBR_POS
-    for (int i = 0; i < lgtPos.length(); i++) {
+    for (int i = 0; i < LGT_PBR_POS_COUNT; i++) {
         // if (i != 1) continue;
         sum += microfacetModel(i);
     }
@@ -6,6 +6,11 @@
 #version 450
 
 #define _DS_SMP_DEF 0
+#define _DS_BINDLESS -1
+
+#if _DS_BINDLESS > -1
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
 
 // DECLARATIONS
 vec3 getMaterialColor();
@@ -16,6 +21,9 @@ float getMaterialShininess();
 float getMaterialXRepeat();
 float getMaterialYRepeat();
 vec3 transform(vec3 v);
+#if _DS_BINDLESS > -1
+uint getBindlessSamplerIndex();
+#endif
 
 // TEXTURE FLAGS
 //  TYPE MASK
@@ -30,7 +38,12 @@ const uint TEX_CH_2             = 0x02u;
 const uint TEX_CH_3             = 0x04u;
 const uint TEX_CH_4             = 0x08u;
 
+#if _DS_BINDLESS > -1
+layout(set=_DS_BINDLESS, binding=0) uniform sampler2DArray bindlessSamplers[];
+#define sampCh4 bindlessSamplers[getBindlessSamplerIndex()]
+#else
 layout(set=_DS_SMP_DEF, binding=0) uniform sampler2DArray sampCh4;
+#endif
 // layout(set=_DS_SMP_DEF, binding=1) uniform sampler2DArray sampCh1;
 // layout(set=_DS_SMP_DEF, binding=2) uniform sampler2DArray sampCh2;
 // layout(set=_DS_SMP_DEF, binding=3) uniform sampler2DArray sampCh3;
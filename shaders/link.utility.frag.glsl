@@ -76,6 +76,8 @@ layout(set=_DS_UNI_DEF, binding=3) uniform LightDefaultPositional {
     vec3 L;         // Diffuse and specular light intensity
     // rem 4
 } lgtPos[_U_LGT_DEF_POS];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=110) const int LGT_DEF_POS_COUNT = _U_LGT_DEF_POS;
 #endif
 
 #if _U_LGT_DEF_SPT
@@ -92,6 +94,8 @@ layout(set=_DS_UNI_DEF, binding=4) uniform LightDefaultSpot {
     vec3 direction;
     // rem 4
 } lgtSpot[_U_LGT_DEF_SPT];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=111) const int LGT_DEF_SPT_COUNT = _U_LGT_DEF_SPT;
 #endif
 
 #if _DS_PRJ_DEF > -1
@@ -166,7 +170,7 @@ vec3 blinnPhongShade() {
     float shininess = getMaterialShininess();
 
 #if _U_LGT_DEF_POS
-    for (int i = 0; i < lgtPos.length(); i++) {
+    for (int i = 0; i < LGT_DEF_POS_COUNT; i++) {
         if ((lgtPos[i].flags & LIGHT_SHOW) > 0) {
 
             if (isModeToonShade()) {
@@ -193,7 +197,7 @@ vec3 blinnPhongShade() {
 #endif
 
 #if _U_LGT_DEF_SPT
-    for (int i = 0; i < lgtSpot.length(); i++) {
+    for (int i = 0; i < LGT_DEF_SPT_COUNT; i++) {
         if ((lgtSpot[i].flags & LIGHT_SHOW) > 0) {
 
             color += blinnPhongSpot(
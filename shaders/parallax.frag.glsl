@@ -26,6 +26,8 @@ layout(set=_DS_UNI_PLX, binding=3) uniform LightInfo {
     vec3 La;        // Amb intensity
     vec3 L;         // D,S intensity
 } Light[_U_LGT_DEF_POS];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=110) const int LGT_DEF_POS_COUNT = _U_LGT_DEF_POS;
 #endif
 
 layout(set=_DS_SMP_PLX, binding=0) uniform sampler2D ColorTex;
@@ -90,7 +92,7 @@ vec3 blinnPhong( ) {
     // vec3 c = vec3(0.0);
 
 #if _U_LGT_DEF_POS
-    for (int i = 0; i < LightDir.length(); i++) {
+    for (int i = 0; i < LGT_DEF_POS_COUNT; i++) {
         if (i > 0) continue;
 
         vec3 s = normalize( LightDir[i] );
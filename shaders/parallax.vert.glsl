@@ -31,6 +31,8 @@ layout(set=_DS_UNI_PLX, binding=3) uniform LightInfo {
     vec3 La;        // Amb intensity
     vec3 L;         // D,S intensity
 } Light[_U_LGT_DEF_POS];
+// Declared at a capacity, the exact length is specialized (Uniform::ARRAY_COUNT_CONSTANT_IDS).
+layout(constant_id=110) const int LGT_DEF_POS_COUNT = _U_LGT_DEF_POS;
 #endif
 
 layout(location=0) out vec2 TexCoord;
@@ -65,7 +67,7 @@ void main() {
     TexCoord = VertexTexCoord;
 
 #if _U_LGT_DEF_POS
-    for (int i = 0; i < Light.length(); i++)
+    for (int i = 0; i < LGT_DEF_POS_COUNT; i++)
         if ((Light[i].flags & LIGHT_SHOW) > 0)
             LightDir[i] = normalize( toObjectLocal * (Light[i].Position - pos) );
 #endif
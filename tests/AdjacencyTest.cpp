@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2021 Colin Hughes <colin.s.hughes@gmail.com>
+ * All Rights Reserved
+ */
+
+/* Compares "helpers::makeTriangleAdjacenyList" with the scan it replaced ("helpers::makeTriangleAdjacenyListScan") on
+ *  the bundled models, some hand made meshes that hit the tie-breaking and degenerate cases, and random meshes.
+ */
+
+#define TINYOBJLOADER_IMPLEMENTATION
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Common/Helpers.h>
+#include <tiny_obj_loader.h>
+
+namespace {
+
+int failures = 0;
+
+void compare(const std::string &name, const std::vector<IndexBufferType> &indices) {
+    std::vector<IndexBufferType> expected, actual;
+    helpers::makeTriangleAdjacenyListScan(indices, expected);
+    helpers::makeTriangleAdjacenyList(indices, actual);
+
+    if (expected.size() != actual.size()) {
+        printf("FAIL %s: size %zu, expected %zu\n", name.c_str(), actual.size(), expected.size());
+        failures++;
+        return;
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (expected[i] != actual[i]) {
+            printf("FAIL %s: index %zu (triangle %zu) is %u, expected %u\n", name.c_str(), i, i / 6, actual[i],
+                   expected[i]);
+            failures++;
+            return;
+        }
+    }
+    printf("ok   %s (%zu triangles)\n", name.c_str(), indices.size() / 3);
+}
+
+void check(const std::string &name, const std::vector<IndexBufferType> &indices, const size_t index,
+           const IndexBufferType value) {
+    std::vector<IndexBufferType> actual;
+    helpers::makeTriangleAdjacenyList(indices, actual);
+    if (actual.at(index) != value) {
+        printf("FAIL %s: index %zu is %u, expected %u\n", name.c_str(), index, actual.at(index), value);
+        failures++;
+    }
+    compare(name, indices);
+}
+
+// Position indices only, all shapes in one list. Shared positions are what make triangles adjacent.
+bool loadModel(const std::string &filename, std::vector<IndexBufferType> &indices) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    auto basedir = filename.substr(0, filename.find_last_of('/') + 1);
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename.c_str(), basedir.c_str())) {
+        printf("FAIL %s: %s\n", filename.c_str(), err.c_str());
+        return false;
+    }
+    for (const auto &shape : shapes)
+        for (const auto &index : shape.mesh.indices) indices.push_back(static_cast<IndexBufferType>(index.vertex_index));
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    // MODELS
+    for (const auto &path : {
+             "torus.obj",
+             "sphere.obj",
+             "icosahedron.obj",
+             "pig_triangulated.obj",
+             "Orange_obj/Orange.obj",
+             "pear_export_obj/pear_export.obj",
+             "Medieval_House_obj/Medieval_House.obj",
+             "grass (low-poly)/grass_low_poly.obj",
+         }) {
+        std::vector<IndexBufferType> indices;
+        if (!loadModel(MODEL_DIR + std::string(path), indices)) {
+            failures++;
+            continue;
+        }
+        compare(path, indices);
+    }
+
+    // TIE-BREAKING
+    // Layout per triangle: { t0, adjacent to t0/t1, t1, adjacent to t1/t2, t2, adjacent to t2/t0 }
+    // The middle triangle's 0/1 edge is as near to the first as the last, so the previous one (2) wins.
+    check("tie", {0, 1, 2, 0, 1, 3, 0, 1, 4}, 6 + 1, 2);
+    // The last triangle is nearer to the third than the first is, so it wins (5).
+    check("nearest", {0, 1, 2, 6, 7, 8, 1, 0, 3, 0, 1, 5}, 12 + 1, 5);
+    // Same edges wound both ways, and duplicate triangles.
+    compare("windings", {0, 1, 2, 2, 1, 0, 0, 1, 2, 1, 2, 3, 3, 2, 1});
+    // Degenerate triangles that use an edge twice, or have a single vertex.
+    compare("degenerate", {0, 0, 1, 0, 1, 2, 1, 1, 1, 1, 0, 0, 2, 1, 0, 2, 2, 0});
+    // No neighbors at all.
+    compare("boundary", {0, 1, 2, 3, 4, 5});
+    compare("empty", {});
+
+    // RANDOM
+    // Few vertices, so lots of edges are shared by more than two triangles, and some triangles are degenerate.
+    std::mt19937 rng(7);
+    for (uint32_t vertexCount : {3u, 4u, 8u, 32u}) {
+        for (uint32_t triangleCount : {1u, 2u, 17u, 300u}) {
+            std::uniform_int_distribution<IndexBufferType> dist(0, vertexCount - 1);
+            std::vector<IndexBufferType> indices(triangleCount * 3);
+            for (auto &index : indices) index = dist(rng);
+            compare("random " + std::to_string(vertexCount) + "/" + std::to_string(triangleCount), indices);
+        }
+    }
+
+    if (failures) printf("%d failed\n", failures);
+    return failures ? 1 : 0;
+}